@@ -17,6 +17,7 @@
 
 #include <polyfem/basis/LagrangeBasis2d.hpp>
 #include <polyfem/basis/LagrangeBasis3d.hpp>
+#include <polyfem/basis/NodeOrdering.hpp>
 
 #include <polyfem/refinement/APriori.hpp>
 
@@ -228,9 +229,21 @@ namespace polyfem
 	{
 		auto indices = iso_parametric() ? mesh_nodes->primitive_to_node() : geom_mesh_nodes->primitive_to_node();
 		indices.resize(mesh->n_vertices());
+		if (iso_parametric() && node_permutation.size() > 0)
+		{
+			for (int &i : indices)
+				i = node_permutation[i];
+		}
 		return indices;
 	}
 
+	RowVectorNd State::node_position(const int node) const
+	{
+		if (inverse_node_permutation_.size() > 0)
+			return mesh_nodes->node_position(inverse_node_permutation_[node]);
+		return mesh_nodes->node_position(node);
+	}
+
 	std::vector<int> State::node_to_primitive() const
 	{
 		auto p2n = primitive_to_node();
@@ -384,6 +397,40 @@ namespace polyfem
 		logger().trace("Done (took {}s)", timer.getElapsedTime());
 	}
 
+	void State::build_node_ordering()
+	{
+		node_permutation.resize(0);
+		inverse_node_permutation_.resize(0);
+
+		const std::string ordering = args["space"]["advanced"]["node_ordering"];
+		if (ordering == "none")
+			return;
+
+		if (args["space"]["basis_type"] == "Spline")
+		{
+			logger().warn("Node reordering disabled, it dosent work for splines!");
+			return;
+		}
+
+		logger().debug("Reordering the nodes ({})...", ordering);
+		igl::Timer timer;
+		timer.start();
+		const int bandwidth = basis::nodes_bandwidth(bases);
+		if (ordering == "rcm")
+			node_permutation = basis::reverse_cuthill_mckee(bases, n_bases);
+		else if (ordering == "morton")
+			node_permutation = basis::morton_ordering(bases, n_bases);
+		else
+			log_and_throw_error("Unknown node ordering {}", ordering);
+
+		basis::permute_nodes(node_permutation, bases);
+		inverse_node_permutation_.resize(node_permutation.size());
+		for (int i = 0; i < node_permutation.size(); ++i)
+			inverse_node_permutation_[node_permutation[i]] = i;
+		timer.stop();
+		logger().debug("Done, bandwidth {} -> {} (took {}s)", bandwidth, basis::nodes_bandwidth(bases), timer.getElapsedTime());
+	}
+
 	std::string State::formulation() const
 	{
 		if (args["materials"].is_null())
@@ -804,6 +851,8 @@ namespace polyfem
 		if (n_geom_bases == 0)
 			n_geom_bases = n_bases;
 
+		build_node_ordering();
+
 		auto &gbases = geom_bases();
 
 		if (optimization_enabled)
@@ -875,6 +924,13 @@ namespace polyfem
 			logger().debug("Building node mapping...");
 			timer2.start();
 			build_node_mapping();
+			// the input nodes follow the new numbering, so does the export with reorder_nodes
+			// without a mapping the node tags are dropped, as without reordering
+			if (node_permutation.size() > 0 && in_node_to_node.size() > 0)
+			{
+				for (int i = 0; i < in_node_to_node.size(); ++i)
+					in_node_to_node[i] = node_permutation[in_node_to_node[i]];
+			}
 			problem->update_nodes(in_node_to_node);
 			mesh->update_nodes(in_node_to_node);
 			timer2.stop();
@@ -1017,18 +1073,29 @@ namespace polyfem
 
 		ass_vals_cache.clear();
 		mass_ass_vals_cache.clear();
+		pressure_ass_vals_cache.clear();
+		// the boundary samples cached by the rhs assembler belong to the previous bases
+		if (solve_data.rhs_assembler)
+			solve_data.rhs_assembler->clear_cache();
 		if (n_bases <= args["solver"]["advanced"]["cache_size"])
 		{
 			timer.start();
 			logger().info("Building cache...");
-			ass_vals_cache.init(mesh->is_volume(), bases, curret_bases);
-			mass_ass_vals_cache.init(mesh->is_volume(), bases, curret_bases, true);
+			const std::string cache_path = args["solver"]["advanced"]["assembly_cache_path"];
+			const auto cache_file = [&](const std::string &name) {
+				return cache_path.empty() ? "" : resolve_output_path(fmt::format("{}_{}.bin", cache_path, name));
+			};
+
+			ass_vals_cache.init_or_load(cache_file("stiffness"), mesh->is_volume(), bases, curret_bases);
+			mass_ass_vals_cache.init_or_load(cache_file("mass"), mesh->is_volume(), bases, curret_bases, true);
 			if (mixed_assembler != nullptr)
-				pressure_ass_vals_cache.init(mesh->is_volume(), pressure_bases, curret_bases);
+				pressure_ass_vals_cache.init_or_load(cache_file("pressure"), mesh->is_volume(), pressure_bases, curret_bases);
 
-			logger().info(" took {}s", timer.getElapsedTime());
+			const size_t cache_memory = ass_vals_cache.memory_usage() + mass_ass_vals_cache.memory_usage() + pressure_ass_vals_cache.memory_usage();
+			logger().info(" took {}s ({} MB)", timer.getElapsedTime(), cache_memory / (1024. * 1024.));
 		}
 
+		out_geom.clear_vis_mesh_cache();
 		out_geom.build_grid(*mesh, args["output"]["advanced"]["sol_on_grid"]);
 
 		if (!problem->is_time_dependent() && boundary_nodes.empty())
@@ -1540,6 +1607,10 @@ namespace polyfem
 
 		if (problem->is_time_dependent())
 		{
+			// HDF5 is not necessarily built thread-safe, so the hdf files are written by the solver thread
+			const bool use_hdf5 = args["output"]["paraview"]["options"]["use_hdf5"];
+			out_geom.init_output_queue(use_hdf5 ? 0 : args["output"]["advanced"]["output_queue_size"].get<int>());
+
 			const double t0 = args["time"]["t0"];
 			const int time_steps = args["time"]["time_steps"];
 			const double dt = args["time"]["dt"];
@@ -1551,16 +1622,25 @@ namespace polyfem
 							  resolve_output_path(args["output"]["paraview"]["file_name"]));
 			}
 
-			if (assembler->name() == "NavierStokes")
-				solve_transient_navier_stokes(time_steps, t0, dt, sol, pressure);
-			else if (assembler->name() == "OperatorSplitting")
-				solve_transient_navier_stokes_split(time_steps, dt, sol, pressure);
-			else if (assembler->is_linear() && !is_contact_enabled()) // Collisions add nonlinearity to the problem
-				solve_transient_linear(time_steps, t0, dt, sol, pressure);
-			else if (!assembler->is_linear() && problem->is_scalar())
-				throw std::runtime_error("Nonlinear scalar problems are not supported yet!");
-			else
-				solve_transient_tensor_nonlinear(time_steps, t0, dt, sol);
+			try
+			{
+				if (assembler->name() == "NavierStokes")
+					solve_transient_navier_stokes(time_steps, t0, dt, sol, pressure);
+				else if (assembler->name() == "OperatorSplitting")
+					solve_transient_navier_stokes_split(time_steps, dt, sol, pressure);
+				else if (assembler->is_linear() && !is_contact_enabled()) // Collisions add nonlinearity to the problem
+					solve_transient_linear(time_steps, t0, dt, sol, pressure);
+				else if (!assembler->is_linear() && problem->is_scalar())
+					throw std::runtime_error("Nonlinear scalar problems are not supported yet!");
+				else
+					solve_transient_tensor_nonlinear(time_steps, t0, dt, sol);
+			}
+			catch (...)
+			{
+				// the frames written so far are kept, later exports are not queued
+				out_geom.close_output_queue();
+				throw;
+			}
 		}
 		else
 		{
@@ -1588,6 +1668,9 @@ namespace polyfem
 			}
 		}
 
+		// wait for the time sequence to be fully written, the exports after the solve are written immediately
+		out_geom.close_output_queue();
+
 		timer.stop();
 		timings.solving_time = timer.getElapsedTime();
 		logger().info(" took {}s", timings.solving_time);
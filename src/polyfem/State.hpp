@@ -369,12 +369,14 @@ namespace polyfem
 		/// @param compute_spectrum If true, compute the spectrum.
 		/// @param[out] sol solution
 		/// @param[out] pressure pressure
+		/// @param is_prefactorized If true, solver already holds the factorization of A (see prefactorize).
 		void solve_linear(
 			const std::unique_ptr<polysolve::LinearSolver> &solver,
 			StiffnessMatrix &A,
 			Eigen::VectorXd &b,
 			const bool compute_spectrum,
-			Eigen::MatrixXd &sol, Eigen::MatrixXd &pressure);
+			Eigen::MatrixXd &sol, Eigen::MatrixXd &pressure,
+			const bool is_prefactorized = false);
 
 	public:
 		/// @brief utility that builds the stiffness matrix and collects stats, used only for linear problems
@@ -411,15 +413,27 @@ namespace polyfem
 
 		/// Inpute nodes (including high-order) to polyfem nodes, only for isoparametric
 		Eigen::VectorXi in_node_to_node;
+		/// new index of every node of the bases after the reordering, empty if the nodes are not reordered
+		Eigen::VectorXi node_permutation;
 		/// maps in vertices/edges/faces/cells to polyfem vertices/edges/faces/cells
 		Eigen::VectorXi in_primitive_to_primitive;
 
 		std::vector<int> primitive_to_node() const;
 		std::vector<int> node_to_primitive() const;
 
+		/// position of a node of the bases, in the numbering of the bases (mesh_nodes keeps the one before the reordering)
+		/// @param[in] node node id
+		/// @return position of the node
+		RowVectorNd node_position(const int node) const;
+
 	private:
 		/// build the mapping from input nodes to polyfem nodes
 		void build_node_mapping();
+		/// renumbers the nodes of the bases with space/advanced/node_ordering
+		void build_node_ordering();
+
+		/// inverse of node_permutation, old index of every node
+		Eigen::VectorXi inverse_node_permutation_;
 
 		//---------------------------------------------------
 		//-----------------Geometry--------------------------
@@ -635,6 +649,8 @@ namespace polyfem
 		// Aux functions for setting up adjoint equations
 		void compute_force_jacobian(const Eigen::MatrixXd &sol, const Eigen::MatrixXd &disp_grad, StiffnessMatrix &hessian);
 		void compute_force_jacobian_prev(const int force_step, const int sol_step, StiffnessMatrix &hessian_prev) const;
+		// Recomputes the force Jacobian and/or the contact set of a time step not kept by diff_cached, the forms are restored afterwards
+		void recompute_transient_adjoint_quantities(const int step, StiffnessMatrix *gradu_h, ipc::CollisionConstraints *contact_set);
 		// Solves the adjoint PDE for derivatives and caches
 		void solve_adjoint_cached(const Eigen::MatrixXd &rhs);
 		Eigen::MatrixXd solve_adjoint(const Eigen::MatrixXd &rhs) const;
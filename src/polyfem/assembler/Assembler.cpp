@@ -21,6 +21,7 @@ namespace polyfem::assembler
 			std::unique_ptr<MatrixCache> cache = nullptr;
 			ElementAssemblyValues vals;
 			QuadratureVector da;
+			Eigen::MatrixXd local;
 
 			LocalThreadMatStorage() = delete;
 
@@ -92,6 +93,122 @@ namespace polyfem::assembler
 				val = 0;
 			}
 		};
+
+		// storage for assemble_all, the vector and the matrix cache are only allocated if needed
+		class LocalThreadAllStorage
+		{
+		public:
+			double val = 0;
+			Eigen::MatrixXd vec;
+			std::unique_ptr<MatrixCache> cache = nullptr;
+			ElementAssemblyValues vals;
+			QuadratureVector da;
+
+			LocalThreadAllStorage() = delete;
+
+			LocalThreadAllStorage(const int vec_size, const int buffer_size, const MatrixCache *c)
+			{
+				if (vec_size > 0)
+					vec.setZero(vec_size, 1);
+
+				if (c != nullptr)
+				{
+					cache = c->clone();
+					cache->reserve(buffer_size);
+					cache->init(*c);
+				}
+			}
+
+			LocalThreadAllStorage(const LocalThreadAllStorage &other)
+				: val(other.val), vec(other.vec), cache(other.cache ? other.cache->clone() : nullptr), vals(other.vals), da(other.da)
+			{
+			}
+
+			LocalThreadAllStorage &operator=(const LocalThreadAllStorage &other)
+			{
+				val = other.val;
+				vec = other.vec;
+				cache = other.cache ? other.cache->clone() : nullptr;
+				vals = other.vals;
+				da = other.da;
+				return *this;
+			}
+		};
+
+		// adds the local gradient of an element to the global vector
+		void scatter_gradient(const ElementAssemblyValues &vals, const int size, const Eigen::VectorXd &val, Eigen::MatrixXd &vec)
+		{
+			const int n_loc_bases = int(vals.basis_values.size());
+			assert(val.size() == n_loc_bases * size);
+
+			for (int j = 0; j < n_loc_bases; ++j)
+			{
+				const auto &global_j = vals.basis_values[j].global;
+
+				for (int m = 0; m < size; ++m)
+				{
+					const double local_value = val(j * size + m);
+					if (std::abs(local_value) < 1e-30)
+					{
+						continue;
+					}
+
+					for (size_t jj = 0; jj < global_j.size(); ++jj)
+					{
+						const auto gj = global_j[jj].index * size + m;
+						const auto wj = global_j[jj].val;
+
+						vec(gj) += local_value * wj;
+					}
+				}
+			}
+		}
+
+		// adds the local hessian of element e to the matrix cache
+		void scatter_hessian(const int e, const ElementAssemblyValues &vals, const int size, const Eigen::MatrixXd &stiffness_val, const int max_triplets_size, MatrixCache &cache)
+		{
+			const int n_loc_bases = int(vals.basis_values.size());
+			assert(stiffness_val.rows() == n_loc_bases * size);
+			assert(stiffness_val.cols() == n_loc_bases * size);
+
+			for (int i = 0; i < n_loc_bases; ++i)
+			{
+				const auto &global_i = vals.basis_values[i].global;
+
+				for (int j = 0; j < n_loc_bases; ++j)
+				{
+					const auto &global_j = vals.basis_values[j].global;
+
+					for (int n = 0; n < size; ++n)
+					{
+						for (int m = 0; m < size; ++m)
+						{
+							const double local_value = stiffness_val(i * size + m, j * size + n);
+
+							for (size_t ii = 0; ii < global_i.size(); ++ii)
+							{
+								const auto gi = global_i[ii].index * size + m;
+								const auto wi = global_i[ii].val;
+
+								for (size_t jj = 0; jj < global_j.size(); ++jj)
+								{
+									const auto gj = global_j[jj].index * size + n;
+									const auto wj = global_j[jj].val;
+
+									cache.add_value(e, gi, gj, local_value * wi * wj);
+
+									if (cache.entries_size() >= max_triplets_size)
+									{
+										cache.prune();
+										logger().debug("cleaning memory...");
+									}
+								}
+							}
+						}
+					}
+				}
+			}
+		}
 	} // namespace
 
 	void Assembler::set_materials(const std::vector<int> &body_ids, const json &body_params, const Units &units)
@@ -199,27 +316,39 @@ namespace polyfem::assembler
 					local_storage.da = vals.det.array() * quadrature.weights.array();
 					const int n_loc_bases = int(vals.basis_values.size());
 
+					Eigen::MatrixXd &local = local_storage.local;
+					if (!assemble_element(vals, local_storage.da, local))
+					{
+						local.resize(n_loc_bases * size(), n_loc_bases * size());
+						for (int i = 0; i < n_loc_bases; ++i)
+						{
+							for (int j = 0; j <= i; ++j)
+							{
+								const auto stiffness_val = assemble(LinearAssemblerData(vals, i, j, local_storage.da));
+								assert(stiffness_val.size() == size() * size());
+
+								for (int n = 0; n < size(); ++n)
+									for (int m = 0; m < size(); ++m)
+										local(i * size() + m, j * size() + n) = stiffness_val(n * size() + m);
+							}
+						}
+					}
+					assert(local.rows() == n_loc_bases * size() && local.cols() == n_loc_bases * size());
+
 					for (int i = 0; i < n_loc_bases; ++i)
 					{
-						// const AssemblyValues &values_i = vals.basis_values[i];
-						// const Eigen::MatrixXd &gradi = values_i.grad_t_m;
 						const auto &global_i = vals.basis_values[i].global;
 
 						for (int j = 0; j <= i; ++j)
 						{
-							// const AssemblyValues &values_j = vals.basis_values[j];
-							// const Eigen::MatrixXd &gradj = values_j.grad_t_m;
 							const auto &global_j = vals.basis_values[j].global;
 
-							const auto stiffness_val = assemble(LinearAssemblerData(vals, i, j, local_storage.da));
-							assert(stiffness_val.size() == size() * size());
-
 							// igl::Timer t1; t1.start();
 							for (int n = 0; n < size(); ++n)
 							{
 								for (int m = 0; m < size(); ++m)
 								{
-									const double local_value = stiffness_val(n * size() + m);
+									const double local_value = local(i * size() + m, j * size() + n);
 									if (std::abs(local_value) < 1e-30)
 									{
 										continue;
@@ -597,39 +726,10 @@ namespace polyfem::assembler
 
 				assert(MAX_QUAD_POINTS == -1 || quadrature.weights.size() < MAX_QUAD_POINTS);
 				local_storage.da = vals.det.array() * quadrature.weights.array();
-				const int n_loc_bases = int(vals.basis_values.size());
 
 				const auto val = assemble_gradient(NonLinearAssemblerData(vals, dt, displacement, displacement_prev, local_storage.da));
-				assert(val.size() == n_loc_bases * size());
-
-				for (int j = 0; j < n_loc_bases; ++j)
-				{
-					const auto &global_j = vals.basis_values[j].global;
-
-					// igl::Timer t1; t1.start();
-					for (int m = 0; m < size(); ++m)
-					{
-						const double local_value = val(j * size() + m);
-						if (std::abs(local_value) < 1e-30)
-						{
-							continue;
-						}
-
-						for (size_t jj = 0; jj < global_j.size(); ++jj)
-						{
-							const auto gj = global_j[jj].index * size() + m;
-							const auto wj = global_j[jj].val;
-
-							local_storage.vec(gj) += local_value * wj;
-						}
-					}
-
-					// t1.stop();
-					// if (!vals.has_parameterization) { std::cout << "-- t1: " << t1.getElapsedTime() << std::endl; }
-				}
 
-				// timer.stop();
-				// if (!vals.has_parameterization) { std::cout << "-- Timer: " << timer.getElapsedTime() << std::endl; }
+				scatter_gradient(vals, size(), val, local_storage.vec);
 			}
 		});
 
@@ -679,75 +779,144 @@ namespace polyfem::assembler
 
 				assert(MAX_QUAD_POINTS == -1 || quadrature.weights.size() < MAX_QUAD_POINTS);
 				local_storage.da = vals.det.array() * quadrature.weights.array();
-				const int n_loc_bases = int(vals.basis_values.size());
 
 				auto stiffness_val = assemble_hessian(NonLinearAssemblerData(vals, dt, displacement, displacement_prev, local_storage.da));
-				assert(stiffness_val.rows() == n_loc_bases * size());
-				assert(stiffness_val.cols() == n_loc_bases * size());
 
 				if (project_to_psd)
 					stiffness_val = ipc::project_to_psd(stiffness_val);
 
-				// bool has_nan = false;
-				// for(int k = 0; k < stiffness_val.size(); ++k)
-				// {
-				// 	if(std::isnan(stiffness_val(k)))
-				// 	{
-				// 		has_nan = true;
-				// 		break;
-				// 	}
-				// }
-
-				// if(has_nan)
-				// {
-				// 	local_storage.entries.emplace_back(0, 0, std::nan(""));
-				// 	break;
-				// }
-
-				for (int i = 0; i < n_loc_bases; ++i)
-				{
-					const auto &global_i = vals.basis_values[i].global;
+				scatter_hessian(e, vals, size(), stiffness_val, max_triplets_size, *local_storage.cache);
+			}
+		});
 
-					for (int j = 0; j < n_loc_bases; ++j)
-					// for(int j = 0; j <= i; ++j)
-					{
-						const auto &global_j = vals.basis_values[j].global;
+		timer.stop();
+		logger().trace("done separate assembly {}s...", timer.getElapsedTime());
 
-						for (int n = 0; n < size(); ++n)
-						{
-							for (int m = 0; m < size(); ++m)
-							{
-								const double local_value = stiffness_val(i * size() + m, j * size() + n);
-								//  if (std::abs(local_value) < 1e-30)
-								//  {
-								// 	 continue;
-								//  }
+		timer.start();
 
-								for (size_t ii = 0; ii < global_i.size(); ++ii)
-								{
-									const auto gi = global_i[ii].index * size() + m;
-									const auto wi = global_i[ii].val;
+		// Serially merge local storages
+		for (LocalThreadMatStorage &local_storage : storage)
+		{
+			local_storage.cache->prune();
+			mat_cache += *local_storage.cache;
+		}
+		hess = mat_cache.get_matrix();
 
-									for (size_t jj = 0; jj < global_j.size(); ++jj)
-									{
-										const auto gj = global_j[jj].index * size() + n;
-										const auto wj = global_j[jj].val;
+		timer.stop();
+		logger().trace("done merge assembly {}s...", timer.getElapsedTime());
+	}
+
+	void Assembler::assemble_all(
+		const bool is_volume,
+		const int n_basis,
+		const bool project_to_psd,
+		const std::vector<ElementBases> &bases,
+		const std::vector<ElementBases> &gbases,
+		const AssemblyValsCache &cache,
+		const double dt,
+		const Eigen::MatrixXd &displacement,
+		const Eigen::MatrixXd &displacement_prev,
+		const bool want_energy,
+		const bool want_grad,
+		const bool want_hess,
+		MatrixCache &mat_cache,
+		double &energy,
+		Eigen::MatrixXd &grad,
+		StiffnessMatrix &hess) const
+	{
+		if (want_energy)
+			energy = assemble_energy(is_volume, bases, gbases, cache, dt, displacement, displacement_prev);
+		if (want_grad)
+			assemble_gradient(is_volume, n_basis, bases, gbases, cache, dt, displacement, displacement_prev, grad);
+		if (want_hess)
+			assemble_hessian(is_volume, n_basis, project_to_psd, bases, gbases, cache, dt, displacement, displacement_prev, mat_cache, hess);
+	}
 
-										local_storage.cache->add_value(e, gi, gj, local_value * wi * wj);
-										// if (j < i) {
-										// 	local_storage.entries.emplace_back(gj, gi, local_value * wj * wi);
-										// }
+	void NLAssembler::assemble_all(
+		const NonLinearAssemblerData &data,
+		const bool want_energy,
+		const bool want_grad,
+		const bool want_hess,
+		double &energy,
+		Eigen::VectorXd &grad,
+		Eigen::MatrixXd &hess) const
+	{
+		if (want_energy)
+			energy = compute_energy(data);
+		if (want_grad)
+			grad = assemble_gradient(data);
+		if (want_hess)
+			hess = assemble_hessian(data);
+	}
 
-										if (local_storage.cache->entries_size() >= max_triplets_size)
-										{
-											local_storage.cache->prune();
-											logger().debug("cleaning memory...");
-										}
-									}
-								}
-							}
-						}
-					}
+	void NLAssembler::assemble_all(
+		const bool is_volume,
+		const int n_basis,
+		const bool project_to_psd,
+		const std::vector<ElementBases> &bases,
+		const std::vector<ElementBases> &gbases,
+		const AssemblyValsCache &cache,
+		const double dt,
+		const Eigen::MatrixXd &displacement,
+		const Eigen::MatrixXd &displacement_prev,
+		const bool want_energy,
+		const bool want_grad,
+		const bool want_hess,
+		MatrixCache &mat_cache,
+		double &energy,
+		Eigen::MatrixXd &grad,
+		StiffnessMatrix &hess) const
+	{
+		const int max_triplets_size = int(1e7);
+		const int buffer_size = std::min(long(max_triplets_size), long(n_basis) * size());
+
+		if (want_hess)
+		{
+			mat_cache.init(n_basis * size());
+			mat_cache.set_zero();
+		}
+
+		auto storage = create_thread_storage(LocalThreadAllStorage(
+			want_grad ? n_basis * size() : 0, buffer_size, want_hess ? &mat_cache : nullptr));
+
+		const int n_bases = int(bases.size());
+		igl::Timer timer;
+		timer.start();
+
+		maybe_parallel_for(n_bases, [&](int start, int end, int thread_id) {
+			LocalThreadAllStorage &local_storage = get_local_thread_storage(storage, thread_id);
+			ElementAssemblyValues &vals = local_storage.vals;
+
+			double local_energy = 0;
+			Eigen::VectorXd local_grad;
+			Eigen::MatrixXd local_hess;
+
+			for (int e = start; e < end; ++e)
+			{
+				// the element values are computed once for all the quantities
+				cache.compute(e, is_volume, bases[e], gbases[e], vals);
+
+				const Quadrature &quadrature = vals.quadrature;
+
+				assert(MAX_QUAD_POINTS == -1 || quadrature.weights.size() < MAX_QUAD_POINTS);
+				local_storage.da = vals.det.array() * quadrature.weights.array();
+
+				assemble_all(
+					NonLinearAssemblerData(vals, dt, displacement, displacement_prev, local_storage.da),
+					want_energy, want_grad, want_hess, local_energy, local_grad, local_hess);
+
+				if (want_energy)
+					local_storage.val += local_energy;
+
+				if (want_grad)
+					scatter_gradient(vals, size(), local_grad, local_storage.vec);
+
+				if (want_hess)
+				{
+					if (project_to_psd)
+						local_hess = ipc::project_to_psd(local_hess);
+
+					scatter_hessian(e, vals, size(), local_hess, max_triplets_size, *local_storage.cache);
 				}
 			}
 		});
@@ -758,12 +927,29 @@ namespace polyfem::assembler
 		timer.start();
 
 		// Serially merge local storages
-		for (LocalThreadMatStorage &local_storage : storage)
+		if (want_energy)
 		{
-			local_storage.cache->prune();
-			mat_cache += *local_storage.cache;
+			energy = 0;
+			for (const LocalThreadAllStorage &local_storage : storage)
+				energy += local_storage.val;
+		}
+
+		if (want_grad)
+		{
+			grad.setZero(n_basis * size(), 1);
+			for (const LocalThreadAllStorage &local_storage : storage)
+				grad += local_storage.vec;
+		}
+
+		if (want_hess)
+		{
+			for (LocalThreadAllStorage &local_storage : storage)
+			{
+				local_storage.cache->prune();
+				mat_cache += *local_storage.cache;
+			}
+			hess = mat_cache.get_matrix();
 		}
-		hess = mat_cache.get_matrix();
 
 		timer.stop();
 		logger().trace("done merge assembly {}s...", timer.getElapsedTime());
@@ -117,6 +117,26 @@ namespace polyfem::assembler
 			utils::MatrixCache &mat_cache,
 			StiffnessMatrix &grad) const { log_and_throw_error("Assemble hessian not implemented by {}!", name()); }
 
+		// assemble energy, gradient, and hessian of energy at the same displacement
+		// only the requested quantities are computed, by default calls the separate assemblers
+		virtual void assemble_all(
+			const bool is_volume,
+			const int n_basis,
+			const bool project_to_psd,
+			const std::vector<basis::ElementBases> &bases,
+			const std::vector<basis::ElementBases> &gbases,
+			const AssemblyValsCache &cache,
+			const double dt,
+			const Eigen::MatrixXd &displacement,
+			const Eigen::MatrixXd &displacement_prev,
+			const bool want_energy,
+			const bool want_grad,
+			const bool want_hess,
+			utils::MatrixCache &mat_cache,
+			double &energy,
+			Eigen::MatrixXd &grad,
+			StiffnessMatrix &hess) const;
+
 		// plotting (eg von mises), assembler is the name of the formulation
 		virtual void compute_scalar_value(
 			const int el_id,
@@ -241,6 +261,11 @@ namespace polyfem::assembler
 		virtual bool is_linear() const override { return true; }
 
 		virtual Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 9, 1> assemble(const LinearAssemblerData &data) const = 0;
+
+		// computes the local matrix of the whole element in one call, the entry of the bases i,j and
+		// components m,n is local(i * size() + m, j * size() + n), only the lower blocks (j <= i) are used
+		// returns false if not implemented, then assemble is called for every pair of bases
+		virtual bool assemble_element(const ElementAssemblyValues &vals, const QuadratureVector &da, Eigen::MatrixXd &local) const { return false; }
 	};
 
 	// non-linear assembler (eg neohookean elasticity)
@@ -295,6 +320,25 @@ namespace polyfem::assembler
 			utils::MatrixCache &mat_cache,
 			StiffnessMatrix &grad) const override;
 
+		// assemble energy, gradient, and hessian of energy in a single loop over the elements
+		void assemble_all(
+			const bool is_volume,
+			const int n_basis,
+			const bool project_to_psd,
+			const std::vector<basis::ElementBases> &bases,
+			const std::vector<basis::ElementBases> &gbases,
+			const AssemblyValsCache &cache,
+			const double dt,
+			const Eigen::MatrixXd &displacement,
+			const Eigen::MatrixXd &displacement_prev,
+			const bool want_energy,
+			const bool want_grad,
+			const bool want_hess,
+			utils::MatrixCache &mat_cache,
+			double &energy,
+			Eigen::MatrixXd &grad,
+			StiffnessMatrix &hess) const override;
+
 		virtual bool is_linear() const override { return false; }
 
 	protected:
@@ -302,6 +346,17 @@ namespace polyfem::assembler
 		virtual double compute_energy(const NonLinearAssemblerData &data) const = 0;
 		virtual Eigen::VectorXd assemble_gradient(const NonLinearAssemblerData &data) const = 0;
 		virtual Eigen::MatrixXd assemble_hessian(const NonLinearAssemblerData &data) const = 0;
+
+		// local energy, gradient, and hessian at once, by default calls the three functions above
+		// override it if the quantities can be computed together (e.g., with autodiff)
+		virtual void assemble_all(
+			const NonLinearAssemblerData &data,
+			const bool want_energy,
+			const bool want_grad,
+			const bool want_hess,
+			double &energy,
+			Eigen::VectorXd &grad,
+			Eigen::MatrixXd &hess) const;
 	};
 
 	class ElasticityAssembler : virtual public Assembler
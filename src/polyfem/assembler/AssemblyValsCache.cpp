@@ -1,6 +1,11 @@
 #include "AssemblyValsCache.hpp"
 
 #include <polyfem/utils/MaybeParallelFor.hpp>
+#include <polyfem/utils/Logger.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
 
 namespace polyfem
 {
@@ -8,30 +13,170 @@ namespace polyfem
 
 	namespace assembler
 	{
+		namespace
+		{
+			constexpr char CACHE_MAGIC[8] = {'P', 'F', 'A', 'V', 'C', 'A', 'C', 'H'};
+			constexpr int CACHE_VERSION = 1;
+
+			template <typename T>
+			inline void hash_combine(size_t &seed, const T &v)
+			{
+				seed ^= std::hash<T>{}(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+			}
+
+			void hash_matrix(size_t &seed, const Eigen::MatrixXd &mat)
+			{
+				hash_combine(seed, mat.rows());
+				hash_combine(seed, mat.cols());
+				for (long i = 0; i < mat.size(); ++i)
+					hash_combine(seed, mat.data()[i]);
+			}
+
+			void hash_bases(size_t &seed, const ElementBases &bs)
+			{
+				hash_combine(seed, bs.has_parameterization);
+				hash_combine(seed, bs.bases.size());
+				for (const Basis &b : bs.bases)
+				{
+					hash_combine(seed, b.global().size());
+					for (const Local2Global &g : b.global())
+					{
+						hash_combine(seed, g.index);
+						hash_combine(seed, g.val);
+						for (long d = 0; d < g.node.size(); ++d)
+							hash_combine(seed, g.node(d));
+					}
+				}
+			}
+		} // namespace
+
+		long AssemblyValsCache::compute_layouts(const bool is_volume, const std::vector<ElementBases> &bases, const std::vector<ElementBases> &gbases)
+		{
+			const int n_elements = bases.size();
+			const int dim = is_volume ? 3 : 2;
+
+			std::vector<ElementLayout> layouts(n_elements);
+			std::vector<size_t> hashes(n_elements, 0);
+
+			utils::maybe_parallel_for(n_elements, [&](int start, int end, int thread_id) {
+				quadrature::Quadrature quadrature;
+				for (int e = start; e < end; ++e)
+				{
+					if (is_mass_)
+						bases[e].compute_mass_quadrature(quadrature);
+					else
+						bases[e].compute_quadrature(quadrature);
+
+					ElementLayout &l = layouts[e];
+					l.n_quadrature = quadrature.size();
+					l.n_bases = bases[e].bases.size();
+					l.dim = dim;
+					l.has_parameterization = gbases[e].has_parameterization;
+
+					size_t &h = hashes[e];
+					hash_matrix(h, quadrature.points);
+					hash_matrix(h, quadrature.weights);
+					hash_bases(h, bases[e]);
+					if (&bases[e] != &gbases[e])
+						hash_bases(h, gbases[e]);
+				}
+			});
+
+			n_elements_ = n_elements;
+			fingerprint_ = 0;
+			hash_combine(fingerprint_, is_volume);
+			hash_combine(fingerprint_, is_mass_);
+			hash_combine(fingerprint_, n_elements);
+			for (const size_t h : hashes)
+				hash_combine(fingerprint_, h);
+
+			uniform_ = std::all_of(layouts.begin(), layouts.end(), [&](const ElementLayout &l) { return l == layouts[0]; });
+
+			long size = 0;
+			data_offsets_.clear();
+			if (uniform_ && n_elements > 0)
+			{
+				layouts_.assign(1, layouts[0]);
+				size = n_elements * layouts[0].data_size();
+			}
+			else
+			{
+				layouts_ = std::move(layouts);
+				data_offsets_.resize(n_elements);
+				for (int e = 0; e < n_elements; ++e)
+				{
+					data_offsets_[e] = size;
+					size += layouts_[e].data_size();
+				}
+			}
+
+			return size;
+		}
+
 		void AssemblyValsCache::init(const bool is_volume, const std::vector<ElementBases> &bases, const std::vector<ElementBases> &gbases, const bool is_mass)
 		{
 			is_mass_ = is_mass;
-			const int n_bases = bases.size();
-			cache.resize(n_bases);
+			const long size = compute_layouts(is_volume, bases, gbases);
+			data_.resize(size);
 
-			utils::maybe_parallel_for(n_bases, [&](int start, int end, int thread_id) {
+			utils::maybe_parallel_for(n_elements_, [&](int start, int end, int thread_id) {
+				ElementAssemblyValues vals;
 				for (int e = start; e < end; ++e)
 				{
 					if (is_mass_)
 					{
-						auto &quadrature = cache[e].quadrature;
+						auto &quadrature = vals.quadrature;
 						bases[e].compute_mass_quadrature(quadrature);
-						cache[e].compute(e, is_volume, quadrature.points, bases[e], gbases[e]);
+						vals.compute(e, is_volume, quadrature.points, bases[e], gbases[e]);
 					}
 					else
-						cache[e].compute(e, is_volume, bases[e], gbases[e]);
+						vals.compute(e, is_volume, bases[e], gbases[e]);
+
+					store(e, vals);
 				}
 			});
+
+			logger().debug("Assembly values cache: {} elements, {} MB{}", n_elements_, memory_usage() / (1024. * 1024.), uniform_ ? ", uniform layout" : "");
+		}
+
+		void AssemblyValsCache::store(const int e, const ElementAssemblyValues &vals)
+		{
+			const ElementLayout &l = layout(e);
+			const int nq = l.n_quadrature;
+			const int dim = l.dim;
+
+			assert(vals.quadrature.points.rows() == nq && vals.quadrature.points.cols() == dim);
+			assert(vals.basis_values.size() == l.n_bases);
+
+			double *d = data_.data() + data_offset(e);
+			const auto write = [&d](const auto &mat) {
+				Eigen::Map<Eigen::MatrixXd>(d, mat.rows(), mat.cols()) = mat;
+				d += mat.size();
+			};
+
+			write(vals.quadrature.points);
+			write(vals.quadrature.weights);
+			write(vals.val);
+			write(vals.det);
+			for (int q = 0; q < nq; ++q)
+			{
+				assert(vals.jac_it[q].rows() == dim && vals.jac_it[q].cols() == dim);
+				write(vals.jac_it[q]);
+			}
+
+			for (const AssemblyValues &v : vals.basis_values)
+			{
+				write(v.val);
+				write(v.grad);
+				write(v.grad_t_m);
+			}
+
+			assert(d == data_.data() + data_offset(e) + l.data_size());
 		}
 
 		void AssemblyValsCache::compute(const int el_index, const bool is_volume, const ElementBases &basis, const ElementBases &gbasis, ElementAssemblyValues &vals) const
 		{
-			if (cache.empty())
+			if (!is_initialized())
 			{
 				if (is_mass_)
 				{
@@ -41,9 +186,144 @@ namespace polyfem
 				}
 				else
 					vals.compute(el_index, is_volume, basis, gbasis);
+				return;
 			}
-			else
-				vals = cache[el_index];
+
+			assert(el_index < n_elements_);
+			const ElementLayout &l = layout(el_index);
+			const int nq = l.n_quadrature;
+			const int dim = l.dim;
+
+			// the assignments from the maps do not allocate if vals already has the right sizes
+			const double *d = data_.data() + data_offset(el_index);
+			const auto read = [&d](auto &mat, const int rows, const int cols) {
+				mat = Eigen::Map<const Eigen::MatrixXd>(d, rows, cols);
+				d += rows * cols;
+			};
+
+			vals.element_id = el_index;
+			vals.has_parameterization = l.has_parameterization;
+
+			read(vals.quadrature.points, nq, dim);
+			read(vals.quadrature.weights, nq, 1);
+			read(vals.val, nq, dim);
+			read(vals.det, nq, 1);
+			vals.jac_it.resize(nq);
+			for (int q = 0; q < nq; ++q)
+				read(vals.jac_it[q], dim, dim);
+
+			assert(basis.bases.size() == l.n_bases);
+			vals.basis_values.resize(l.n_bases);
+			for (int j = 0; j < l.n_bases; ++j)
+			{
+				AssemblyValues &v = vals.basis_values[j];
+				v.global = basis.bases[j].global();
+				read(v.val, nq, 1);
+				read(v.grad, nq, dim);
+				read(v.grad_t_m, nq, dim);
+			}
+		}
+
+		void AssemblyValsCache::clear()
+		{
+			n_elements_ = 0;
+			fingerprint_ = 0;
+			uniform_ = false;
+			layouts_.clear();
+			data_offsets_.clear();
+			data_.clear();
+			data_.shrink_to_fit();
+		}
+
+		size_t AssemblyValsCache::memory_usage() const
+		{
+			return data_.capacity() * sizeof(double)
+				   + layouts_.capacity() * sizeof(ElementLayout)
+				   + data_offsets_.capacity() * sizeof(long);
+		}
+
+		bool AssemblyValsCache::save(const std::string &path) const
+		{
+			std::ofstream out(path, std::ios::out | std::ios::binary);
+			if (!out.good())
+			{
+				logger().error("Failed to write to file: {}", path);
+				out.close();
+
+				return false;
+			}
+
+			const long size = data_.size();
+			out.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+			out.write((const char *)(&CACHE_VERSION), sizeof(CACHE_VERSION));
+			out.write((const char *)(&is_mass_), sizeof(is_mass_));
+			out.write((const char *)(&n_elements_), sizeof(n_elements_));
+			out.write((const char *)(&fingerprint_), sizeof(fingerprint_));
+			out.write((const char *)(&size), sizeof(size));
+			out.write((const char *)data_.data(), size * sizeof(double));
+			out.close();
+
+			return out.good();
+		}
+
+		bool AssemblyValsCache::load(const std::string &path, const bool is_volume, const std::vector<ElementBases> &bases, const std::vector<ElementBases> &gbases, const bool is_mass)
+		{
+			std::ifstream in(path, std::ios::in | std::ios::binary);
+			if (!in.good())
+				return false;
+
+			char magic[sizeof(CACHE_MAGIC)];
+			int version = 0;
+			bool file_is_mass = false;
+			int n_elements = 0;
+			size_t fingerprint = 0;
+			long size = 0;
+			in.read(magic, sizeof(magic));
+			in.read((char *)(&version), sizeof(version));
+			in.read((char *)(&file_is_mass), sizeof(file_is_mass));
+			in.read((char *)(&n_elements), sizeof(n_elements));
+			in.read((char *)(&fingerprint), sizeof(fingerprint));
+			in.read((char *)(&size), sizeof(size));
+
+			if (!in.good() || !std::equal(magic, magic + sizeof(magic), CACHE_MAGIC) || version != CACHE_VERSION)
+			{
+				logger().warn("Invalid assembly values cache {}", path);
+				return false;
+			}
+
+			is_mass_ = is_mass;
+			const long expected_size = compute_layouts(is_volume, bases, gbases);
+			if (file_is_mass != is_mass || n_elements != n_elements_ || fingerprint != fingerprint_ || size != expected_size)
+			{
+				logger().warn("Assembly values cache {} was computed for a different discretization, ignoring it", path);
+				clear();
+				return false;
+			}
+
+			data_.resize(size);
+			in.read((char *)data_.data(), size * sizeof(double));
+			if (!in.good())
+			{
+				logger().warn("Truncated assembly values cache {}", path);
+				clear();
+				return false;
+			}
+
+			return true;
+		}
+
+		void AssemblyValsCache::init_or_load(const std::string &path, const bool is_volume, const std::vector<ElementBases> &bases, const std::vector<ElementBases> &gbases, const bool is_mass)
+		{
+			if (!path.empty() && std::filesystem::exists(path) && load(path, is_volume, bases, gbases, is_mass))
+			{
+				logger().info("Loaded assembly values cache from {} ({} MB)", path, memory_usage() / (1024. * 1024.));
+				return;
+			}
+
+			init(is_volume, bases, gbases, is_mass);
+
+			if (!path.empty() && save(path))
+				logger().info("Saved assembly values cache to {}", path);
 		}
 	} // namespace assembler
 
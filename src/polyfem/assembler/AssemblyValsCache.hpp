@@ -2,26 +2,78 @@
 
 #include <polyfem/assembler/ElementAssemblyValues.hpp>
 
+#include <string>
+
 namespace polyfem
 {
 	namespace assembler
 	{
+		// caches the per element bases evaluations
+		// the values are stored as structure of arrays in a few contiguous arenas,
+		// with a fixed stride per element when all the elements have the same layout
 		class AssemblyValsCache
 		{
 		public:
 			void init(const bool is_volume, const std::vector<basis::ElementBases> &bases, const std::vector<basis::ElementBases> &gbases, const bool is_mass = false);
 			void compute(const int el_index, const bool is_volume, const basis::ElementBases &basis, const basis::ElementBases &gbasis, ElementAssemblyValues &vals) const;
 
-			void clear()
-			{
-				cache.clear();
-			}
+			void clear();
 
 			inline bool is_mass() const { return is_mass_; }
+			inline bool is_initialized() const { return n_elements_ > 0; }
+
+			// memory used by the cached values in bytes
+			size_t memory_usage() const;
+
+			// writes the cache to path, returns false if it fails
+			bool save(const std::string &path) const;
+			// reads the cache from path, returns false if the file is missing or was saved for a different mesh or discretization
+			bool load(const std::string &path, const bool is_volume, const std::vector<basis::ElementBases> &bases, const std::vector<basis::ElementBases> &gbases, const bool is_mass = false);
+
+			// init from path if possible, otherwise init and save to path (if not empty)
+			void init_or_load(const std::string &path, const bool is_volume, const std::vector<basis::ElementBases> &bases, const std::vector<basis::ElementBases> &gbases, const bool is_mass = false);
 
 		private:
-			std::vector<ElementAssemblyValues> cache;
-			bool is_mass_;
+			// sizes of the values of an element
+			struct ElementLayout
+			{
+				int n_quadrature = 0;
+				int n_bases = 0;
+				int dim = 0;
+				bool has_parameterization = true;
+
+				// number of doubles of the element in data_
+				long data_size() const
+				{
+					// quadrature points and weights, mapped points, det, jac_it, basis val, grad, and grad_t_m
+					return n_quadrature * (dim + 1 + dim + 1 + dim * dim + n_bases * (1 + 2 * dim));
+				}
+
+				bool operator==(const ElementLayout &other) const
+				{
+					return n_quadrature == other.n_quadrature && n_bases == other.n_bases && dim == other.dim && has_parameterization == other.has_parameterization;
+				}
+			};
+
+			// computes the layout of every element and the fingerprint of the discretization, returns the size of data_
+			long compute_layouts(const bool is_volume, const std::vector<basis::ElementBases> &bases, const std::vector<basis::ElementBases> &gbases);
+
+			const ElementLayout &layout(const int e) const { return uniform_ ? layouts_[0] : layouts_[e]; }
+			long data_offset(const int e) const { return uniform_ ? e * layouts_[0].data_size() : data_offsets_[e]; }
+
+			// writes the values of an element at its offset in data_
+			void store(const int e, const ElementAssemblyValues &vals);
+
+			bool is_mass_ = false;
+			int n_elements_ = 0;
+			size_t fingerprint_ = 0;
+
+			// true if all the elements share layouts_[0], then data_offsets_ is empty
+			bool uniform_ = false;
+			std::vector<ElementLayout> layouts_;
+			std::vector<long> data_offsets_;
+			// the local to global maps are not stored, they are read from the bases passed to compute
+			std::vector<double> data_;
 		};
 	} // namespace assembler
 } // namespace polyfem
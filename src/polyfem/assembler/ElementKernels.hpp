@@ -0,0 +1,54 @@
+#pragma once
+
+#include <polyfem/assembler/ElementAssemblyValues.hpp>
+
+#include <Eigen/Dense>
+
+#include <type_traits>
+
+// helpers for the element kernels specialized on the dimension and number of bases
+namespace polyfem::assembler
+{
+	template <int N>
+	using IntConstant = std::integral_constant<int, N>;
+
+	// calls f(IntConstant<dim>, IntConstant<n_bases>) with the number of bases fixed at compile time
+	// for P1, P2, Q1, and Q2 elements, and Eigen::Dynamic otherwise
+	template <typename Function>
+	void dispatch_element_kernel(const int dim, const int n_bases, Function &&f)
+	{
+		if (dim == 2)
+		{
+			switch (n_bases)
+			{
+			case 3: f(IntConstant<2>(), IntConstant<3>()); break;
+			case 4: f(IntConstant<2>(), IntConstant<4>()); break;
+			case 6: f(IntConstant<2>(), IntConstant<6>()); break;
+			case 9: f(IntConstant<2>(), IntConstant<9>()); break;
+			default: f(IntConstant<2>(), IntConstant<Eigen::Dynamic>()); break;
+			}
+		}
+		else
+		{
+			assert(dim == 3);
+			switch (n_bases)
+			{
+			case 4: f(IntConstant<3>(), IntConstant<4>()); break;
+			case 8: f(IntConstant<3>(), IntConstant<8>()); break;
+			case 10: f(IntConstant<3>(), IntConstant<10>()); break;
+			case 27: f(IntConstant<3>(), IntConstant<27>()); break;
+			default: f(IntConstant<3>(), IntConstant<Eigen::Dynamic>()); break;
+			}
+		}
+	}
+
+	// gathers the gradients (in physical space) of all the bases at quadrature point q
+	template <int n_bases, int dim>
+	void gather_grads(const ElementAssemblyValues &vals, const int q, Eigen::Matrix<double, n_bases, dim> &grads)
+	{
+		const int n_loc_bases = vals.basis_values.size();
+		grads.resize(n_loc_bases, dim);
+		for (int i = 0; i < n_loc_bases; ++i)
+			grads.row(i) = vals.basis_values[i].grad_t_m.row(q);
+	}
+} // namespace polyfem::assembler
@@ -90,38 +90,60 @@ namespace polyfem::assembler
 	template <typename Derived>
 	Eigen::VectorXd GenericElastic<Derived>::assemble_gradient(const NonLinearAssemblerData &data) const
 	{
-		const int n_bases = data.vals.basis_values.size();
-		return polyfem::gradient_from_energy(
-			size(), n_bases, data,
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar1<double, Eigen::Matrix<double, 6, 1>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar1<double, Eigen::Matrix<double, 8, 1>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar1<double, Eigen::Matrix<double, 12, 1>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar1<double, Eigen::Matrix<double, 18, 1>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar1<double, Eigen::Matrix<double, 24, 1>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar1<double, Eigen::Matrix<double, 30, 1>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar1<double, Eigen::Matrix<double, 60, 1>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar1<double, Eigen::Matrix<double, 81, 1>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar1<double, Eigen::Matrix<double, Eigen::Dynamic, 1, 0, SMALL_N, 1>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar1<double, Eigen::Matrix<double, Eigen::Dynamic, 1, 0, BIG_N, 1>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar1<double, Eigen::VectorXd>>(data); });
+		double energy;
+		Eigen::VectorXd grad;
+		Eigen::MatrixXd hess;
+		assemble_all(data, false, true, false, energy, grad, hess);
+		return grad;
 	}
 
 	template <typename Derived>
 	Eigen::MatrixXd GenericElastic<Derived>::assemble_hessian(const NonLinearAssemblerData &data) const
 	{
-		const int n_bases = data.vals.basis_values.size();
-		return polyfem::hessian_from_energy(
-			size(), n_bases, data,
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::Matrix<double, 6, 1>, Eigen::Matrix<double, 6, 6>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::Matrix<double, 8, 1>, Eigen::Matrix<double, 8, 8>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::Matrix<double, 12, 1>, Eigen::Matrix<double, 12, 12>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::Matrix<double, 18, 1>, Eigen::Matrix<double, 18, 18>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::Matrix<double, 24, 1>, Eigen::Matrix<double, 24, 24>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::Matrix<double, 30, 1>, Eigen::Matrix<double, 30, 30>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::Matrix<double, 60, 1>, Eigen::Matrix<double, 60, 60>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::Matrix<double, 81, 1>, Eigen::Matrix<double, 81, 81>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::Matrix<double, Eigen::Dynamic, 1, 0, SMALL_N, 1>, Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, 0, SMALL_N, SMALL_N>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::VectorXd, Eigen::MatrixXd>>(data); });
+		double energy;
+		Eigen::VectorXd grad;
+		Eigen::MatrixXd hess;
+		assemble_all(data, false, false, true, energy, grad, hess);
+		return hess;
+	}
+
+	template <typename Derived>
+	void GenericElastic<Derived>::assemble_all(
+		const NonLinearAssemblerData &data,
+		const bool want_energy,
+		const bool want_grad,
+		const bool want_hess,
+		double &energy,
+		Eigen::VectorXd &grad,
+		Eigen::MatrixXd &hess) const
+	{
+		if (!want_grad && !want_hess)
+		{
+			if (want_energy)
+				energy = compute_energy_aux<double>(data);
+			return;
+		}
+
+		// the derivatives wrt the local dofs are obtained from the stress and its derivative wrt F
+		if (size() == 2)
+		{
+			polyfem::compute_elastic_quantities_from_stress<2>(
+				data, want_energy, want_grad, want_hess,
+				[&](const int p, const Eigen::Matrix2d &def_grad, double &val, Eigen::Matrix2d &stress, Eigen::Matrix4d *stress_grad) {
+					derived().template elastic_stress<2>(data.vals.val.row(p), data.vals.element_id, def_grad, val, stress, stress_grad);
+				},
+				energy, grad, hess);
+		}
+		else
+		{
+			assert(size() == 3);
+			polyfem::compute_elastic_quantities_from_stress<3>(
+				data, want_energy, want_grad, want_hess,
+				[&](const int p, const Eigen::Matrix3d &def_grad, double &val, Eigen::Matrix3d &stress, Eigen::Matrix<double, 9, 9> *stress_grad) {
+					derived().template elastic_stress<3>(data.vals.val.row(p), data.vals.element_id, def_grad, val, stress, stress_grad);
+				},
+				energy, grad, hess);
+		}
 	}
 
 	template <typename Derived>
@@ -16,6 +16,7 @@ namespace polyfem::assembler
 		using NLAssembler::assemble_energy;
 		using NLAssembler::assemble_gradient;
 		using NLAssembler::assemble_hessian;
+		using NLAssembler::assemble_all;
 
 		GenericElastic();
 		virtual ~GenericElastic() = default;
@@ -24,6 +25,8 @@ namespace polyfem::assembler
 		double compute_energy(const NonLinearAssemblerData &data) const override;
 		Eigen::MatrixXd assemble_hessian(const NonLinearAssemblerData &data) const override;
 		Eigen::VectorXd assemble_gradient(const NonLinearAssemblerData &data) const override;
+		// energy, gradient, and hessian from the stress at the quadrature points (see elastic_stress)
+		void assemble_all(const NonLinearAssemblerData &data, const bool want_energy, const bool want_grad, const bool want_hess, double &energy, Eigen::VectorXd &grad, Eigen::MatrixXd &hess) const override;
 
 		void assign_stress_tensor(const int el_id, const basis::ElementBases &bs, const basis::ElementBases &gbs, const Eigen::MatrixXd &local_pts, const Eigen::MatrixXd &displacement, const int all_size, const ElasticityTensorType &type, Eigen::MatrixXd &all, const std::function<Eigen::MatrixXd(const Eigen::MatrixXd &)> &fun) const override;
 
@@ -38,8 +41,50 @@ namespace polyfem::assembler
 		// sets material params
 		virtual void add_multimaterial(const int index, const json &params, const Units &units) override = 0;
 
+		// energy density, first Piola-Kirchhoff stress ∂W/∂F, and if stress_grad is not null its derivative ∂²W/∂F² at a point
+		// F is flattened column-wise in stress_grad. By default they are computed with autodiff on the entries of F,
+		// a material can provide a closed form by defining the same function (see MooneyRivlinElasticity)
+		template <int dim>
+		void elastic_stress(
+			const RowVectorNd &p,
+			const int el_id,
+			const Eigen::Matrix<double, dim, dim> &def_grad,
+			double &energy,
+			Eigen::Matrix<double, dim, dim> &stress,
+			Eigen::Matrix<double, dim * dim, dim * dim> *stress_grad) const
+		{
+			typedef DScalar1<double, Eigen::Matrix<double, dim * dim, 1>> Diff1;
+			typedef DScalar2<double, Eigen::Matrix<double, dim * dim, 1>, Eigen::Matrix<double, dim * dim, dim * dim>> Diff2;
+
+			DiffScalarBase::setVariableCount(dim * dim);
+
+			const auto eval = [&](auto &&diff_energy) {
+				typedef typename std::decay_t<decltype(diff_energy)> Diff;
+				DefGradMatrix<Diff> def_grad_ad(dim, dim);
+				for (int i = 0; i < dim; ++i)
+					for (int j = 0; j < dim; ++j)
+						def_grad_ad(i, j) = Diff(i + j * dim, def_grad(i, j));
+
+				diff_energy = derived().elastic_energy(p, el_id, def_grad_ad);
+				energy = diff_energy.getValue();
+				stress = Eigen::Map<const Eigen::Matrix<double, dim, dim>>(diff_energy.getGradient().data());
+			};
+
+			if (stress_grad)
+			{
+				Diff2 diff_energy;
+				eval(diff_energy);
+				*stress_grad = diff_energy.getHessian();
+			}
+			else
+			{
+				Diff1 diff_energy;
+				eval(diff_energy);
+			}
+		}
+
 	private:
-		// utility function that computes energy, the template is used for double, DScalar1, and DScalar2 in energy, gradient and hessian
+		// utility function that computes energy, the template is used for double in energy
 		template <typename T>
 		T compute_energy_aux(const NonLinearAssemblerData &data) const
 		{
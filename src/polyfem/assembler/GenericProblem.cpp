@@ -70,6 +70,22 @@ namespace polyfem
 			return val;
 		}
 
+		void TensorBCValue::eval(const Eigen::MatrixXd &pts, const int dim, const double t, Eigen::VectorXd &val) const
+		{
+			value[dim].evaluate(pts, t, val);
+
+			if (interpolation.empty())
+			{
+			}
+			else if (interpolation.size() == 1)
+				val *= interpolation[0]->eval(t);
+			else
+			{
+				assert(dim < interpolation.size());
+				val *= interpolation[dim]->eval(t);
+			}
+		}
+
 		double ScalarBCValue::eval(const RowVectorNd &pts, const double t) const
 		{
 			assert(pts.size() == 2 || pts.size() == 3);
@@ -138,14 +154,11 @@ namespace polyfem
 				return;
 			}
 
-			const bool planar = pts.cols() == 2;
-			for (int i = 0; i < pts.rows(); ++i)
+			Eigen::VectorXd tmp;
+			for (int j = 0; j < pts.cols(); ++j)
 			{
-				for (int j = 0; j < pts.cols(); ++j)
-				{
-					double x = pts(i, 0), y = pts(i, 1), z = planar ? 0 : pts(i, 2);
-					val(i, j) = rhs_[j](x, y, z, t);
-				}
+				rhs_[j].evaluate(pts, t, tmp);
+				val.col(j) = tmp;
 			}
 		}
 
@@ -177,30 +190,31 @@ namespace polyfem
 		{
 			val = Eigen::MatrixXd::Zero(pts.rows(), mesh.dimension());
 
-			for (long i = 0; i < pts.rows(); ++i)
+			if (is_all_)
 			{
-				if (is_all_)
+				assert(displacements_.size() == 1);
+				Eigen::VectorXd tmp;
+				for (int d = 0; d < val.cols(); ++d)
 				{
-					assert(displacements_.size() == 1);
-					for (int d = 0; d < val.cols(); ++d)
-					{
-						val(i, d) = displacements_[0].eval(pts.row(i), d, t);
-					}
+					displacements_[0].eval(pts, d, t, tmp);
+					val.col(d) = tmp;
 				}
-				else
+				return;
+			}
+
+			for (long i = 0; i < pts.rows(); ++i)
+			{
+				const int id = mesh.get_boundary_id(global_ids(i));
+				for (size_t b = 0; b < boundary_ids_.size(); ++b)
 				{
-					const int id = mesh.get_boundary_id(global_ids(i));
-					for (size_t b = 0; b < boundary_ids_.size(); ++b)
+					if (id == boundary_ids_[b])
 					{
-						if (id == boundary_ids_[b])
+						for (int d = 0; d < val.cols(); ++d)
 						{
-							for (int d = 0; d < val.cols(); ++d)
-							{
-								val(i, d) = displacements_[b].eval(pts.row(i), d, t);
-							}
-
-							break;
+							val(i, d) = displacements_[b].eval(pts.row(i), d, t);
 						}
+
+						break;
 					}
 				}
 			}
@@ -244,16 +258,13 @@ namespace polyfem
 		void GenericTensorProblem::exact(const Eigen::MatrixXd &pts, const double t, Eigen::MatrixXd &val) const
 		{
 			assert(has_exact_sol());
-			const bool planar = pts.cols() == 2;
 			val.resize(pts.rows(), pts.cols());
 
-			for (int i = 0; i < pts.rows(); ++i)
+			Eigen::VectorXd tmp;
+			for (int j = 0; j < pts.cols(); ++j)
 			{
-				for (int j = 0; j < pts.cols(); ++j)
-				{
-					double x = pts(i, 0), y = pts(i, 1), z = planar ? 0 : pts(i, 2);
-					val(i, j) = exact_[j](x, y, z, t);
-				}
+				exact_[j].evaluate(pts, t, tmp);
+				val.col(j) = tmp;
 			}
 		}
 
@@ -264,14 +275,11 @@ namespace polyfem
 			if (!has_exact_grad_)
 				return;
 
-			const bool planar = size == 2;
-			for (int i = 0; i < pts.rows(); ++i)
+			Eigen::VectorXd tmp;
+			for (int j = 0; j < pts.cols() * size; ++j)
 			{
-				for (int j = 0; j < pts.cols() * size; ++j)
-				{
-					double x = pts(i, 0), y = pts(i, 1), z = planar ? 0 : pts(i, 2);
-					val(i, j) = exact_grad_[j](x, y, z, t);
-				}
+				exact_grad_[j].evaluate(pts, t, tmp);
+				val.col(j) = tmp;
 			}
 		}
 
@@ -1129,12 +1137,9 @@ namespace polyfem
 				val.setZero();
 				return;
 			}
-			const bool planar = pts.cols() == 2;
-			for (int i = 0; i < pts.rows(); ++i)
-			{
-				double x = pts(i, 0), y = pts(i, 1), z = planar ? 0 : pts(i, 2);
-				val(i) = rhs_(x, y, z, t);
-			}
+			Eigen::VectorXd tmp;
+			rhs_.evaluate(pts, t, tmp);
+			val.col(0) = tmp;
 		}
 
 		void GenericScalarProblem::dirichlet_bc(const mesh::Mesh &mesh, const Eigen::MatrixXi &global_ids, const Eigen::MatrixXd &uv, const Eigen::MatrixXd &pts, const double t, Eigen::MatrixXd &val) const
@@ -1218,14 +1223,11 @@ namespace polyfem
 		void GenericScalarProblem::exact(const Eigen::MatrixXd &pts, const double t, Eigen::MatrixXd &val) const
 		{
 			assert(has_exact_sol());
-			const bool planar = pts.cols() == 2;
 			val.resize(pts.rows(), 1);
 
-			for (int i = 0; i < pts.rows(); ++i)
-			{
-				double x = pts(i, 0), y = pts(i, 1), z = pts.cols() == 2 ? 0 : pts(i, 2);
-				val(i) = exact_(x, y, z, t);
-			}
+			Eigen::VectorXd tmp;
+			exact_.evaluate(pts, t, tmp);
+			val.col(0) = tmp;
 		}
 
 		void GenericScalarProblem::exact_grad(const Eigen::MatrixXd &pts, const double t, Eigen::MatrixXd &val) const
@@ -1234,14 +1236,11 @@ namespace polyfem
 			if (!has_exact_grad_)
 				return;
 
-			const bool planar = pts.cols() == 2;
-			for (int i = 0; i < pts.rows(); ++i)
+			Eigen::VectorXd tmp;
+			for (int j = 0; j < pts.cols(); ++j)
 			{
-				for (int j = 0; j < pts.cols(); ++j)
-				{
-					double x = pts(i, 0), y = pts(i, 1), z = pts.cols() == 2 ? 0 : pts(i, 2);
-					val(i, j) = exact_grad_[j](x, y, z, t);
-				}
+				exact_grad_[j].evaluate(pts, t, tmp);
+				val.col(j) = tmp;
 			}
 		}
 		void GenericScalarProblem::dirichlet_nodal_value(const mesh::Mesh &mesh, const int node_id, const RowVectorNd &pt, const double t, Eigen::MatrixXd &val) const
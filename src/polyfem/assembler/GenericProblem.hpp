@@ -21,6 +21,7 @@ namespace polyfem
 			}
 
 			double eval(const RowVectorNd &pts, const int dim, const double t, const int el_id = -1) const;
+			void eval(const Eigen::MatrixXd &pts, const int dim, const double t, Eigen::VectorXd &val) const;
 
 		};
 
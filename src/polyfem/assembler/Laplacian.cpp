@@ -1,5 +1,7 @@
 #include "Laplacian.hpp"
 
+#include <polyfem/assembler/ElementKernels.hpp>
+
 namespace polyfem::assembler
 {
 	namespace {
@@ -7,6 +9,24 @@ namespace polyfem::assembler
 		{
 			return (i == j) ? true : false;
 		}
+
+		// sum_q da_q grad_q grad_q^T, with grad_q the n_bases x dim gradients at q
+		template <int n_bases, int dim>
+		void laplacian_element(const ElementAssemblyValues &vals, const QuadratureVector &da, Eigen::MatrixXd &local)
+		{
+			const int n_loc_bases = vals.basis_values.size();
+			Eigen::Matrix<double, n_bases, n_bases> res(n_loc_bases, n_loc_bases);
+			res.setZero();
+
+			Eigen::Matrix<double, n_bases, dim> grads;
+			for (long q = 0; q < da.size(); ++q)
+			{
+				gather_grads(vals, q, grads);
+				res.noalias() += da(q) * grads * grads.transpose();
+			}
+
+			local = res;
+		}
 	}
 	
 	Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 9, 1> Laplacian::assemble(const LinearAssemblerData &data) const
@@ -22,6 +42,18 @@ namespace polyfem::assembler
 		return Eigen::Matrix<double, 1, 1>::Constant(res);
 	}
 
+	bool Laplacian::assemble_element(const ElementAssemblyValues &vals, const QuadratureVector &da, Eigen::MatrixXd &local) const
+	{
+		if (size() != 1 || vals.basis_values.empty())
+			return false;
+
+		dispatch_element_kernel(vals.basis_values[0].grad_t_m.cols(), vals.basis_values.size(), [&](auto dim, auto n_bases) {
+			laplacian_element<decltype(n_bases)::value, decltype(dim)::value>(vals, da, local);
+		});
+
+		return true;
+	}
+
 	Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 3, 1> Laplacian::compute_rhs(const AutodiffHessianPt &pt) const
 	{
 		Eigen::Matrix<double, 1, 1> result;
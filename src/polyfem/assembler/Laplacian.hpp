@@ -18,6 +18,8 @@ namespace polyfem
 
 			// computes local stiffness matrix (1x1) for bases i,j
 			Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 9, 1> assemble(const LinearAssemblerData &data) const override;
+			// computes the local stiffness matrix of the whole element
+			bool assemble_element(const ElementAssemblyValues &vals, const QuadratureVector &da, Eigen::MatrixXd &local) const override;
 
 			// uses autodiff to compute the rhs for a fabricated solution
 			// in this case it just return pt.getHessian().trace()
@@ -1,5 +1,6 @@
 #include "LinearElasticity.hpp"
 
+#include <polyfem/assembler/ElementKernels.hpp>
 #include <polyfem/autogen/auto_elasticity_rhs.hpp>
 
 #include <polyfem/utils/MatrixUtils.hpp>
@@ -62,6 +63,54 @@ namespace polyfem
 			return res;
 		}
 
+		bool LinearElasticity::assemble_element(const ElementAssemblyValues &vals, const QuadratureVector &da, Eigen::MatrixXd &local) const
+		{
+			dispatch_element_kernel(size(), vals.basis_values.size(), [&](auto dim, auto n_bases) {
+				assemble_element_aux<decltype(n_bases)::value, decltype(dim)::value>(vals, da, local);
+			});
+
+			return true;
+		}
+
+		template <int n_bases, int dim>
+		void LinearElasticity::assemble_element_aux(const ElementAssemblyValues &vals, const QuadratureVector &da, Eigen::MatrixXd &local) const
+		{
+			assert(size() == dim);
+			constexpr int N = (n_bases == Eigen::Dynamic) ? Eigen::Dynamic : n_bases * dim;
+			const int n_loc_bases = vals.basis_values.size();
+
+			Eigen::Matrix<double, N, N> res(n_loc_bases * dim, n_loc_bases * dim);
+			res.setZero();
+
+			Eigen::Matrix<double, n_bases, dim> grads;
+			Eigen::Matrix<double, n_bases, n_bases> dots(n_loc_bases, n_loc_bases);
+			for (long q = 0; q < da.size(); ++q)
+			{
+				gather_grads(vals, q, grads);
+				dots.noalias() = grads * grads.transpose();
+
+				double lambda, mu;
+				params_.lambda_mu(vals.quadrature.points.row(q), vals.val.row(q), vals.element_id, lambda, mu);
+				const double mu_da = mu * da(q);
+				const double lambda_da = lambda * da(q);
+
+				// mu (gradi' gradj Id + gradj gradi') + lambda gradi gradj', only the lower blocks are used
+				for (int i = 0; i < n_loc_bases; ++i)
+				{
+					for (int j = 0; j <= i; ++j)
+					{
+						auto block = res.template block<dim, dim>(i * dim, j * dim);
+						block.noalias() += mu_da * grads.row(j).transpose() * grads.row(i);
+						block.noalias() += lambda_da * grads.row(i).transpose() * grads.row(j);
+						block.diagonal().array() += mu_da * dots(i, j);
+					}
+				}
+			}
+
+			// the element matrix is symmetric
+			local = res.template selfadjointView<Eigen::Lower>();
+		}
+
 		double LinearElasticity::compute_energy(const NonLinearAssemblerData &data) const
 		{
 			return compute_energy_aux<double>(data);
@@ -87,19 +136,10 @@ namespace polyfem
 
 		Eigen::MatrixXd LinearElasticity::assemble_hessian(const NonLinearAssemblerData &data) const
 		{
-			const int n_bases = data.vals.basis_values.size();
-			return polyfem::hessian_from_energy(
-				size(), n_bases, data,
-				[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::Matrix<double, 6, 1>, Eigen::Matrix<double, 6, 6>>>(data); },
-				[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::Matrix<double, 8, 1>, Eigen::Matrix<double, 8, 8>>>(data); },
-				[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::Matrix<double, 12, 1>, Eigen::Matrix<double, 12, 12>>>(data); },
-				[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::Matrix<double, 18, 1>, Eigen::Matrix<double, 18, 18>>>(data); },
-				[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::Matrix<double, 24, 1>, Eigen::Matrix<double, 24, 24>>>(data); },
-				[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::Matrix<double, 30, 1>, Eigen::Matrix<double, 30, 30>>>(data); },
-				[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::Matrix<double, 60, 1>, Eigen::Matrix<double, 60, 60>>>(data); },
-				[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::Matrix<double, 81, 1>, Eigen::Matrix<double, 81, 81>>>(data); },
-				[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::Matrix<double, Eigen::Dynamic, 1, 0, SMALL_N, 1>, Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, 0, SMALL_N, SMALL_N>>>(data); },
-				[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::VectorXd, Eigen::MatrixXd>>(data); });
+			// the energy is quadratic, its hessian is the stiffness matrix
+			Eigen::MatrixXd hessian;
+			assemble_element(data.vals, data.da, hessian);
+			return hessian;
 		}
 
 		// Compute \int mu eps : eps + lambda/2 tr(eps)^2 = \int mu tr(eps^2) + lambda/2 tr(eps)^2
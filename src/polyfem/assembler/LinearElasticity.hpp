@@ -21,6 +21,8 @@ namespace polyfem::assembler
 		// da contains both the quadrature weight and the change of metric in the integral
 		Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 9, 1>
 		assemble(const LinearAssemblerData &data) const override;
+		// computes the local stiffness matrix of the whole element
+		bool assemble_element(const ElementAssemblyValues &vals, const QuadratureVector &da, Eigen::MatrixXd &local) const override;
 
 		// compute elastic energy
 		double compute_energy(const NonLinearAssemblerData &data) const override;
@@ -72,5 +74,9 @@ namespace polyfem::assembler
 		// assemble_gradient is the same with T=DScalar1 and return .getGradient()
 		template <typename T>
 		T compute_energy_aux(const NonLinearAssemblerData &data) const;
+
+		// local stiffness matrix with the number of bases and dimension fixed at compile time
+		template <int n_bases, int dim>
+		void assemble_element_aux(const ElementAssemblyValues &vals, const QuadratureVector &da, Eigen::MatrixXd &local) const;
 	};
 } // namespace polyfem::assembler
@@ -46,6 +46,74 @@ namespace polyfem::assembler
 			return val;
 		}
 
+		// closed form of elastic_energy and its derivatives, see GenericElastic::elastic_stress
+		template <int dim>
+		void elastic_stress(
+			const RowVectorNd &p,
+			const int el_id,
+			const Eigen::Matrix<double, dim, dim> &def_grad,
+			double &energy,
+			Eigen::Matrix<double, dim, dim> &stress,
+			Eigen::Matrix<double, dim * dim, dim * dim> *stress_grad) const
+		{
+			typedef Eigen::Matrix<double, dim, dim> DimMat;
+
+			const double t = 0; // TODO
+
+			const double c1 = c1_(p, t, el_id);
+			const double c2 = c2_(p, t, el_id);
+			const double k = k_(p, t, el_id);
+
+			const DimMat &F = def_grad;
+			const double J = F.determinant();
+			const double log_J = std::log(J);
+			const DimMat FmT = F.inverse().transpose();
+			const DimMat C = F.transpose() * F;
+			const DimMat FC = F * C;
+
+			const double I1 = C.trace();
+			const double I2 = 0.5 * (I1 * I1 - (C * C).trace());
+			const double a1 = std::pow(J, -2.0 / dim);
+			const double a2 = a1 * a1;
+
+			energy = c1 * (a1 * I1 - dim) + c2 * (a2 * I2 - dim) + k / 2 * (log_J * log_J);
+
+			// derivatives of J^(-2/d) I1 and J^(-4/d) I2, divided by J^(-2/d) and J^(-4/d)
+			const DimMat X1 = 2 * F - (2.0 / dim) * I1 * FmT;
+			const DimMat X2 = 2 * I1 * F - 2 * FC - (4.0 / dim) * I2 * FmT;
+			stress = c1 * a1 * X1 + c2 * a2 * X2 + k * log_J * FmT;
+
+			if (!stress_grad)
+				return;
+
+			const DimMat B = F * F.transpose();
+			for (int i = 0; i < dim; ++i)
+			{
+				for (int j = 0; j < dim; ++j)
+				{
+					// derivative wrt F_lm, k is the bulk modulus
+					for (int l = 0; l < dim; ++l)
+					{
+						for (int m = 0; m < dim; ++m)
+						{
+							const double delta = (i == l && j == m) ? 1 : 0;
+							const double dFmT = -FmT(i, m) * FmT(l, j);
+							const double dI2 = 2 * I1 * F(l, m) - 2 * FC(l, m);
+							const double dFC = (i == l ? C(m, j) : 0) + F(i, m) * F(l, j) + (j == m ? B(i, l) : 0);
+
+							const double dX1 = 2 * delta - (2.0 / dim) * (2 * F(l, m) * FmT(i, j) + I1 * dFmT);
+							const double dX2 = 4 * F(l, m) * F(i, j) + 2 * I1 * delta - 2 * dFC - (4.0 / dim) * (dI2 * FmT(i, j) + I2 * dFmT);
+
+							(*stress_grad)(i + j * dim, l + m * dim) =
+								c1 * a1 * (dX1 - (2.0 / dim) * FmT(l, m) * X1(i, j))
+								+ c2 * a2 * (dX2 - (4.0 / dim) * FmT(l, m) * X2(i, j))
+								+ k * (FmT(l, m) * FmT(i, j) + log_J * dFmT);
+						}
+					}
+				}
+			}
+		}
+
 	private:
 		GenericMatParam c1_;
 		GenericMatParam c2_;
@@ -58,12 +58,24 @@ namespace polyfem::assembler
 				compute_energy_aux_gradient_fast<3, 2>(data, gradient);
 				break;
 			}
+			case 4:
+			{
+				gradient.resize(8);
+				compute_energy_aux_gradient_fast<4, 2>(data, gradient);
+				break;
+			}
 			case 6:
 			{
 				gradient.resize(12);
 				compute_energy_aux_gradient_fast<6, 2>(data, gradient);
 				break;
 			}
+			case 9:
+			{
+				gradient.resize(18);
+				compute_energy_aux_gradient_fast<9, 2>(data, gradient);
+				break;
+			}
 			case 10:
 			{
 				gradient.resize(20);
@@ -89,6 +101,12 @@ namespace polyfem::assembler
 				compute_energy_aux_gradient_fast<4, 3>(data, gradient);
 				break;
 			}
+			case 8:
+			{
+				gradient.resize(24);
+				compute_energy_aux_gradient_fast<8, 3>(data, gradient);
+				break;
+			}
 			case 10:
 			{
 				gradient.resize(30);
@@ -101,6 +119,12 @@ namespace polyfem::assembler
 				compute_energy_aux_gradient_fast<20, 3>(data, gradient);
 				break;
 			}
+			case 27:
+			{
+				gradient.resize(81);
+				compute_energy_aux_gradient_fast<27, 3>(data, gradient);
+				break;
+			}
 			default:
 			{
 				gradient.resize(data.vals.basis_values.size() * 3);
@@ -182,6 +206,13 @@ namespace polyfem::assembler
 				compute_energy_hessian_aux_fast<3, 2>(data, hessian);
 				break;
 			}
+			case 4:
+			{
+				hessian.resize(8, 8);
+				hessian.setZero();
+				compute_energy_hessian_aux_fast<4, 2>(data, hessian);
+				break;
+			}
 			case 6:
 			{
 				hessian.resize(12, 12);
@@ -189,6 +220,13 @@ namespace polyfem::assembler
 				compute_energy_hessian_aux_fast<6, 2>(data, hessian);
 				break;
 			}
+			case 9:
+			{
+				hessian.resize(18, 18);
+				hessian.setZero();
+				compute_energy_hessian_aux_fast<9, 2>(data, hessian);
+				break;
+			}
 			case 10:
 			{
 				hessian.resize(20, 20);
@@ -217,6 +255,13 @@ namespace polyfem::assembler
 				compute_energy_hessian_aux_fast<4, 3>(data, hessian);
 				break;
 			}
+			case 8:
+			{
+				hessian.resize(24, 24);
+				hessian.setZero();
+				compute_energy_hessian_aux_fast<8, 3>(data, hessian);
+				break;
+			}
 			case 10:
 			{
 				hessian.resize(30, 30);
@@ -231,6 +276,13 @@ namespace polyfem::assembler
 				compute_energy_hessian_aux_fast<20, 3>(data, hessian);
 				break;
 			}
+			case 27:
+			{
+				hessian.resize(81, 81);
+				hessian.setZero();
+				compute_energy_hessian_aux_fast<27, 3>(data, hessian);
+				break;
+			}
 			default:
 			{
 				hessian.resize(data.vals.basis_values.size() * 3, data.vals.basis_values.size() * 3);
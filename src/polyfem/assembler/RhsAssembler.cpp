@@ -29,6 +29,30 @@ namespace polyfem
 					val = 0;
 				}
 			};
+
+			// hash of the content of the boundary used as the key of the lsq_bc cache
+			size_t hash_boundary(const std::vector<LocalBoundary> &local_boundary, const std::vector<int> &bounday_nodes)
+			{
+				size_t hash = 0;
+				const auto combine = [&hash](const size_t v) { hash ^= std::hash<size_t>()(v) + 0x9e3779b97f4a7c15 + (hash << 6) + (hash >> 2); };
+
+				for (const LocalBoundary &lb : local_boundary)
+				{
+					combine(lb.element_id());
+					combine(size_t(lb.type()));
+					combine(lb.size());
+					for (int i = 0; i < lb.size(); ++i)
+					{
+						combine(lb.local_primitive_id(i));
+						combine(lb.global_primitive_id(i));
+					}
+				}
+
+				for (const int n : bounday_nodes)
+					combine(n);
+
+				return hash;
+			}
 		} // namespace
 
 		RhsAssembler::RhsAssembler(const Assembler &assembler, const Mesh &mesh, const Obstacle &obstacle,
@@ -204,35 +228,61 @@ namespace polyfem
 
 				if (fabs(mmin) > 1e-8 || fabs(mmax) > 1e-8)
 				{
-					assembler::Mass mass_mat_assembler;
-					mass_mat_assembler.set_size(assembler_.size());
-					mass_mat_assembler.add_multimaterial(0, json({}), Units());
-					StiffnessMatrix mass;
-					const int n_fe_basis = n_basis_ - obstacle_.n_vertices();
-					mass_mat_assembler.assemble(size_ == 3, n_fe_basis, bases_, gbases_, ass_vals_cache_, mass, true);
-					assert(mass.rows() == n_basis_ * size_ - obstacle_.ndof() && mass.cols() == n_basis_ * size_ - obstacle_.ndof());
-
-					auto solver = LinearSolver::create(solver_, preconditioner_);
-					solver->setParameters(solver_params_);
-					solver->analyzePattern(mass, mass.rows());
-					solver->factorize(mass);
+					// the unit-density mass matrix only depends on the bases, factorize it once
+					if (!time_bc_solver_)
+					{
+						assembler::Mass mass_mat_assembler;
+						mass_mat_assembler.set_size(assembler_.size());
+						mass_mat_assembler.add_multimaterial(0, json({}), Units());
+						const int n_fe_basis = n_basis_ - obstacle_.n_vertices();
+						mass_mat_assembler.assemble(size_ == 3, n_fe_basis, bases_, gbases_, ass_vals_cache_, time_bc_mass_, true);
+						assert(time_bc_mass_.rows() == n_basis_ * size_ - obstacle_.ndof() && time_bc_mass_.cols() == n_basis_ * size_ - obstacle_.ndof());
+
+						time_bc_solver_ = LinearSolver::create(solver_, preconditioner_);
+						time_bc_solver_->setParameters(solver_params_);
+						time_bc_solver_->analyzePattern(time_bc_mass_, time_bc_mass_.rows());
+						time_bc_solver_->factorize(time_bc_mass_);
+					}
 
+					const StiffnessMatrix &mass = time_bc_mass_;
 					for (long i = 0; i < b.cols(); ++i)
 					{
-						solver->solve(b.block(0, i, mass.rows(), 1), sol.block(0, i, mass.rows(), 1));
+						time_bc_solver_->solve(b.block(0, i, mass.rows(), 1), sol.block(0, i, mass.rows(), 1));
 					}
 					logger().trace("mass matrix error {}", (mass * sol - b).norm());
 				}
 			}
 		}
 
-		void RhsAssembler::lsq_bc(const std::function<void(const Eigen::MatrixXi &, const Eigen::MatrixXd &, const Eigen::MatrixXd &, Eigen::MatrixXd &)> &df,
-								  const std::vector<LocalBoundary> &local_boundary, const std::vector<int> &bounday_nodes, const int resolution, Eigen::MatrixXd &rhs) const
+		void RhsAssembler::LSQBCCache::set_key(const std::vector<LocalBoundary> &local_boundary, const std::vector<int> &bounday_nodes, const int resolution)
 		{
-			const int n_el = int(bases_.size());
+			n_local_boundary_ = local_boundary.size();
+			n_boundary_nodes_ = bounday_nodes.size();
+			boundary_hash_ = hash_boundary(local_boundary, bounday_nodes);
+			resolution_ = resolution;
+		}
 
-			Eigen::MatrixXd uv, samples, gtmp, rhs_fun;
-			Eigen::VectorXi global_primitive_ids;
+		bool RhsAssembler::LSQBCCache::is_valid(const std::vector<LocalBoundary> &local_boundary, const std::vector<int> &bounday_nodes, const int resolution) const
+		{
+			return n_local_boundary_ == local_boundary.size()
+				   && n_boundary_nodes_ == bounday_nodes.size()
+				   && resolution_ == resolution
+				   && boundary_hash_ == hash_boundary(local_boundary, bounday_nodes);
+		}
+
+		void RhsAssembler::clear_cache() const
+		{
+			lsq_bc_cache_ = nullptr;
+			time_bc_mass_.resize(0, 0);
+			time_bc_solver_ = nullptr;
+		}
+
+		void RhsAssembler::build_lsq_bc_cache(const std::vector<LocalBoundary> &local_boundary, const std::vector<int> &bounday_nodes, const int resolution) const
+		{
+			lsq_bc_cache_ = std::make_unique<LSQBCCache>();
+			LSQBCCache &cache = *lsq_bc_cache_;
+			cache.set_key(local_boundary, bounday_nodes, resolution);
+			++n_lsq_bc_cache_builds_;
 
 			const int actual_dim = problem_.is_scalar() ? 1 : mesh_.dimension();
 
@@ -250,41 +300,55 @@ namespace polyfem
 			}
 			assert(skipped_count <= 1);
 
-			for (int d = 0; d < size_; ++d)
+			// sample the boundary and evaluate the bases once for all dimensions
+			Eigen::MatrixXd samples;
+			std::vector<int> sample_elements;
+			std::vector<std::vector<AssemblyValues>> sample_vals;
+
+			for (const auto &lb : local_boundary)
 			{
-				int index = 0;
-				std::vector<int> indices;
-				indices.reserve(n_el * 10);
-				std::vector<int> tags;
-				tags.reserve(n_el * 10);
+				const int e = lb.element_id();
+				LSQBCCache::ElementSamples es;
+				bool has_samples = utils::BoundarySampler::sample_boundary(lb, resolution, mesh_, false, es.uv, samples, es.global_primitive_ids);
 
-				long total_size = 0;
+				if (!has_samples)
+					continue;
 
-				Eigen::VectorXi global_index_to_col(n_basis_);
-				global_index_to_col.setConstant(-1);
+				assert(es.global_primitive_ids.size() == samples.rows());
 
-				std::vector<AssemblyValues> tmp_val;
+				gbases_[e].eval_geom_mapping(samples, es.mapped);
+				es.offset = cache.n_samples;
+				cache.n_samples += samples.rows();
 
-				for (const auto &lb : local_boundary)
-				{
-					const int e = lb.element_id();
-					bool has_samples = utils::BoundarySampler::sample_boundary(lb, resolution, mesh_, true, uv, samples, global_primitive_ids);
+				sample_vals.emplace_back();
+				bases_[e].evaluate_bases(samples, sample_vals.back());
+				sample_elements.push_back(e);
+				cache.samples.push_back(std::move(es));
+			}
 
-					if (!has_samples)
-						continue;
+			cache.dims.resize(size_);
+			for (int d = 0; d < size_; ++d)
+			{
+				LSQBCCache::DimSystem &system = cache.dims[d];
 
-					const basis::ElementBases &bs = bases_[e];
-					bs.evaluate_bases(samples, tmp_val);
+				int index = 0;
+				Eigen::VectorXi global_index_to_col(n_basis_);
+				global_index_to_col.setConstant(-1);
+
+				for (size_t k = 0; k < cache.samples.size(); ++k)
+				{
+					const LSQBCCache::ElementSamples &es = cache.samples[k];
+					const basis::ElementBases &bs = bases_[sample_elements[k]];
+					const std::vector<AssemblyValues> &tmp_val = sample_vals[k];
 					const int n_local_bases = int(bs.bases.size());
-					assert(global_primitive_ids.size() == samples.rows());
 
-					for (int s = 0; s < samples.rows(); ++s)
+					for (int s = 0; s < es.global_primitive_ids.size(); ++s)
 					{
-						const int tag = mesh_.get_boundary_id(global_primitive_ids(s));
+						const int tag = mesh_.get_boundary_id(es.global_primitive_ids(s));
 						if (!problem_.all_dimensions_dirichlet() && !problem_.is_dimension_dirichet(tag, d))
 							continue;
 
-						total_size++;
+						system.rows.push_back(es.offset + s);
 
 						for (int j = 0; j < n_local_bases; ++j)
 						{
@@ -302,9 +366,9 @@ namespace polyfem
 									if (global_index_to_col(b.global()[ii].index) == -1)
 									{
 										global_index_to_col(b.global()[ii].index) = index++;
-										indices.push_back(b.global()[ii].index);
-										tags.push_back(tag);
-										assert(indices.size() == size_t(index));
+										system.indices.push_back(b.global()[ii].index);
+										system.tags.push_back(tag);
+										assert(system.indices.size() == size_t(index));
 									}
 								}
 							}
@@ -312,36 +376,23 @@ namespace polyfem
 					}
 				}
 
-				Eigen::MatrixXd global_rhs = Eigen::MatrixXd::Zero(total_size, 1);
-
-				const long buffer_size = total_size * long(indices.size());
-				std::vector<Eigen::Triplet<double>> entries, entries_t;
-
-				index = 0;
+				const long total_size = system.rows.size();
+				if (total_size == 0)
+					continue;
 
+				std::vector<Eigen::Triplet<double>> entries_t;
 				int global_counter = 0;
-				Eigen::MatrixXd mapped;
 
-				for (const auto &lb : local_boundary)
+				for (size_t k = 0; k < cache.samples.size(); ++k)
 				{
-					const int e = lb.element_id();
-					bool has_samples = utils::BoundarySampler::sample_boundary(lb, resolution, mesh_, false, uv, samples, global_primitive_ids);
-
-					if (!has_samples)
-						continue;
-
-					const basis::ElementBases &bs = bases_[e];
-					const basis::ElementBases &gbs = gbases_[e];
+					const LSQBCCache::ElementSamples &es = cache.samples[k];
+					const basis::ElementBases &bs = bases_[sample_elements[k]];
+					const std::vector<AssemblyValues> &tmp_val = sample_vals[k];
 					const int n_local_bases = int(bs.bases.size());
 
-					gbs.eval_geom_mapping(samples, mapped);
-
-					bs.evaluate_bases(samples, tmp_val);
-					df(global_primitive_ids, uv, mapped, rhs_fun);
-
-					for (int s = 0; s < samples.rows(); ++s)
+					for (int s = 0; s < es.global_primitive_ids.size(); ++s)
 					{
-						const int tag = mesh_.get_boundary_id(global_primitive_ids(s));
+						const int tag = mesh_.get_boundary_id(es.global_primitive_ids(s));
 						if (!problem_.all_dimensions_dirichlet() && !problem_.is_dimension_dirichet(tag, d))
 							continue;
 
@@ -354,61 +405,85 @@ namespace polyfem
 							{
 								auto item = global_index_to_col(b.global()[ii].index);
 								if (item != -1)
-								{
-									entries.push_back(Eigen::Triplet<double>(global_counter, item, tmp * b.global()[ii].val));
 									entries_t.push_back(Eigen::Triplet<double>(item, global_counter, tmp * b.global()[ii].val));
-								}
 							}
 						}
 
-						global_rhs(global_counter) = rhs_fun(s, d);
 						global_counter++;
 					}
 				}
 
 				assert(global_counter == total_size);
 
-				if (total_size > 0)
-				{
-					const double mmin = global_rhs.minCoeff();
-					const double mmax = global_rhs.maxCoeff();
+				system.mat_t.resize(int(system.indices.size()), int(total_size));
+				system.mat_t.setFromTriplets(entries_t.begin(), entries_t.end());
 
-					if (fabs(mmin) < 1e-8 && fabs(mmax) < 1e-8)
-					{
-						for (size_t i = 0; i < indices.size(); ++i)
-						{
-							const int tag = tags[i];
-							if (problem_.all_dimensions_dirichlet() || problem_.is_dimension_dirichet(tag, d))
-								rhs(indices[i] * size_ + d) = 0;
-						}
-					}
-					else
-					{
-						StiffnessMatrix mat(int(total_size), int(indices.size()));
-						mat.setFromTriplets(entries.begin(), entries.end());
+				system.A = system.mat_t * StiffnessMatrix(system.mat_t.transpose());
 
-						StiffnessMatrix mat_t(int(indices.size()), int(total_size));
-						mat_t.setFromTriplets(entries_t.begin(), entries_t.end());
+				system.solver = LinearSolver::create(solver_, preconditioner_);
+				system.solver->setParameters(solver_params_);
+				system.solver->analyzePattern(system.A, system.A.rows());
+				system.solver->factorize(system.A);
+			}
+		}
 
-						StiffnessMatrix A = mat_t * mat;
-						Eigen::VectorXd b = mat_t * global_rhs;
+		void RhsAssembler::lsq_bc(const std::function<void(const Eigen::MatrixXi &, const Eigen::MatrixXd &, const Eigen::MatrixXd &, Eigen::MatrixXd &)> &df,
+								  const std::vector<LocalBoundary> &local_boundary, const std::vector<int> &bounday_nodes, const int resolution, Eigen::MatrixXd &rhs) const
+		{
+			if (!lsq_bc_cache_ || !lsq_bc_cache_->is_valid(local_boundary, bounday_nodes, resolution))
+				build_lsq_bc_cache(local_boundary, bounday_nodes, resolution);
 
-						Eigen::VectorXd coeffs(b.rows(), 1);
-						auto solver = LinearSolver::create(solver_, preconditioner_);
-						solver->setParameters(solver_params_);
-						solver->analyzePattern(A, A.rows());
-						solver->factorize(A);
-						coeffs.setZero();
-						solver->solve(b, coeffs);
+			const LSQBCCache &cache = *lsq_bc_cache_;
 
-						logger().trace("RHS solve error {}", (A * coeffs - b).norm());
+			// evaluate the bc function once at all the samples
+			Eigen::MatrixXd rhs_fun;
+			Eigen::MatrixXd all_rhs(cache.n_samples, size_);
+			for (const auto &es : cache.samples)
+			{
+				df(es.global_primitive_ids, es.uv, es.mapped, rhs_fun);
+				assert(rhs_fun.rows() == es.global_primitive_ids.size());
+				all_rhs.middleRows(es.offset, rhs_fun.rows()) = rhs_fun.leftCols(size_);
+			}
 
-						for (long i = 0; i < coeffs.rows(); ++i)
-						{
-							const int tag = tags[i];
-							if (problem_.all_dimensions_dirichlet() || problem_.is_dimension_dirichet(tag, d))
-								rhs(indices[i] * size_ + d) = coeffs(i);
-						}
+			for (int d = 0; d < size_; ++d)
+			{
+				const LSQBCCache::DimSystem &system = cache.dims[d];
+				const long total_size = system.rows.size();
+
+				if (total_size <= 0)
+					continue;
+
+				Eigen::VectorXd global_rhs(total_size);
+				for (long i = 0; i < total_size; ++i)
+					global_rhs(i) = all_rhs(system.rows[i], d);
+
+				const double mmin = global_rhs.minCoeff();
+				const double mmax = global_rhs.maxCoeff();
+
+				if (fabs(mmin) < 1e-8 && fabs(mmax) < 1e-8)
+				{
+					for (size_t i = 0; i < system.indices.size(); ++i)
+					{
+						const int tag = system.tags[i];
+						if (problem_.all_dimensions_dirichlet() || problem_.is_dimension_dirichet(tag, d))
+							rhs(system.indices[i] * size_ + d) = 0;
+					}
+				}
+				else
+				{
+					const Eigen::VectorXd b = system.mat_t * global_rhs;
+
+					Eigen::VectorXd coeffs(b.rows(), 1);
+					coeffs.setZero();
+					system.solver->solve(b, coeffs);
+
+					logger().trace("RHS solve error {}", (system.A * coeffs - b).norm());
+
+					for (long i = 0; i < coeffs.rows(); ++i)
+					{
+						const int tag = system.tags[i];
+						if (problem_.all_dimensions_dirichlet() || problem_.is_dimension_dirichet(tag, d))
+							rhs(system.indices[i] * size_ + d) = coeffs(i);
 					}
 				}
 			}
@@ -7,6 +7,10 @@
 #include <polyfem/assembler/MatParams.hpp>
 #include <polyfem/mesh/LocalBoundary.hpp>
 
+#include <polysolve/LinearSolver.hpp>
+
+#include <memory>
+
 namespace polyfem
 {
 	namespace assembler
@@ -89,7 +93,50 @@ namespace polyfem
 			inline const AssemblyValsCache &ass_vals_cache() const { return ass_vals_cache_; }
 			inline const Assembler &assembler() const { return assembler_; }
 
+			// drops the cached boundary samples and factorizations, needs to be called if the mesh or the bases change in place
+			void clear_cache() const;
+			// number of times the lsq_bc samples and factorizations were built
+			int n_lsq_bc_cache_builds() const { return n_lsq_bc_cache_builds_; }
+
 		private:
+			// samples and factorized systems of lsq_bc, they only depend on the mesh, the bases, and the resolution
+			struct LSQBCCache
+			{
+				struct ElementSamples
+				{
+					Eigen::VectorXi global_primitive_ids;
+					Eigen::MatrixXd uv;
+					Eigen::MatrixXd mapped;
+					long offset; // first row in the stacked samples
+				};
+
+				struct DimSystem
+				{
+					std::vector<int> indices;
+					std::vector<int> tags;
+					std::vector<long> rows; // rows of the stacked samples used in this dimension
+					StiffnessMatrix mat_t;
+					StiffnessMatrix A;
+					std::unique_ptr<polysolve::LinearSolver> solver;
+				};
+
+				// the cache is keyed on the content of the boundary, a boundary rebuilt at the same address is detected
+				void set_key(const std::vector<mesh::LocalBoundary> &local_boundary, const std::vector<int> &bounday_nodes, const int resolution);
+				bool is_valid(const std::vector<mesh::LocalBoundary> &local_boundary, const std::vector<int> &bounday_nodes, const int resolution) const;
+
+				size_t n_local_boundary_ = 0;
+				size_t n_boundary_nodes_ = 0;
+				size_t boundary_hash_ = 0;
+				int resolution_ = -1;
+
+				long n_samples = 0;
+				std::vector<ElementSamples> samples;
+				std::vector<DimSystem> dims;
+			};
+
+			// builds the lsq_bc cache
+			void build_lsq_bc_cache(const std::vector<mesh::LocalBoundary> &local_boundary, const std::vector<int> &bounday_nodes, const int resolution) const;
+
 			// leastsquares fit bc
 			void lsq_bc(const std::function<void(const Eigen::MatrixXi &, const Eigen::MatrixXd &, const Eigen::MatrixXd &, Eigen::MatrixXd &)> &df,
 						const std::vector<mesh::LocalBoundary> &local_boundary, const std::vector<int> &bounday_nodes, const int resolution, Eigen::MatrixXd &rhs) const;
@@ -132,6 +179,12 @@ namespace polyfem
 			const std::vector<RowVectorNd> &dirichlet_nodes_position_;
 			const std::vector<int> &neumann_nodes_;
 			const std::vector<RowVectorNd> &neumann_nodes_position_;
+
+			mutable std::unique_ptr<LSQBCCache> lsq_bc_cache_;
+			mutable int n_lsq_bc_cache_builds_ = 0;
+			// factorized mass matrix used by time_bc
+			mutable StiffnessMatrix time_bc_mass_;
+			mutable std::unique_ptr<polysolve::LinearSolver> time_bc_solver_;
 		};
 	} // namespace assembler
 } // namespace polyfem
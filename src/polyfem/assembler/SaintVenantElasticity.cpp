@@ -85,46 +85,130 @@ namespace polyfem::assembler
 		return res;
 	}
 
+	template <int dim>
+	Eigen::Matrix<double, dim, dim> SaintVenantElasticity::stress_from_strain(const Eigen::Matrix<double, dim, dim> &strain) const
+	{
+		Eigen::Matrix<double, dim, dim> stress_tensor;
+
+		if constexpr (dim == 2)
+		{
+			std::array<double, 3> eps;
+			eps[0] = strain(0, 0);
+			eps[1] = strain(1, 1);
+			eps[2] = 2 * strain(0, 1);
+
+			stress_tensor << stress(eps, 0), stress(eps, 2),
+				stress(eps, 2), stress(eps, 1);
+		}
+		else
+		{
+			std::array<double, 6> eps;
+			eps[0] = strain(0, 0);
+			eps[1] = strain(1, 1);
+			eps[2] = strain(2, 2);
+			eps[3] = 2 * strain(1, 2);
+			eps[4] = 2 * strain(0, 2);
+			eps[5] = 2 * strain(0, 1);
+
+			stress_tensor << stress(eps, 0), stress(eps, 5), stress(eps, 4),
+				stress(eps, 5), stress(eps, 1), stress(eps, 3),
+				stress(eps, 4), stress(eps, 3), stress(eps, 2);
+		}
+
+		return stress_tensor;
+	}
+
+	// W = ½ S:E with S = C:E and E = ½(FᵀF - I), P = F S
+	template <int dim>
+	void SaintVenantElasticity::elastic_stress(
+		const Eigen::Matrix<double, dim, dim> &def_grad,
+		double &energy,
+		Eigen::Matrix<double, dim, dim> &stress,
+		Eigen::Matrix<double, dim * dim, dim * dim> *stress_grad) const
+	{
+		typedef Eigen::Matrix<double, dim, dim> DimMat;
+
+		const DimMat strain = 0.5 * (def_grad.transpose() * def_grad - DimMat::Identity());
+		const DimMat pk2 = stress_from_strain<dim>(strain);
+
+		energy = 0.5 * (pk2.array() * strain.array()).sum();
+		stress = def_grad * pk2;
+
+		if (!stress_grad)
+			return;
+
+		// ∂P_ij/∂F_kl = δ_ik S_lj + (F C:∂E/∂F_kl)_ij, the stress is linear in the strain
+		for (int k = 0; k < dim; ++k)
+		{
+			for (int l = 0; l < dim; ++l)
+			{
+				DimMat dstrain = DimMat::Zero();
+				dstrain.col(l) += 0.5 * def_grad.row(k).transpose();
+				dstrain.row(l) += 0.5 * def_grad.row(k);
+
+				DimMat dstress = def_grad * stress_from_strain<dim>(dstrain);
+				dstress.row(k) += pk2.col(l).transpose();
+
+				stress_grad->col(k + l * dim) = Eigen::Map<const Eigen::Matrix<double, dim * dim, 1>>(dstress.data());
+			}
+		}
+	}
+
 	Eigen::VectorXd
 	SaintVenantElasticity::assemble_gradient(const NonLinearAssemblerData &data) const
 	{
-		// igl::Timer time; time.start();
-
-		const int n_bases = data.vals.basis_values.size();
-
-		return polyfem::gradient_from_energy(
-			size(), n_bases, data,
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar1<double, Eigen::Matrix<double, 6, 1>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar1<double, Eigen::Matrix<double, 8, 1>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar1<double, Eigen::Matrix<double, 12, 1>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar1<double, Eigen::Matrix<double, 18, 1>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar1<double, Eigen::Matrix<double, 24, 1>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar1<double, Eigen::Matrix<double, 30, 1>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar1<double, Eigen::Matrix<double, 60, 1>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar1<double, Eigen::Matrix<double, 81, 1>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar1<double, Eigen::Matrix<double, Eigen::Dynamic, 1, 0, SMALL_N, 1>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar1<double, Eigen::Matrix<double, Eigen::Dynamic, 1, 0, BIG_N, 1>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar1<double, Eigen::VectorXd>>(data); });
+		double energy;
+		Eigen::VectorXd grad;
+		Eigen::MatrixXd hess;
+		assemble_all(data, false, true, false, energy, grad, hess);
+		return grad;
 	}
 
 	Eigen::MatrixXd
 	SaintVenantElasticity::assemble_hessian(const NonLinearAssemblerData &data) const
 	{
-		// igl::Timer time; time.start();
-
-		const int n_bases = data.vals.basis_values.size();
-		return polyfem::hessian_from_energy(
-			size(), n_bases, data,
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::Matrix<double, 6, 1>, Eigen::Matrix<double, 6, 6>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::Matrix<double, 8, 1>, Eigen::Matrix<double, 8, 8>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::Matrix<double, 12, 1>, Eigen::Matrix<double, 12, 12>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::Matrix<double, 18, 1>, Eigen::Matrix<double, 18, 18>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::Matrix<double, 24, 1>, Eigen::Matrix<double, 24, 24>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::Matrix<double, 30, 1>, Eigen::Matrix<double, 30, 30>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::Matrix<double, 60, 1>, Eigen::Matrix<double, 60, 60>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::Matrix<double, 81, 1>, Eigen::Matrix<double, 81, 81>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::Matrix<double, Eigen::Dynamic, 1, 0, SMALL_N, 1>, Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, 0, SMALL_N, SMALL_N>>>(data); },
-			[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::VectorXd, Eigen::MatrixXd>>(data); });
+		double energy;
+		Eigen::VectorXd grad;
+		Eigen::MatrixXd hess;
+		assemble_all(data, false, false, true, energy, grad, hess);
+		return hess;
+	}
+
+	void SaintVenantElasticity::assemble_all(
+		const NonLinearAssemblerData &data,
+		const bool want_energy,
+		const bool want_grad,
+		const bool want_hess,
+		double &energy,
+		Eigen::VectorXd &grad,
+		Eigen::MatrixXd &hess) const
+	{
+		if (!want_grad && !want_hess)
+		{
+			if (want_energy)
+				energy = compute_energy_aux<double>(data);
+			return;
+		}
+
+		if (size() == 2)
+		{
+			polyfem::compute_elastic_quantities_from_stress<2>(
+				data, want_energy, want_grad, want_hess,
+				[&](const int p, const Eigen::Matrix2d &def_grad, double &val, Eigen::Matrix2d &stress, Eigen::Matrix4d *stress_grad) {
+					elastic_stress<2>(def_grad, val, stress, stress_grad);
+				},
+				energy, grad, hess);
+		}
+		else
+		{
+			assert(size() == 3);
+			polyfem::compute_elastic_quantities_from_stress<3>(
+				data, want_energy, want_grad, want_hess,
+				[&](const int p, const Eigen::Matrix3d &def_grad, double &val, Eigen::Matrix3d &stress, Eigen::Matrix<double, 9, 9> *stress_grad) {
+					elastic_stress<3>(def_grad, val, stress, stress_grad);
+				},
+				energy, grad, hess);
+		}
 	}
 
 	void SaintVenantElasticity::assign_stress_tensor(const int el_id, const basis::ElementBases &bs, const basis::ElementBases &gbs, const Eigen::MatrixXd &local_pts, const Eigen::MatrixXd &displacement, const int all_size, const ElasticityTensorType &type, Eigen::MatrixXd &all, const std::function<Eigen::MatrixXd(const Eigen::MatrixXd &)> &fun) const
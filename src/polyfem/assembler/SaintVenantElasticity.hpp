@@ -16,10 +16,12 @@ namespace polyfem::assembler
 		using NLAssembler::assemble_energy;
 		using NLAssembler::assemble_gradient;
 		using NLAssembler::assemble_hessian;
+		using NLAssembler::assemble_all;
 
 		double compute_energy(const NonLinearAssemblerData &data) const override;
 		Eigen::VectorXd assemble_gradient(const NonLinearAssemblerData &data) const override;
 		Eigen::MatrixXd assemble_hessian(const NonLinearAssemblerData &data) const override;
+		void assemble_all(const NonLinearAssemblerData &data, const bool want_energy, const bool want_grad, const bool want_hess, double &energy, Eigen::VectorXd &grad, Eigen::MatrixXd &hess) const override;
 
 		VectorNd compute_rhs(const AutodiffHessianPt &pt) const override;
 
@@ -43,5 +45,13 @@ namespace polyfem::assembler
 
 		template <typename T>
 		T compute_energy_aux(const NonLinearAssemblerData &data) const;
+
+		// second Piola-Kirchhoff stress C:E from the Green strain E
+		template <int dim>
+		Eigen::Matrix<double, dim, dim> stress_from_strain(const Eigen::Matrix<double, dim, dim> &strain) const;
+
+		// energy density, first Piola-Kirchhoff stress, and its derivative wrt F (if not null) in closed form
+		template <int dim>
+		void elastic_stress(const Eigen::Matrix<double, dim, dim> &def_grad, double &energy, Eigen::Matrix<double, dim, dim> &stress, Eigen::Matrix<double, dim * dim, dim * dim> *stress_grad) const;
 	};
 } // namespace polyfem::assembler
@@ -45,6 +45,22 @@ namespace polyfem
 			}
 		}
 
+		void ElementBases::evaluate_bases(const Eigen::MatrixXd &uv, std::vector<AssemblyValues> &basis_values) const
+		{
+			if (eval_bases_func_)
+				eval_bases_func_(uv, basis_values);
+			else if (!tabulation_ || !tabulation_->evaluate(*this, uv, /*grads=*/false, basis_values))
+				evaluate_bases_default(uv, basis_values);
+		}
+
+		void ElementBases::evaluate_grads(const Eigen::MatrixXd &uv, std::vector<AssemblyValues> &basis_values) const
+		{
+			if (eval_grads_func_)
+				eval_grads_func_(uv, basis_values);
+			else if (!tabulation_ || !tabulation_->evaluate(*this, uv, /*grads=*/true, basis_values))
+				evaluate_grads_default(uv, basis_values);
+		}
+
 		void ElementBases::evaluate_bases_default(const Eigen::MatrixXd &uv, std::vector<AssemblyValues> &basis_values) const
 		{
 			basis_values.resize(bases.size());
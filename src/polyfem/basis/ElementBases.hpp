@@ -5,6 +5,7 @@
 #include <polyfem/mesh/Mesh.hpp>
 
 #include <polyfem/assembler/AssemblyValues.hpp>
+#include <polyfem/basis/ReferenceTabulation.hpp>
 
 #include <vector>
 
@@ -64,32 +65,18 @@ namespace polyfem
 			void set_mass_quadrature(const QuadratureFunction &fun) { mass_quadrature_builder_ = fun; }
 
 			// evaluation functions
-			void evaluate_bases(const Eigen::MatrixXd &uv, std::vector<assembler::AssemblyValues> &basis_values) const
-			{
-				if (eval_bases_func_)
-				{
-					eval_bases_func_(uv, basis_values);
-				}
-				else
-				{
-					evaluate_bases_default(uv, basis_values);
-				}
-			}
-			void evaluate_grads(const Eigen::MatrixXd &uv, std::vector<assembler::AssemblyValues> &basis_values) const
-			{
-				if (eval_grads_func_)
-				{
-					eval_grads_func_(uv, basis_values);
-				}
-				else
-				{
-					evaluate_grads_default(uv, basis_values);
-				}
-			}
+			void evaluate_bases(const Eigen::MatrixXd &uv, std::vector<assembler::AssemblyValues> &basis_values) const;
+			void evaluate_grads(const Eigen::MatrixXd &uv, std::vector<assembler::AssemblyValues> &basis_values) const;
 
 			void set_bases_func(EvalBasesFunc fun) { eval_bases_func_ = fun; }
 			void set_grads_func(EvalBasesFunc fun) { eval_grads_func_ = fun; }
 
+			/// @brief Share the evaluations of the local bases with the other elements using the same tabulation.
+			/// Only valid if the local bases do not depend on the element, e.g., Lagrange bases on the reference element.
+			void set_tabulation(const std::shared_ptr<ReferenceTabulation> &tabulation) { tabulation_ = tabulation; }
+			/// @brief Tabulation shared with the other elements, nullptr if the bases are evaluated per element
+			const std::shared_ptr<ReferenceTabulation> &tabulation() const { return tabulation_; }
+
 			// sets mapping from local nodes to global nodes
 			void set_local_node_from_primitive_func(LocalNodeFromPrimitiveFunc fun) { local_node_from_primitive_ = fun; }
 
@@ -104,6 +91,8 @@ namespace polyfem
 			QuadratureFunction mass_quadrature_builder_;
 
 			LocalNodeFromPrimitiveFunc local_node_from_primitive_;
+
+			std::shared_ptr<ReferenceTabulation> tabulation_;
 		};
 	} // namespace basis
 } // namespace polyfem
@@ -12,6 +12,8 @@
 
 #include <cassert>
 #include <array>
+#include <optional>
+#include <set>
 ////////////////////////////////////////////////////////////////////////////////
 
 using namespace polyfem;
@@ -426,63 +428,78 @@ namespace
 			edge_virtual_nodes.resize(ncmesh.n_edges());
 		}
 
+		// the node ids are assigned on first visit, this pass stays serial to keep the numbering
 		for (int f = 0; f < mesh.n_faces(); ++f)
 		{
 			const int discr_order = discr_orders(f);
 			if (mesh.is_cube(f))
-			{
 				quad_local_to_global(serendipity, discr_order, mesh, f, discr_orders, element_nodes_id[f], nodes);
+			else if (mesh.is_simplex(f))
+				tri_local_to_global(is_geom_bases, discr_order, mesh, f, discr_orders, edge_orders, element_nodes_id[f], nodes, edge_virtual_nodes);
+		}
 
-				LocalBoundary lb(f, BoundaryType::QUAD_LINE);
-
-				auto v = quad_vertices_local_to_global(mesh, f);
-				Eigen::Matrix<int, 4, 2> ev;
-				ev.row(0) << v[0], v[1];
-				ev.row(1) << v[1], v[2];
-				ev.row(2) << v[2], v[3];
-				ev.row(3) << v[3], v[0];
-
-				for (int i = 0; i < int(ev.rows()); ++i)
+		// the boundary edges only depend on the mesh, they are found in parallel and gathered in element order
+		std::vector<std::optional<LocalBoundary>> element_boundary(mesh.n_faces());
+		maybe_parallel_for(mesh.n_faces(), [&](int start, int end, int thread_id) {
+			for (int f = start; f < end; ++f)
+			{
+				if (mesh.is_cube(f))
 				{
-					const auto index = find_edge(mesh, f, ev(i, 0), ev(i, 1));
-					const int edge = index.edge;
+					LocalBoundary lb(f, BoundaryType::QUAD_LINE);
 
-					if (mesh.is_boundary_edge(edge) || mesh.get_boundary_id(edge) > 0)
-					{
-						lb.add_boundary_primitive(edge, i);
-					}
-				}
+					auto v = quad_vertices_local_to_global(mesh, f);
+					Eigen::Matrix<int, 4, 2> ev;
+					ev.row(0) << v[0], v[1];
+					ev.row(1) << v[1], v[2];
+					ev.row(2) << v[2], v[3];
+					ev.row(3) << v[3], v[0];
 
-				if (!lb.empty())
-					local_boundary.emplace_back(lb);
-			}
-			else if (mesh.is_simplex(f))
-			{
-				tri_local_to_global(is_geom_bases, discr_order, mesh, f, discr_orders, edge_orders, element_nodes_id[f], nodes, edge_virtual_nodes);
+					for (int i = 0; i < int(ev.rows()); ++i)
+					{
+						const auto index = find_edge(mesh, f, ev(i, 0), ev(i, 1));
+						const int edge = index.edge;
 
-				auto v = tri_vertices_local_to_global(mesh, f);
+						if (mesh.is_boundary_edge(edge) || mesh.get_boundary_id(edge) > 0)
+						{
+							lb.add_boundary_primitive(edge, i);
+						}
+					}
 
-				Eigen::Matrix<int, 3, 2> ev;
-				ev.row(0) << v[0], v[1];
-				ev.row(1) << v[1], v[2];
-				ev.row(2) << v[2], v[0];
+					if (!lb.empty())
+						element_boundary[f].emplace(lb);
+				}
+				else if (mesh.is_simplex(f))
+				{
+					auto v = tri_vertices_local_to_global(mesh, f);
 
-				LocalBoundary lb(f, BoundaryType::TRI_LINE);
+					Eigen::Matrix<int, 3, 2> ev;
+					ev.row(0) << v[0], v[1];
+					ev.row(1) << v[1], v[2];
+					ev.row(2) << v[2], v[0];
 
-				for (int i = 0; i < int(ev.rows()); ++i)
-				{
-					const auto index = find_edge(mesh, f, ev(i, 0), ev(i, 1));
-					const int edge = index.edge;
+					LocalBoundary lb(f, BoundaryType::TRI_LINE);
 
-					if (mesh.is_boundary_edge(edge) || mesh.get_boundary_id(edge) > 0)
+					for (int i = 0; i < int(ev.rows()); ++i)
 					{
-						lb.add_boundary_primitive(edge, i);
+						const auto index = find_edge(mesh, f, ev(i, 0), ev(i, 1));
+						const int edge = index.edge;
+
+						if (mesh.is_boundary_edge(edge) || mesh.get_boundary_id(edge) > 0)
+						{
+							lb.add_boundary_primitive(edge, i);
+						}
 					}
-				}
 
-				if (!lb.empty())
-					local_boundary.emplace_back(lb);
+					if (!lb.empty())
+						element_boundary[f].emplace(lb);
+				}
 			}
+		});
+
+		for (const auto &lb : element_boundary)
+		{
+			if (lb)
+				local_boundary.emplace_back(*lb);
 		}
 
 		if (!has_polys)
@@ -728,194 +745,241 @@ int LagrangeBasis2d::build_bases(
 	// boundary_nodes = nodes.boundary_nodes();
 
 	bases.resize(mesh.n_faces());
-	std::vector<int> interface_elements;
-	interface_elements.reserve(mesh.n_faces());
 
+	// the local bases of the elements of the same type and order are the same, so are their evaluations
+	// the tabulations are created upfront so that the element loop only reads the maps
+	std::map<int, std::shared_ptr<ReferenceTabulation>> cube_tabulations, simplex_tabulations;
+	const auto tabulation = [](std::map<int, std::shared_ptr<ReferenceTabulation>> &tabulations, const int order) {
+		auto &t = tabulations[order];
+		if (!t)
+			t = std::make_shared<ReferenceTabulation>();
+		return t;
+	};
 	for (int e = 0; e < mesh.n_faces(); ++e)
 	{
-		ElementBases &b = bases[e];
-		const int discr_order = discr_orders(e);
-		const int n_el_bases = element_nodes_id[e].size();
-		b.bases.resize(n_el_bases);
-
-		bool skip_interface_element = false;
-
-		for (int j = 0; j < n_el_bases; ++j)
-		{
-			const int global_index = element_nodes_id[e][j];
-			if (global_index < 0)
-			{
-				skip_interface_element = true;
-				break;
-			}
-		}
+		if (mesh.is_cube(e))
+			tabulation(cube_tabulations, serendipity ? -2 : discr_orders(e));
+		else if (mesh.is_simplex(e))
+			tabulation(simplex_tabulations, discr_orders(e));
+	}
 
-		if (skip_interface_element)
+	// the elements only read the node ids and positions, so they are built in parallel
+	std::vector<char> is_interface_element(mesh.n_faces(), false);
+	maybe_parallel_for(mesh.n_faces(), [&](int start, int end, int thread_id) {
+		for (int e = start; e < end; ++e)
 		{
-			interface_elements.push_back(e);
-		}
+			ElementBases &b = bases[e];
+			const int discr_order = discr_orders(e);
+			const int n_el_bases = element_nodes_id[e].size();
+			b.bases.resize(n_el_bases);
 
-		if (mesh.is_cube(e))
-		{
-			const int real_order = quadrature_order > 0 ? quadrature_order : AssemblerUtils::quadrature_order(assembler, discr_order, AssemblerUtils::BasisType::CUBE_LAGRANGE, 2);
-			const int real_mass_order = mass_quadrature_order > 0 ? mass_quadrature_order : AssemblerUtils::quadrature_order("Mass", discr_order, AssemblerUtils::BasisType::CUBE_LAGRANGE, 2);
-			b.set_quadrature([real_order](Quadrature &quad) {
-				QuadQuadrature quad_quadrature;
-				quad_quadrature.get_quadrature(real_order, quad);
-			});
-			b.set_mass_quadrature([real_mass_order](Quadrature &quad) {
-				QuadQuadrature quad_quadrature;
-				quad_quadrature.get_quadrature(real_mass_order, quad);
-			});
-			// quad_quadrature.get_quadrature(real_order, b.quadrature);
-
-			b.set_local_node_from_primitive_func([discr_order, e](const int primitive_id, const Mesh &mesh) {
-				const auto &mesh2d = dynamic_cast<const Mesh2D &>(mesh);
-				auto index = mesh2d.get_index_from_face(e);
-
-				for (int le = 0; le < mesh2d.n_face_vertices(e); ++le)
-				{
-					if (index.edge == primitive_id)
-						break;
-					index = mesh2d.next_around_face(index);
-				}
-				assert(index.edge == primitive_id);
-				return quad_edge_local_nodes(discr_order, mesh2d, index);
-			});
+			bool skip_interface_element = false;
 
 			for (int j = 0; j < n_el_bases; ++j)
 			{
 				const int global_index = element_nodes_id[e][j];
-
-				// if(!skip_interface_element)
-				b.bases[j].init(discr_order, global_index, j, nodes.node_position(global_index));
-
-				const int dtmp = serendipity ? -2 : discr_order;
-
-				b.bases[j].set_basis([dtmp, j](const Eigen::MatrixXd &uv, Eigen::MatrixXd &val) { autogen::q_basis_value_2d(dtmp, j, uv, val); });
-				b.bases[j].set_grad([dtmp, j](const Eigen::MatrixXd &uv, Eigen::MatrixXd &val) { autogen::q_grad_basis_value_2d(dtmp, j, uv, val); });
-			}
-		}
-		else if (mesh.is_simplex(e))
-		{
-			const int real_order = quadrature_order > 0 ? quadrature_order : AssemblerUtils::quadrature_order(assembler, discr_order, AssemblerUtils::BasisType::SIMPLEX_LAGRANGE, 2);
-			const int real_mass_order = mass_quadrature_order > 0 ? mass_quadrature_order : AssemblerUtils::quadrature_order("Mass", discr_order, AssemblerUtils::BasisType::SIMPLEX_LAGRANGE, 2);
-			b.set_quadrature([real_order](Quadrature &quad) {
-				TriQuadrature tri_quadrature;
-				tri_quadrature.get_quadrature(real_order, quad);
-			});
-			b.set_mass_quadrature([real_mass_order](Quadrature &quad) {
-				TriQuadrature tri_quadrature;
-				tri_quadrature.get_quadrature(real_mass_order, quad);
-			});
-
-			b.set_local_node_from_primitive_func([discr_order, e](const int primitive_id, const Mesh &mesh) {
-				const auto &mesh2d = dynamic_cast<const Mesh2D &>(mesh);
-				auto index = mesh2d.get_index_from_face(e);
-
-				for (int le = 0; le < mesh2d.n_face_vertices(e); ++le)
+				if (global_index < 0)
 				{
-					if (index.edge == primitive_id)
-						break;
-					index = mesh2d.next_around_face(index);
+					skip_interface_element = true;
+					break;
 				}
-				assert(index.edge == primitive_id);
-				return tri_edge_local_nodes(discr_order, mesh2d, index);
-			});
+			}
 
-			const bool rational = is_geom_bases && mesh.is_rational() && !mesh.cell_weights(e).empty();
+			if (skip_interface_element)
+			{
+				is_interface_element[e] = true;
+			}
 
-			for (int j = 0; j < n_el_bases; ++j)
+			if (mesh.is_cube(e))
 			{
-				const int global_index = element_nodes_id[e][j];
+				const int real_order = quadrature_order > 0 ? quadrature_order : AssemblerUtils::quadrature_order(assembler, discr_order, AssemblerUtils::BasisType::CUBE_LAGRANGE, 2);
+				const int real_mass_order = mass_quadrature_order > 0 ? mass_quadrature_order : AssemblerUtils::quadrature_order("Mass", discr_order, AssemblerUtils::BasisType::CUBE_LAGRANGE, 2);
+				b.set_quadrature([real_order](Quadrature &quad) {
+					QuadQuadrature quad_quadrature;
+					quad_quadrature.get_quadrature(real_order, quad);
+				});
+				b.set_mass_quadrature([real_mass_order](Quadrature &quad) {
+					QuadQuadrature quad_quadrature;
+					quad_quadrature.get_quadrature(real_mass_order, quad);
+				});
+				// quad_quadrature.get_quadrature(real_order, b.quadrature);
+
+				b.set_local_node_from_primitive_func([discr_order, e](const int primitive_id, const Mesh &mesh) {
+					const auto &mesh2d = dynamic_cast<const Mesh2D &>(mesh);
+					auto index = mesh2d.get_index_from_face(e);
+
+					for (int le = 0; le < mesh2d.n_face_vertices(e); ++le)
+					{
+						if (index.edge == primitive_id)
+							break;
+						index = mesh2d.next_around_face(index);
+					}
+					assert(index.edge == primitive_id);
+					return quad_edge_local_nodes(discr_order, mesh2d, index);
+				});
 
-				if (!skip_interface_element)
+				for (int j = 0; j < n_el_bases; ++j)
 				{
+					const int global_index = element_nodes_id[e][j];
+
+					// if(!skip_interface_element)
 					b.bases[j].init(discr_order, global_index, j, nodes.node_position(global_index));
+
+					const int dtmp = serendipity ? -2 : discr_order;
+
+					b.bases[j].set_basis([dtmp, j](const Eigen::MatrixXd &uv, Eigen::MatrixXd &val) { autogen::q_basis_value_2d(dtmp, j, uv, val); });
+					b.bases[j].set_grad([dtmp, j](const Eigen::MatrixXd &uv, Eigen::MatrixXd &val) { autogen::q_grad_basis_value_2d(dtmp, j, uv, val); });
 				}
 
-				if (rational)
+				b.set_tabulation(cube_tabulations.at(serendipity ? -2 : discr_order));
+			}
+			else if (mesh.is_simplex(e))
+			{
+				const int real_order = quadrature_order > 0 ? quadrature_order : AssemblerUtils::quadrature_order(assembler, discr_order, AssemblerUtils::BasisType::SIMPLEX_LAGRANGE, 2);
+				const int real_mass_order = mass_quadrature_order > 0 ? mass_quadrature_order : AssemblerUtils::quadrature_order("Mass", discr_order, AssemblerUtils::BasisType::SIMPLEX_LAGRANGE, 2);
+				b.set_quadrature([real_order](Quadrature &quad) {
+					TriQuadrature tri_quadrature;
+					tri_quadrature.get_quadrature(real_order, quad);
+				});
+				b.set_mass_quadrature([real_mass_order](Quadrature &quad) {
+					TriQuadrature tri_quadrature;
+					tri_quadrature.get_quadrature(real_mass_order, quad);
+				});
+
+				b.set_local_node_from_primitive_func([discr_order, e](const int primitive_id, const Mesh &mesh) {
+					const auto &mesh2d = dynamic_cast<const Mesh2D &>(mesh);
+					auto index = mesh2d.get_index_from_face(e);
+
+					for (int le = 0; le < mesh2d.n_face_vertices(e); ++le)
+					{
+						if (index.edge == primitive_id)
+							break;
+						index = mesh2d.next_around_face(index);
+					}
+					assert(index.edge == primitive_id);
+					return tri_edge_local_nodes(discr_order, mesh2d, index);
+				});
+
+				const bool rational = is_geom_bases && mesh.is_rational() && !mesh.cell_weights(e).empty();
+
+				for (int j = 0; j < n_el_bases; ++j)
 				{
-					const auto &w = mesh.cell_weights(e);
-					assert(discr_order == 2);
-					assert(w.size() == 6);
+					const int global_index = element_nodes_id[e][j];
+
+					if (!skip_interface_element)
+					{
+						b.bases[j].init(discr_order, global_index, j, nodes.node_position(global_index));
+					}
 
-					b.bases[j].set_basis([discr_order, j, w](const Eigen::MatrixXd &uv, Eigen::MatrixXd &val) {
-						autogen::p_basis_value_2d(discr_order, j, uv, val);
-						Eigen::MatrixXd denom = val;
-						denom.setZero();
-						Eigen::MatrixXd tmp;
+					if (rational)
+					{
+						const auto &w = mesh.cell_weights(e);
+						assert(discr_order == 2);
+						assert(w.size() == 6);
 
-						for (int k = 0; k < 6; ++k)
-						{
-							autogen::p_basis_value_2d(discr_order, k, uv, tmp);
-							denom += w[k] * tmp;
-						}
+						b.bases[j].set_basis([discr_order, j, w](const Eigen::MatrixXd &uv, Eigen::MatrixXd &val) {
+							autogen::p_basis_value_2d(discr_order, j, uv, val);
+							Eigen::MatrixXd denom = val;
+							denom.setZero();
+							Eigen::MatrixXd tmp;
 
-						val = (w[j] * val.array() / denom.array()).eval();
-					});
+							for (int k = 0; k < 6; ++k)
+							{
+								autogen::p_basis_value_2d(discr_order, k, uv, tmp);
+								denom += w[k] * tmp;
+							}
 
-					b.bases[j].set_grad([discr_order, j, w](const Eigen::MatrixXd &uv, Eigen::MatrixXd &val) {
-						Eigen::MatrixXd b;
-						autogen::p_basis_value_2d(discr_order, j, uv, b);
-						autogen::p_grad_basis_value_2d(discr_order, j, uv, val);
-						Eigen::MatrixXd denom = b;
-						denom.setZero();
-						Eigen::MatrixXd denom_prime = val;
-						denom_prime.setZero();
-						Eigen::MatrixXd tmp;
+							val = (w[j] * val.array() / denom.array()).eval();
+						});
 
-						for (int k = 0; k < 6; ++k)
-						{
-							autogen::p_basis_value_2d(discr_order, k, uv, tmp);
-							denom += w[k] * tmp;
+						b.bases[j].set_grad([discr_order, j, w](const Eigen::MatrixXd &uv, Eigen::MatrixXd &val) {
+							Eigen::MatrixXd b;
+							autogen::p_basis_value_2d(discr_order, j, uv, b);
+							autogen::p_grad_basis_value_2d(discr_order, j, uv, val);
+							Eigen::MatrixXd denom = b;
+							denom.setZero();
+							Eigen::MatrixXd denom_prime = val;
+							denom_prime.setZero();
+							Eigen::MatrixXd tmp;
 
-							autogen::p_grad_basis_value_2d(discr_order, k, uv, tmp);
-							denom_prime += w[k] * tmp;
-						}
+							for (int k = 0; k < 6; ++k)
+							{
+								autogen::p_basis_value_2d(discr_order, k, uv, tmp);
+								denom += w[k] * tmp;
 
-						val.col(0) = ((w[j] * val.col(0).array() * denom.array() - w[j] * b.array() * denom_prime.col(0).array()) / (denom.array() * denom.array())).eval();
-						val.col(1) = ((w[j] * val.col(1).array() * denom.array() - w[j] * b.array() * denom_prime.col(1).array()) / (denom.array() * denom.array())).eval();
-					});
-				}
-				else
-				{
-					b.bases[j].set_basis([discr_order, j](const Eigen::MatrixXd &uv, Eigen::MatrixXd &val) { autogen::p_basis_value_2d(discr_order, j, uv, val); });
-					b.bases[j].set_grad([discr_order, j](const Eigen::MatrixXd &uv, Eigen::MatrixXd &val) { autogen::p_grad_basis_value_2d(discr_order, j, uv, val); });
+								autogen::p_grad_basis_value_2d(discr_order, k, uv, tmp);
+								denom_prime += w[k] * tmp;
+							}
+
+							val.col(0) = ((w[j] * val.col(0).array() * denom.array() - w[j] * b.array() * denom_prime.col(0).array()) / (denom.array() * denom.array())).eval();
+							val.col(1) = ((w[j] * val.col(1).array() * denom.array() - w[j] * b.array() * denom_prime.col(1).array()) / (denom.array() * denom.array())).eval();
+						});
+					}
+					else
+					{
+						b.bases[j].set_basis([discr_order, j](const Eigen::MatrixXd &uv, Eigen::MatrixXd &val) { autogen::p_basis_value_2d(discr_order, j, uv, val); });
+						b.bases[j].set_grad([discr_order, j](const Eigen::MatrixXd &uv, Eigen::MatrixXd &val) { autogen::p_grad_basis_value_2d(discr_order, j, uv, val); });
+					}
 				}
+
+				// rational bases depend on the weights of the element
+				if (!rational)
+					b.set_tabulation(simplex_tabulations.at(discr_order));
+			}
+			else
+			{
+				// Polygon bases are built later on
 			}
-		}
-		else
-		{
-			// Polygon bases are built later on
-		}
 
 #ifndef NDEBUG
-		if (mesh.is_conforming())
-		{
-			Eigen::MatrixXd uv(4, 2);
-			uv << 0.1, 0.1, 0.3, 0.3, 0.9, 0.01, 0.01, 0.9;
-			Eigen::MatrixXd dx(4, 1);
-			dx.setConstant(1e-6);
-			Eigen::MatrixXd uvdx = uv;
-			uvdx.col(0) += dx;
-			Eigen::MatrixXd uvdy = uv;
-			uvdy.col(1) += dx;
-			Eigen::MatrixXd grad, val, vdx, vdy;
-
-			for (int j = 0; j < n_el_bases; ++j)
+			if (mesh.is_conforming())
 			{
-				b.bases[j].eval_grad(uv, grad);
+				Eigen::MatrixXd uv(4, 2);
+				uv << 0.1, 0.1, 0.3, 0.3, 0.9, 0.01, 0.01, 0.9;
+				Eigen::MatrixXd dx(4, 1);
+				dx.setConstant(1e-6);
+				Eigen::MatrixXd uvdx = uv;
+				uvdx.col(0) += dx;
+				Eigen::MatrixXd uvdy = uv;
+				uvdy.col(1) += dx;
+				Eigen::MatrixXd grad, val, vdx, vdy;
+
+				for (int j = 0; j < n_el_bases; ++j)
+				{
+					b.bases[j].eval_grad(uv, grad);
 
-				b.bases[j].eval_basis(uv, val);
-				b.bases[j].eval_basis(uvdx, vdx);
-				b.bases[j].eval_basis(uvdy, vdy);
+					b.bases[j].eval_basis(uv, val);
+					b.bases[j].eval_basis(uvdx, vdx);
+					b.bases[j].eval_basis(uvdy, vdy);
 
-				assert((grad.col(0) - (vdx - val) / 1e-6).norm() < 1e-4);
-				assert((grad.col(1) - (vdy - val) / 1e-6).norm() < 1e-4);
+					assert((grad.col(0) - (vdx - val) / 1e-6).norm() < 1e-4);
+					assert((grad.col(1) - (vdy - val) / 1e-6).norm() < 1e-4);
+				}
 			}
-		}
 #endif
+		}
+	});
+
+	// only the quadrature points are tabulated, other points (e.g., point queries) are evaluated directly
+	std::set<const ReferenceTabulation *> tabulated;
+	for (int e = 0; e < mesh.n_faces(); ++e)
+	{
+		const auto &t = bases[e].tabulation();
+		if (!t || is_interface_element[e] || !tabulated.insert(t.get()).second)
+			continue;
+
+		Quadrature quad;
+		bases[e].compute_quadrature(quad);
+		t->add_points(bases[e], quad.points);
+		bases[e].compute_mass_quadrature(quad);
+		t->add_points(bases[e], quad.points);
+	}
+
+	std::vector<int> interface_elements;
+	for (int e = 0; e < mesh.n_faces(); ++e)
+	{
+		if (is_interface_element[e])
+			interface_elements.push_back(e);
 	}
 
 	if (!is_geom_bases)
@@ -15,6 +15,8 @@
 
 #include <cassert>
 #include <array>
+#include <optional>
+#include <set>
 ////////////////////////////////////////////////////////////////////////////////
 
 using namespace polyfem;
@@ -562,63 +564,80 @@ namespace
 			face_virtual_nodes.resize(ncmesh.n_faces());
 		}
 
+		// the node ids are assigned on first visit, this pass stays serial to keep the numbering
 		for (int c = 0; c < mesh.n_cells(); ++c)
 		{
 			const int discr_order = discr_orders(c);
 
 			if (mesh.is_cube(c))
-			{
 				hex_local_to_global(serendipity, discr_order, mesh, c, discr_orders, element_nodes_id[c], nodes);
-
-				auto v = hex_vertices_local_to_global(mesh, c);
-				Eigen::Matrix<int, 6, 4> fv;
-				fv.row(0) << v[0], v[3], v[4], v[7];
-				fv.row(1) << v[1], v[2], v[5], v[6];
-				fv.row(2) << v[0], v[1], v[5], v[4];
-				fv.row(3) << v[3], v[2], v[6], v[7];
-				fv.row(4) << v[0], v[1], v[2], v[3];
-				fv.row(5) << v[4], v[5], v[6], v[7];
-
-				LocalBoundary lb(c, BoundaryType::QUAD);
-				for (int i = 0; i < fv.rows(); ++i)
-				{
-					const int f = find_quad_face(mesh, c, fv(i, 0), fv(i, 1), fv(i, 2), fv(i, 3)).face;
-
-					if (mesh.is_boundary_face(f) || mesh.get_boundary_id(f) > 0)
-					{
-						lb.add_boundary_primitive(f, i);
-					}
-				}
-
-				if (!lb.empty())
-					local_boundary.emplace_back(lb);
-			}
 			else if (mesh.is_simplex(c))
 			{
 				// element_nodes_id[c] = polyfem::LagrangeBasis3d::tet_local_to_global(discr_order, mesh, c, discr_orders, nodes);
 				tet_local_to_global(is_geom_bases, discr_order, mesh, c, discr_orders, edge_orders, face_orders, element_nodes_id[c], nodes, edge_virtual_nodes, face_virtual_nodes);
+			}
+		}
 
-				auto v = tet_vertices_local_to_global(mesh, c);
-				Eigen::Matrix<int, 4, 3> fv;
-				fv.row(0) << v[0], v[1], v[2];
-				fv.row(1) << v[0], v[1], v[3];
-				fv.row(2) << v[1], v[2], v[3];
-				fv.row(3) << v[2], v[0], v[3];
-
-				LocalBoundary lb(c, BoundaryType::TRI);
-				for (long i = 0; i < fv.rows(); ++i)
+		// the boundary facets only depend on the mesh, they are found in parallel and gathered in element order
+		std::vector<std::optional<LocalBoundary>> element_boundary(mesh.n_cells());
+		polyfem::utils::maybe_parallel_for(mesh.n_cells(), [&](int start, int end, int thread_id) {
+			for (int c = start; c < end; ++c)
+			{
+				if (mesh.is_cube(c))
 				{
-					const int f = mesh.get_index_from_element_face(c, fv(i, 0), fv(i, 1), fv(i, 2)).face;
-
-					if (mesh.is_boundary_face(f))
+					auto v = hex_vertices_local_to_global(mesh, c);
+					Eigen::Matrix<int, 6, 4> fv;
+					fv.row(0) << v[0], v[3], v[4], v[7];
+					fv.row(1) << v[1], v[2], v[5], v[6];
+					fv.row(2) << v[0], v[1], v[5], v[4];
+					fv.row(3) << v[3], v[2], v[6], v[7];
+					fv.row(4) << v[0], v[1], v[2], v[3];
+					fv.row(5) << v[4], v[5], v[6], v[7];
+
+					LocalBoundary lb(c, BoundaryType::QUAD);
+					for (int i = 0; i < fv.rows(); ++i)
 					{
-						lb.add_boundary_primitive(f, i);
+						const int f = find_quad_face(mesh, c, fv(i, 0), fv(i, 1), fv(i, 2), fv(i, 3)).face;
+
+						if (mesh.is_boundary_face(f) || mesh.get_boundary_id(f) > 0)
+						{
+							lb.add_boundary_primitive(f, i);
+						}
 					}
+
+					if (!lb.empty())
+						element_boundary[c].emplace(lb);
 				}
+				else if (mesh.is_simplex(c))
+				{
+					auto v = tet_vertices_local_to_global(mesh, c);
+					Eigen::Matrix<int, 4, 3> fv;
+					fv.row(0) << v[0], v[1], v[2];
+					fv.row(1) << v[0], v[1], v[3];
+					fv.row(2) << v[1], v[2], v[3];
+					fv.row(3) << v[2], v[0], v[3];
+
+					LocalBoundary lb(c, BoundaryType::TRI);
+					for (long i = 0; i < fv.rows(); ++i)
+					{
+						const int f = mesh.get_index_from_element_face(c, fv(i, 0), fv(i, 1), fv(i, 2)).face;
+
+						if (mesh.is_boundary_face(f))
+						{
+							lb.add_boundary_primitive(f, i);
+						}
+					}
 
-				if (!lb.empty())
-					local_boundary.emplace_back(lb);
+					if (!lb.empty())
+						element_boundary[c].emplace(lb);
+				}
 			}
+		});
+
+		for (const auto &lb : element_boundary)
+		{
+			if (lb)
+				local_boundary.emplace_back(*lb);
 		}
 
 		if (!has_polys)
@@ -1439,120 +1458,165 @@ int LagrangeBasis3d::build_bases(
 	// std::cout<<"switch_element_time " << Navigation3D::switch_element_time <<std::endl;
 
 	bases.resize(mesh.n_cells());
-	std::vector<int> interface_elements;
-	interface_elements.reserve(mesh.n_faces());
 
+	// the local bases of the elements of the same type and order are the same, so are their evaluations
+	// the tabulations are created upfront so that the element loop only reads the maps
+	std::map<int, std::shared_ptr<ReferenceTabulation>> cube_tabulations, simplex_tabulations;
+	const auto tabulation = [](std::map<int, std::shared_ptr<ReferenceTabulation>> &tabulations, const int order) {
+		auto &t = tabulations[order];
+		if (!t)
+			t = std::make_shared<ReferenceTabulation>();
+		return t;
+	};
 	for (int e = 0; e < mesh.n_cells(); ++e)
 	{
-		ElementBases &b = bases[e];
-		const int discr_order = discr_orders(e);
-		const int n_el_bases = (int)element_nodes_id[e].size();
-		b.bases.resize(n_el_bases);
-
-		bool skip_interface_element = false;
+		if (mesh.is_cube(e))
+			tabulation(cube_tabulations, serendipity ? -2 : discr_orders(e));
+		else if (mesh.is_simplex(e))
+			tabulation(simplex_tabulations, discr_orders(e));
+	}
 
-		for (int j = 0; j < n_el_bases; ++j)
+	// the elements only read the node ids and positions, so they are built in parallel
+	std::vector<char> is_interface_element(mesh.n_cells(), false);
+	polyfem::utils::maybe_parallel_for(mesh.n_cells(), [&](int start, int end, int thread_id) {
+		for (int e = start; e < end; ++e)
 		{
-			const int global_index = element_nodes_id[e][j];
-			if (global_index < 0)
-			{
-				skip_interface_element = true;
-				break;
-			}
-		}
+			ElementBases &b = bases[e];
+			const int discr_order = discr_orders(e);
+			const int n_el_bases = (int)element_nodes_id[e].size();
+			b.bases.resize(n_el_bases);
 
-		if (skip_interface_element)
-		{
-			interface_elements.push_back(e);
-		}
+			bool skip_interface_element = false;
 
-		if (mesh.is_cube(e))
-		{
-			const int real_order = quadrature_order > 0 ? quadrature_order : AssemblerUtils::quadrature_order(assembler, discr_order, AssemblerUtils::BasisType::CUBE_LAGRANGE, 3);
-			const int real_mass_order = mass_quadrature_order > 0 ? mass_quadrature_order : AssemblerUtils::quadrature_order("Mass", discr_order, AssemblerUtils::BasisType::CUBE_LAGRANGE, 3);
-			b.set_quadrature([real_order](Quadrature &quad) {
-				HexQuadrature hex_quadrature;
-				hex_quadrature.get_quadrature(real_order, quad);
-			});
-			b.set_mass_quadrature([real_mass_order](Quadrature &quad) {
-				HexQuadrature hex_quadrature;
-				hex_quadrature.get_quadrature(real_mass_order, quad);
-			});
-
-			b.set_local_node_from_primitive_func([serendipity, discr_order, e](const int primitive_id, const Mesh &mesh) {
-				const auto &mesh3d = dynamic_cast<const Mesh3D &>(mesh);
-				Navigation3D::Index index;
-
-				for (int lf = 0; lf < 6; ++lf)
+			for (int j = 0; j < n_el_bases; ++j)
+			{
+				const int global_index = element_nodes_id[e][j];
+				if (global_index < 0)
 				{
-					index = mesh3d.get_index_from_element(e, lf, 0);
-					if (index.face == primitive_id)
-						break;
+					skip_interface_element = true;
+					break;
 				}
-				assert(index.face == primitive_id);
-				return hex_face_local_nodes(serendipity, discr_order, mesh3d, index);
-			});
+			}
 
-			for (int j = 0; j < n_el_bases; ++j)
+			if (skip_interface_element)
 			{
-				const int global_index = element_nodes_id[e][j];
+				is_interface_element[e] = true;
+			}
 
-				b.bases[j].init(discr_order, global_index, j, nodes.node_position(global_index));
+			if (mesh.is_cube(e))
+			{
+				const int real_order = quadrature_order > 0 ? quadrature_order : AssemblerUtils::quadrature_order(assembler, discr_order, AssemblerUtils::BasisType::CUBE_LAGRANGE, 3);
+				const int real_mass_order = mass_quadrature_order > 0 ? mass_quadrature_order : AssemblerUtils::quadrature_order("Mass", discr_order, AssemblerUtils::BasisType::CUBE_LAGRANGE, 3);
+				b.set_quadrature([real_order](Quadrature &quad) {
+					HexQuadrature hex_quadrature;
+					hex_quadrature.get_quadrature(real_order, quad);
+				});
+				b.set_mass_quadrature([real_mass_order](Quadrature &quad) {
+					HexQuadrature hex_quadrature;
+					hex_quadrature.get_quadrature(real_mass_order, quad);
+				});
 
-				const int dtmp = serendipity ? -2 : discr_order;
+				b.set_local_node_from_primitive_func([serendipity, discr_order, e](const int primitive_id, const Mesh &mesh) {
+					const auto &mesh3d = dynamic_cast<const Mesh3D &>(mesh);
+					Navigation3D::Index index;
 
-				b.bases[j].set_basis([dtmp, j](const Eigen::MatrixXd &uv, Eigen::MatrixXd &val) { autogen::q_basis_value_3d(dtmp, j, uv, val); });
-				b.bases[j].set_grad([dtmp, j](const Eigen::MatrixXd &uv, Eigen::MatrixXd &val) { autogen::q_grad_basis_value_3d(dtmp, j, uv, val); });
-			}
-		}
-		else if (mesh.is_simplex(e))
-		{
-			const int real_order = quadrature_order > 0 ? quadrature_order : AssemblerUtils::quadrature_order(assembler, discr_order, AssemblerUtils::BasisType::SIMPLEX_LAGRANGE, 3);
-			const int real_mass_order = mass_quadrature_order > 0 ? mass_quadrature_order : AssemblerUtils::quadrature_order("Mass", discr_order, AssemblerUtils::BasisType::SIMPLEX_LAGRANGE, 3);
-
-			b.set_quadrature([real_order](Quadrature &quad) {
-				TetQuadrature tet_quadrature;
-				tet_quadrature.get_quadrature(real_order, quad);
-			});
-			b.set_mass_quadrature([real_mass_order](Quadrature &quad) {
-				TetQuadrature tet_quadrature;
-				tet_quadrature.get_quadrature(real_mass_order, quad);
-			});
-
-			b.set_local_node_from_primitive_func([discr_order, e](const int primitive_id, const Mesh &mesh) {
-				const auto &mesh3d = dynamic_cast<const Mesh3D &>(mesh);
-				Navigation3D::Index index;
-
-				for (int lf = 0; lf < mesh3d.n_cell_faces(e); ++lf)
+					for (int lf = 0; lf < 6; ++lf)
+					{
+						index = mesh3d.get_index_from_element(e, lf, 0);
+						if (index.face == primitive_id)
+							break;
+					}
+					assert(index.face == primitive_id);
+					return hex_face_local_nodes(serendipity, discr_order, mesh3d, index);
+				});
+
+				for (int j = 0; j < n_el_bases; ++j)
 				{
-					index = mesh3d.get_index_from_element(e, lf, 0);
-					if (index.face == primitive_id)
-						break;
-				}
-				assert(index.face == primitive_id);
-				return tet_face_local_nodes(discr_order, mesh3d, index);
-			});
+					const int global_index = element_nodes_id[e][j];
 
-			const bool rational = is_geom_bases && mesh.is_rational() && !mesh.cell_weights(e).empty();
-			assert(!rational);
+					b.bases[j].init(discr_order, global_index, j, nodes.node_position(global_index));
 
-			for (int j = 0; j < n_el_bases; ++j)
+					const int dtmp = serendipity ? -2 : discr_order;
+
+					b.bases[j].set_basis([dtmp, j](const Eigen::MatrixXd &uv, Eigen::MatrixXd &val) { autogen::q_basis_value_3d(dtmp, j, uv, val); });
+					b.bases[j].set_grad([dtmp, j](const Eigen::MatrixXd &uv, Eigen::MatrixXd &val) { autogen::q_grad_basis_value_3d(dtmp, j, uv, val); });
+				}
+
+				b.set_tabulation(cube_tabulations.at(serendipity ? -2 : discr_order));
+			}
+			else if (mesh.is_simplex(e))
 			{
-				const int global_index = element_nodes_id[e][j];
-				if (!skip_interface_element)
+				const int real_order = quadrature_order > 0 ? quadrature_order : AssemblerUtils::quadrature_order(assembler, discr_order, AssemblerUtils::BasisType::SIMPLEX_LAGRANGE, 3);
+				const int real_mass_order = mass_quadrature_order > 0 ? mass_quadrature_order : AssemblerUtils::quadrature_order("Mass", discr_order, AssemblerUtils::BasisType::SIMPLEX_LAGRANGE, 3);
+
+				b.set_quadrature([real_order](Quadrature &quad) {
+					TetQuadrature tet_quadrature;
+					tet_quadrature.get_quadrature(real_order, quad);
+				});
+				b.set_mass_quadrature([real_mass_order](Quadrature &quad) {
+					TetQuadrature tet_quadrature;
+					tet_quadrature.get_quadrature(real_mass_order, quad);
+				});
+
+				b.set_local_node_from_primitive_func([discr_order, e](const int primitive_id, const Mesh &mesh) {
+					const auto &mesh3d = dynamic_cast<const Mesh3D &>(mesh);
+					Navigation3D::Index index;
+
+					for (int lf = 0; lf < mesh3d.n_cell_faces(e); ++lf)
+					{
+						index = mesh3d.get_index_from_element(e, lf, 0);
+						if (index.face == primitive_id)
+							break;
+					}
+					assert(index.face == primitive_id);
+					return tet_face_local_nodes(discr_order, mesh3d, index);
+				});
+
+				const bool rational = is_geom_bases && mesh.is_rational() && !mesh.cell_weights(e).empty();
+				assert(!rational);
+
+				for (int j = 0; j < n_el_bases; ++j)
 				{
-					b.bases[j].init(discr_order, global_index, j, nodes.node_position(global_index));
+					const int global_index = element_nodes_id[e][j];
+					if (!skip_interface_element)
+					{
+						b.bases[j].init(discr_order, global_index, j, nodes.node_position(global_index));
+					}
+
+					b.bases[j].set_basis([discr_order, j](const Eigen::MatrixXd &uv, Eigen::MatrixXd &val) { autogen::p_basis_value_3d(discr_order, j, uv, val); });
+					b.bases[j].set_grad([discr_order, j](const Eigen::MatrixXd &uv, Eigen::MatrixXd &val) { autogen::p_grad_basis_value_3d(discr_order, j, uv, val); });
 				}
 
-				b.bases[j].set_basis([discr_order, j](const Eigen::MatrixXd &uv, Eigen::MatrixXd &val) { autogen::p_basis_value_3d(discr_order, j, uv, val); });
-				b.bases[j].set_grad([discr_order, j](const Eigen::MatrixXd &uv, Eigen::MatrixXd &val) { autogen::p_grad_basis_value_3d(discr_order, j, uv, val); });
+				b.set_tabulation(simplex_tabulations.at(discr_order));
+			}
+			else
+			{
+				// Polyhedra bases are built later on
+				// assert(false);
 			}
 		}
-		else
-		{
-			// Polyhedra bases are built later on
-			// assert(false);
-		}
+	});
+
+	// only the quadrature points are tabulated, other points (e.g., point queries) are evaluated directly
+	std::set<const ReferenceTabulation *> tabulated;
+	for (int e = 0; e < mesh.n_cells(); ++e)
+	{
+		const auto &t = bases[e].tabulation();
+		if (!t || is_interface_element[e] || !tabulated.insert(t.get()).second)
+			continue;
+
+		Quadrature quad;
+		bases[e].compute_quadrature(quad);
+		t->add_points(bases[e], quad.points);
+		bases[e].compute_mass_quadrature(quad);
+		t->add_points(bases[e], quad.points);
+	}
+
+	std::vector<int> interface_elements;
+	for (int e = 0; e < mesh.n_cells(); ++e)
+	{
+		if (is_interface_element[e])
+			interface_elements.push_back(e);
 	}
 
 	if (!is_geom_bases)
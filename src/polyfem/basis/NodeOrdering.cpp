@@ -0,0 +1,302 @@
+#include "NodeOrdering.hpp"
+
+#include <polyfem/utils/MaybeParallelFor.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+
+namespace polyfem
+{
+	namespace basis
+	{
+		namespace
+		{
+			// element to nodes and node to elements, in compressed rows
+			struct NodeGraph
+			{
+				std::vector<int> element_offsets;
+				std::vector<int> element_nodes;
+				std::vector<int> node_offsets;
+				std::vector<int> node_elements;
+
+				// marks of the nodes already visited by for_each_neighbour, a new mark on every call
+				std::vector<int> stamp;
+				int stamp_id = 0;
+
+				NodeGraph(const std::vector<ElementBases> &bases, const int n_nodes)
+				{
+					const int n_elements = bases.size();
+
+					element_offsets.assign(n_elements + 1, 0);
+					for (int e = 0; e < n_elements; ++e)
+					{
+						std::vector<int> nodes;
+						for (const Basis &b : bases[e].bases)
+							for (const Local2Global &g : b.global())
+								nodes.push_back(g.index);
+						std::sort(nodes.begin(), nodes.end());
+						nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+
+						element_nodes.insert(element_nodes.end(), nodes.begin(), nodes.end());
+						element_offsets[e + 1] = element_nodes.size();
+					}
+
+					node_offsets.assign(n_nodes + 1, 0);
+					for (const int n : element_nodes)
+					{
+						assert(n >= 0 && n < n_nodes);
+						++node_offsets[n + 1];
+					}
+					std::partial_sum(node_offsets.begin(), node_offsets.end(), node_offsets.begin());
+
+					node_elements.resize(element_nodes.size());
+					std::vector<int> pos(node_offsets.begin(), node_offsets.end() - 1);
+					for (int e = 0; e < n_elements; ++e)
+						for (int k = element_offsets[e]; k < element_offsets[e + 1]; ++k)
+							node_elements[pos[element_nodes[k]]++] = e;
+
+					stamp.assign(n_nodes, 0);
+				}
+
+				// calls f on every neighbour of node once
+				template <typename Function>
+				void for_each_neighbour(const int node, Function &&f)
+				{
+					const int mark = ++stamp_id;
+					stamp[node] = mark;
+					for (int i = node_offsets[node]; i < node_offsets[node + 1]; ++i)
+					{
+						const int e = node_elements[i];
+						for (int k = element_offsets[e]; k < element_offsets[e + 1]; ++k)
+						{
+							const int other = element_nodes[k];
+							if (stamp[other] != mark)
+							{
+								stamp[other] = mark;
+								f(other);
+							}
+						}
+					}
+				}
+			};
+
+			// breadth first search from root, returns the number of levels and the nodes of the last one
+			int breadth_first_levels(NodeGraph &graph, const int root, std::vector<int> &level, std::vector<int> &last_level)
+			{
+				std::vector<int> queue = {root};
+				level[root] = 0;
+				for (size_t i = 0; i < queue.size(); ++i)
+				{
+					const int node = queue[i];
+					graph.for_each_neighbour(node, [&](const int other) {
+						if (level[other] < 0)
+						{
+							level[other] = level[node] + 1;
+							queue.push_back(other);
+						}
+					});
+				}
+
+				const int n_levels = level[queue.back()] + 1;
+				last_level.clear();
+				for (const int node : queue)
+				{
+					if (level[node] == n_levels - 1)
+						last_level.push_back(node);
+					level[node] = -1;
+				}
+
+				return n_levels;
+			}
+
+			// George-Liu search of a node far from all the others in the component of start
+			int pseudo_peripheral_node(NodeGraph &graph, const std::vector<int> &degree, const int start, std::vector<int> &level)
+			{
+				const auto min_degree = [&](const std::vector<int> &nodes) {
+					return *std::min_element(nodes.begin(), nodes.end(), [&](const int a, const int b) { return degree[a] < degree[b]; });
+				};
+
+				std::vector<int> last_level;
+				int root = start;
+				int n_levels = breadth_first_levels(graph, root, level, last_level);
+				while (true)
+				{
+					std::vector<int> candidate_last_level;
+					const int candidate = min_degree(last_level);
+					const int candidate_n_levels = breadth_first_levels(graph, candidate, level, candidate_last_level);
+					if (candidate_n_levels <= n_levels)
+						break;
+
+					root = candidate;
+					n_levels = candidate_n_levels;
+					last_level = std::move(candidate_last_level);
+				}
+
+				return root;
+			}
+
+			// spreads the bits of x so that there are stride - 1 zeros between them
+			uint64_t spread_bits(const uint64_t x, const int n_bits, const int stride)
+			{
+				uint64_t res = 0;
+				for (int b = 0; b < n_bits; ++b)
+					res |= ((x >> b) & 1ull) << (b * stride);
+				return res;
+			}
+
+			// position of every node, from the first basis that references it
+			Eigen::MatrixXd node_positions(const std::vector<ElementBases> &bases, const int n_nodes)
+			{
+				Eigen::MatrixXd pts;
+				std::vector<bool> found(n_nodes, false);
+				for (const ElementBases &bs : bases)
+				{
+					for (const Basis &b : bs.bases)
+					{
+						for (const Local2Global &g : b.global())
+						{
+							if (pts.size() == 0)
+								pts.setZero(n_nodes, g.node.size());
+							if (!found[g.index])
+							{
+								found[g.index] = true;
+								pts.row(g.index) = g.node;
+							}
+						}
+					}
+				}
+				return pts;
+			}
+		} // namespace
+
+		Eigen::VectorXi reverse_cuthill_mckee(const std::vector<ElementBases> &bases, const int n_nodes)
+		{
+			NodeGraph graph(bases, n_nodes);
+
+			std::vector<int> degree(n_nodes, 0);
+			for (int n = 0; n < n_nodes; ++n)
+				graph.for_each_neighbour(n, [&](const int) { ++degree[n]; });
+
+			std::vector<int> level(n_nodes, -1);
+			std::vector<bool> visited(n_nodes, false);
+			std::vector<int> order;
+			order.reserve(n_nodes);
+
+			// one Cuthill-McKee traversal per connected component
+			for (int start = 0; start < n_nodes; ++start)
+			{
+				if (visited[start])
+					continue;
+
+				const int root = pseudo_peripheral_node(graph, degree, start, level);
+				size_t first = order.size();
+				order.push_back(root);
+				visited[root] = true;
+
+				std::vector<int> neighbours;
+				for (; first < order.size(); ++first)
+				{
+					neighbours.clear();
+					graph.for_each_neighbour(order[first], [&](const int other) {
+						if (!visited[other])
+						{
+							visited[other] = true;
+							neighbours.push_back(other);
+						}
+					});
+					std::sort(neighbours.begin(), neighbours.end(), [&](const int a, const int b) {
+						return degree[a] < degree[b] || (degree[a] == degree[b] && a < b);
+					});
+					order.insert(order.end(), neighbours.begin(), neighbours.end());
+				}
+			}
+			assert(order.size() == n_nodes);
+
+			Eigen::VectorXi permutation(n_nodes);
+			for (int i = 0; i < n_nodes; ++i)
+				permutation[order[i]] = n_nodes - 1 - i;
+
+			return permutation;
+		}
+
+		Eigen::VectorXi morton_ordering(const std::vector<ElementBases> &bases, const int n_nodes)
+		{
+			const Eigen::MatrixXd pts = node_positions(bases, n_nodes);
+			if (pts.size() == 0)
+				return Eigen::VectorXi::LinSpaced(n_nodes, 0, n_nodes - 1);
+
+			const int dim = pts.cols();
+			const int n_bits = 64 / dim;
+			const double max_coord = double((1ull << n_bits) - 1);
+
+			const Eigen::RowVectorXd min = pts.colwise().minCoeff();
+			const Eigen::RowVectorXd extent = (pts.colwise().maxCoeff() - min).cwiseMax(1e-16);
+
+			std::vector<uint64_t> codes(n_nodes);
+			utils::maybe_parallel_for(n_nodes, [&](int start, int end, int thread_id) {
+				for (int n = start; n < end; ++n)
+				{
+					uint64_t code = 0;
+					for (int d = 0; d < dim; ++d)
+					{
+						const uint64_t q = uint64_t((pts(n, d) - min(d)) / extent(d) * max_coord);
+						code |= spread_bits(q, n_bits, dim) << d;
+					}
+					codes[n] = code;
+				}
+			});
+
+			std::vector<int> order(n_nodes);
+			std::iota(order.begin(), order.end(), 0);
+			std::sort(order.begin(), order.end(), [&](const int a, const int b) {
+				return codes[a] < codes[b] || (codes[a] == codes[b] && a < b);
+			});
+
+			Eigen::VectorXi permutation(n_nodes);
+			for (int i = 0; i < n_nodes; ++i)
+				permutation[order[i]] = i;
+
+			return permutation;
+		}
+
+		void permute_nodes(const Eigen::VectorXi &permutation, std::vector<ElementBases> &bases)
+		{
+			utils::maybe_parallel_for(bases.size(), [&](int start, int end, int thread_id) {
+				for (int e = start; e < end; ++e)
+				{
+					for (Basis &b : bases[e].bases)
+					{
+						for (Local2Global &g : b.global())
+						{
+							assert(g.index >= 0 && g.index < permutation.size());
+							g.index = permutation[g.index];
+						}
+					}
+				}
+			});
+		}
+
+		int nodes_bandwidth(const std::vector<ElementBases> &bases)
+		{
+			int bandwidth = 0;
+			for (const ElementBases &bs : bases)
+			{
+				int min = std::numeric_limits<int>::max();
+				int max = std::numeric_limits<int>::min();
+				for (const Basis &b : bs.bases)
+				{
+					for (const Local2Global &g : b.global())
+					{
+						min = std::min(min, g.index);
+						max = std::max(max, g.index);
+					}
+				}
+				if (max >= min)
+					bandwidth = std::max(bandwidth, max - min);
+			}
+			return bandwidth;
+		}
+	} // namespace basis
+} // namespace polyfem
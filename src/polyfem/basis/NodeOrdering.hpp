@@ -0,0 +1,38 @@
+#pragma once
+
+#include <polyfem/basis/ElementBases.hpp>
+
+#include <Eigen/Dense>
+
+#include <vector>
+
+namespace polyfem
+{
+	namespace basis
+	{
+		/// @brief Computes the reverse Cuthill-McKee ordering of the nodes of the bases, two nodes are neighbours if they share an element.
+		/// Reduces the bandwidth of the matrices and the fill of their factorizations.
+		///
+		/// @param[in] bases FE bases
+		/// @param[in] n_nodes number of nodes of the bases
+		/// @return permutation, new index of every node
+		Eigen::VectorXi reverse_cuthill_mckee(const std::vector<ElementBases> &bases, const int n_nodes);
+
+		/// @brief Orders the nodes of the bases along the Morton (Z-order) curve of their positions.
+		/// Nodes close in space get close indices, which improves the locality of the assembly and of the products.
+		///
+		/// @param[in] bases FE bases
+		/// @param[in] n_nodes number of nodes of the bases
+		/// @return permutation, new index of every node
+		Eigen::VectorXi morton_ordering(const std::vector<ElementBases> &bases, const int n_nodes);
+
+		/// @brief Renumbers the global indices of the bases
+		///
+		/// @param[in] permutation new index of every node
+		/// @param[in,out] bases FE bases
+		void permute_nodes(const Eigen::VectorXi &permutation, std::vector<ElementBases> &bases);
+
+		/// @brief Maximal difference between the indices of two nodes of the same element
+		int nodes_bandwidth(const std::vector<ElementBases> &bases);
+	} // namespace basis
+} // namespace polyfem
@@ -12,12 +12,16 @@
 #include "function/RBFWithQuadratic.hpp"
 #include "function/RBFWithQuadraticLagrange.hpp"
 #include <polyfem/utils/Logger.hpp>
+#include <polyfem/utils/MaybeParallelFor.hpp>
 
 #include <polyfem/autogen/auto_q_bases.hpp>
 
 #include <igl/per_vertex_normals.h>
-#include <random>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <random>
+#include <unordered_map>
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace polyfem
@@ -393,6 +397,111 @@ namespace polyfem
 				// std::cout << "volume: " << signed_volume(KV, KF) << std::endl;
 			}
 
+			// -----------------------------------------------------------------------------
+
+			template <typename T>
+			inline void hash_combine(size_t &seed, const T &v)
+			{
+				seed ^= std::hash<T>{}(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+			}
+
+			// Kernel centers, collocation points, and quadrature of a polyhedron, relative to the corner of its bounding box
+			struct PolyhedronShape
+			{
+				PolyhedronShape(const Eigen::MatrixXd &kernel_centers, const Eigen::MatrixXd &collocation_points, const Quadrature &quadrature)
+				{
+					origin = collocation_points.colwise().minCoeff();
+					centers = kernel_centers.rowwise() - origin;
+					samples = collocation_points.rowwise() - origin;
+					quadr.points = quadrature.points.rowwise() - origin;
+					quadr.weights = quadrature.weights;
+
+					const Eigen::RowVector3d extent = samples.colwise().maxCoeff();
+					tolerance = 1e-10 * extent.norm();
+
+					// congruent shapes have the same sizes and extent, the points are compared in matches
+					hash = 0;
+					hash_combine(hash, centers.rows());
+					hash_combine(hash, samples.rows());
+					hash_combine(hash, quadr.weights.size());
+					for (int d = 0; d < 3; ++d)
+						hash_combine(hash, std::llround(extent(d) / (1e-6 * extent.norm())));
+				}
+
+				bool matches(const PolyhedronShape &other) const
+				{
+					const auto close = [](const auto &a, const auto &b, const double tol) {
+						return a.rows() == b.rows() && a.cols() == b.cols() && (a.size() == 0 || (a - b).cwiseAbs().maxCoeff() <= tol);
+					};
+					return close(centers, other.centers, tolerance)
+						   && close(samples, other.samples, tolerance)
+						   && close(quadr.points, other.quadr.points, tolerance)
+						   && close(quadr.weights, other.quadr.weights, 1e-10 * quadr.weights.cwiseAbs().maxCoeff());
+				}
+
+				Eigen::RowVector3d origin;
+				Eigen::MatrixXd centers;
+				Eigen::MatrixXd samples;
+				Quadrature quadr;
+				double tolerance;
+				size_t hash;
+			};
+
+			// Geometric parts of the harmonic fits, shared by the polyhedra that are congruent up to a translation
+			class HarmonicFitCache
+			{
+			public:
+				using Fit = RBFWithQuadratic::ConstrainedFit;
+
+				// Returns the fit of a polyhedron congruent to shape. If there is none, compute fits this polyhedron
+				// and returns its fit, the other threads looking for the same shape wait for it.
+				template <typename Compute>
+				std::shared_ptr<const Fit> get(const PolyhedronShape &shape, Compute &&compute)
+				{
+					std::promise<std::shared_ptr<const Fit>> promise;
+					std::shared_future<std::shared_ptr<const Fit>> fit;
+					bool is_new = true;
+					{
+						std::lock_guard<std::mutex> lock(mutex_);
+						std::vector<Entry> &bucket = entries_[shape.hash];
+						for (const Entry &entry : bucket)
+						{
+							if (entry.shape.matches(shape))
+							{
+								fit = entry.fit;
+								is_new = false;
+								break;
+							}
+						}
+
+						if (is_new)
+						{
+							fit = promise.get_future().share();
+							bucket.push_back({shape, fit});
+							++n_shapes_;
+						}
+					}
+
+					if (is_new)
+						promise.set_value(compute());
+
+					return fit.get();
+				}
+
+				int n_shapes() const { return n_shapes_; }
+
+			private:
+				struct Entry
+				{
+					PolyhedronShape shape;
+					std::shared_future<std::shared_ptr<const Fit>> fit;
+				};
+
+				std::mutex mutex_;
+				std::unordered_map<size_t, std::vector<Entry>> entries_;
+				int n_shapes_ = 0;
+			};
+
 		} // anonymous namespace
 
 		////////////////////////////////////////////////////////////////////////////////
@@ -597,145 +706,178 @@ namespace polyfem
 			Eigen::MatrixXd basis_integrals;
 			compute_integral_constraints(assembler, mesh, n_bases, bases, gbases, basis_integrals);
 
-			// Step 2: Compute the rest =)
+			if (integral_constraints < 0 || integral_constraints > 2)
+			{
+				throw std::runtime_error(fmt::format("Unsupported constraint order: {:d}", integral_constraints));
+			}
+
+			std::vector<int> polytopes;
 			for (int e = 0; e < mesh.n_elements(); ++e)
 			{
-				if (!mesh.is_polytope(e))
+				if (mesh.is_polytope(e))
 				{
-					continue;
+					polytopes.push_back(e);
+					// the entries are created here, the parallel loop only assigns them
+					mapped_boundary[e];
 				}
-				// No boundary polytope
-				// assert(element_type[e] != ElementType::BOUNDARY_POLYTOPE);
+			}
 
-				// Kernel distance to polygon boundary
-				const double eps = compute_epsilon(mesh, e);
+			// congruent polyhedra (up to a translation) share the geometric part of the harmonic fit
+			HarmonicFitCache fit_cache;
 
+			// Step 2: Compute the rest =)
+			utils::maybe_parallel_for(int(polytopes.size()), [&](int start, int end, int thread_id) {
+				// scratch buffers of the thread
 				std::vector<int> local_to_global; // map local basis id (the ones that are nonzero on the polygon boundary) to global basis id
 				Eigen::MatrixXd collocation_points, kernel_centers, triangulated_vertices;
 				Eigen::MatrixXi triangulated_faces;
 				Eigen::MatrixXd rhs; // 1 row per collocation point, 1 column per basis that is nonzero on the polygon boundary
+				Eigen::MatrixXd local_basis_integrals;
 
-				ElementBases &b = bases[e];
-				b.has_parameterization = false;
-
-				Quadrature tmp_quadrature, tmp_mass_quadrature;
-				double scaling;
-				Eigen::RowVector3d translation;
-				sample_polyhedra(e, 2, n_kernels_per_edge, n_samples_per_edge,
-								 quadrature_order > 0 ? quadrature_order : AssemblerUtils::quadrature_order(assembler.name(), 2, AssemblerUtils::BasisType::POLY, 3),
-								 mass_quadrature_order > 0 ? mass_quadrature_order : AssemblerUtils::quadrature_order("Mass", 2, AssemblerUtils::BasisType::POLY, 3),
-								 mesh, poly_face_to_data, bases, gbases, eps, local_to_global,
-								 collocation_points, kernel_centers, rhs, triangulated_vertices,
-								 triangulated_faces, tmp_quadrature, tmp_mass_quadrature, scaling, translation);
-
-				b.set_quadrature([tmp_quadrature](Quadrature &quad) { quad = tmp_quadrature; });
-				b.set_mass_quadrature([tmp_mass_quadrature](Quadrature &quad) { quad = tmp_mass_quadrature; });
-				// b.scaling_ = scaling;
-				// b.translation_ = translation;
-
-				// igl::opengl::glfw::Viewer & viewer = UIState::ui_state().viewer;
-				// viewer.data().clear();
-				// viewer.data().set_mesh(triangulated_vertices, triangulated_faces);
-				// viewer.data().add_points(kernel_centers, Eigen::Vector3d(0,1,1).transpose());
-				// add_spheres(viewer, kernel_centers, 0.005);
-
-				// Eigen::MatrixXd pts = triangulated_vertices, normals;
-				// Eigen::MatrixXi tris = triangulated_faces;
-				// igl::per_corner_normals(pts, tris, 20, normals);
-				// viewer.data().set_normals(normals);
-				// viewer.data().set_face_based(false);
-				// viewer.launch();
-
-				// for(int a = 0; rhs.cols();++a)
-				// 	{
-				// 	igl::opengl::glfw::Viewer viewer;
-				// 	Eigen::MatrixXd asd(collocation_points.rows(), 3);
-				// 	asd.col(0)=collocation_points.col(0);
-				// 	asd.col(1)=collocation_points.col(1);
-				// 	asd.col(2)=collocation_points.col(2);
-				// 	Eigen::VectorXd S = rhs.col(a);
-				// 	Eigen::MatrixXd C;
-				// 	igl::colormap(igl::COLOR_MAP_TYPE_VIRIDIS, S, true, C);
-				// 	viewer.data().add_points(asd, C);
-				// 	viewer.launch();
-				// }
-
-				// for(int asd = 0; asd < collocation_points.rows(); ++asd) {
-				//     viewer.data().add_label(collocation_points.row(asd), std::to_string(asd));
-				// }
-
-				// Compute the weights of the RBF kernels
-				Eigen::MatrixXd local_basis_integrals(rhs.cols(), basis_integrals.cols());
-				for (long k = 0; k < rhs.cols(); ++k)
-				{
-					local_basis_integrals.row(k) = -basis_integrals.row(local_to_global[k]);
-				}
-				auto set_rbf = [&b](auto rbf) {
-					b.set_bases_func([rbf](const Eigen::MatrixXd &uv, std::vector<AssemblyValues> &val) {
-						Eigen::MatrixXd tmp;
-						rbf->bases_values(uv, tmp);
-						val.resize(tmp.cols());
-						assert(tmp.rows() == uv.rows());
-
-						for (size_t i = 0; i < tmp.cols(); ++i)
-						{
-							val[i].val = tmp.col(i);
-						}
-					});
-					b.set_grads_func([rbf](const Eigen::MatrixXd &uv, std::vector<AssemblyValues> &val) {
-						Eigen::MatrixXd tmpx, tmpy, tmpz;
-
-						rbf->bases_grads(0, uv, tmpx);
-						rbf->bases_grads(1, uv, tmpy);
-						rbf->bases_grads(2, uv, tmpz);
-
-						val.resize(tmpx.cols());
-						assert(tmpx.cols() == tmpy.cols());
-						assert(tmpx.cols() == tmpz.cols());
-						assert(tmpx.rows() == uv.rows());
-						for (size_t i = 0; i < tmpx.cols(); ++i)
-						{
-							val[i].grad.resize(uv.rows(), uv.cols());
-							val[i].grad.col(0) = tmpx.col(i);
-							val[i].grad.col(1) = tmpy.col(i);
-							val[i].grad.col(2) = tmpz.col(i);
-						}
-					});
-				};
-				if (integral_constraints == 0)
-				{
-					set_rbf(std::make_shared<RBFWithLinear>(
-						kernel_centers, collocation_points, local_basis_integrals, tmp_quadrature, rhs, false));
-				}
-				else if (integral_constraints == 1)
-				{
-					set_rbf(std::make_shared<RBFWithLinear>(
-						kernel_centers, collocation_points, local_basis_integrals, tmp_quadrature, rhs));
-				}
-				else if (integral_constraints == 2)
-				{
-					set_rbf(std::make_shared<RBFWithQuadratic>(
-						// set_rbf(std::make_shared<RBFWithQuadraticLagrange>(
-						assembler, kernel_centers, collocation_points, local_basis_integrals, tmp_quadrature, rhs));
-				}
-				else
+				for (int p = start; p < end; ++p)
 				{
-					throw std::runtime_error(fmt::format("Unsupported constraint order: {:d}", integral_constraints));
-				}
+					const int e = polytopes[p];
+					// No boundary polytope
+					// assert(element_type[e] != ElementType::BOUNDARY_POLYTOPE);
+
+					// Kernel distance to polygon boundary
+					const double eps = compute_epsilon(mesh, e);
+
+					ElementBases &b = bases[e];
+					b.has_parameterization = false;
+
+					Quadrature tmp_quadrature, tmp_mass_quadrature;
+					double scaling;
+					Eigen::RowVector3d translation;
+					sample_polyhedra(e, 2, n_kernels_per_edge, n_samples_per_edge,
+									 quadrature_order > 0 ? quadrature_order : AssemblerUtils::quadrature_order(assembler.name(), 2, AssemblerUtils::BasisType::POLY, 3),
+									 mass_quadrature_order > 0 ? mass_quadrature_order : AssemblerUtils::quadrature_order("Mass", 2, AssemblerUtils::BasisType::POLY, 3),
+									 mesh, poly_face_to_data, bases, gbases, eps, local_to_global,
+									 collocation_points, kernel_centers, rhs, triangulated_vertices,
+									 triangulated_faces, tmp_quadrature, tmp_mass_quadrature, scaling, translation);
+
+					b.set_quadrature([tmp_quadrature](Quadrature &quad) { quad = tmp_quadrature; });
+					b.set_mass_quadrature([tmp_mass_quadrature](Quadrature &quad) { quad = tmp_mass_quadrature; });
+					// b.scaling_ = scaling;
+					// b.translation_ = translation;
+
+					// igl::opengl::glfw::Viewer & viewer = UIState::ui_state().viewer;
+					// viewer.data().clear();
+					// viewer.data().set_mesh(triangulated_vertices, triangulated_faces);
+					// viewer.data().add_points(kernel_centers, Eigen::Vector3d(0,1,1).transpose());
+					// add_spheres(viewer, kernel_centers, 0.005);
+
+					// Eigen::MatrixXd pts = triangulated_vertices, normals;
+					// Eigen::MatrixXi tris = triangulated_faces;
+					// igl::per_corner_normals(pts, tris, 20, normals);
+					// viewer.data().set_normals(normals);
+					// viewer.data().set_face_based(false);
+					// viewer.launch();
+
+					// for(int a = 0; rhs.cols();++a)
+					// 	{
+					// 	igl::opengl::glfw::Viewer viewer;
+					// 	Eigen::MatrixXd asd(collocation_points.rows(), 3);
+					// 	asd.col(0)=collocation_points.col(0);
+					// 	asd.col(1)=collocation_points.col(1);
+					// 	asd.col(2)=collocation_points.col(2);
+					// 	Eigen::VectorXd S = rhs.col(a);
+					// 	Eigen::MatrixXd C;
+					// 	igl::colormap(igl::COLOR_MAP_TYPE_VIRIDIS, S, true, C);
+					// 	viewer.data().add_points(asd, C);
+					// 	viewer.launch();
+					// }
+
+					// for(int asd = 0; asd < collocation_points.rows(); ++asd) {
+					//     viewer.data().add_label(collocation_points.row(asd), std::to_string(asd));
+					// }
+
+					// Compute the weights of the RBF kernels
+					local_basis_integrals.resize(rhs.cols(), basis_integrals.cols());
+					for (long k = 0; k < rhs.cols(); ++k)
+					{
+						local_basis_integrals.row(k) = -basis_integrals.row(local_to_global[k]);
+					}
+					// the rbf is evaluated relative to origin
+					auto set_rbf = [&b](auto rbf, const Eigen::RowVector3d &origin) {
+						b.set_bases_func([rbf, origin](const Eigen::MatrixXd &uv, std::vector<AssemblyValues> &val) {
+							Eigen::MatrixXd tmp;
+							rbf->bases_values(uv.rowwise() - origin, tmp);
+							val.resize(tmp.cols());
+							assert(tmp.rows() == uv.rows());
+
+							for (size_t i = 0; i < tmp.cols(); ++i)
+							{
+								val[i].val = tmp.col(i);
+							}
+						});
+						b.set_grads_func([rbf, origin](const Eigen::MatrixXd &uv, std::vector<AssemblyValues> &val) {
+							Eigen::MatrixXd tmpx, tmpy, tmpz;
+
+							const Eigen::MatrixXd local_uv = uv.rowwise() - origin;
+							rbf->bases_grads(0, local_uv, tmpx);
+							rbf->bases_grads(1, local_uv, tmpy);
+							rbf->bases_grads(2, local_uv, tmpz);
+
+							val.resize(tmpx.cols());
+							assert(tmpx.cols() == tmpy.cols());
+							assert(tmpx.cols() == tmpz.cols());
+							assert(tmpx.rows() == uv.rows());
+							for (size_t i = 0; i < tmpx.cols(); ++i)
+							{
+								val[i].grad.resize(uv.rows(), uv.cols());
+								val[i].grad.col(0) = tmpx.col(i);
+								val[i].grad.col(1) = tmpy.col(i);
+								val[i].grad.col(2) = tmpz.col(i);
+							}
+						});
+					};
+					if (integral_constraints == 0)
+					{
+						set_rbf(std::make_shared<RBFWithLinear>(
+							kernel_centers, collocation_points, local_basis_integrals, tmp_quadrature, rhs, false),
+								Eigen::RowVector3d::Zero());
+					}
+					else if (integral_constraints == 1)
+					{
+						set_rbf(std::make_shared<RBFWithLinear>(
+							kernel_centers, collocation_points, local_basis_integrals, tmp_quadrature, rhs),
+								Eigen::RowVector3d::Zero());
+					}
+					else
+					{
+						// the fit is done relative to the corner of the polyhedron, so that congruent polyhedra share it
+						const PolyhedronShape shape(kernel_centers, collocation_points, tmp_quadrature);
+						RBFWithQuadratic::translate_integral_constraints_3d(shape.origin, local_basis_integrals);
+
+						std::shared_ptr<RBFWithQuadratic> rbf;
+						std::shared_ptr<const RBFWithQuadratic::ConstrainedFit> fit = fit_cache.get(shape, [&]() {
+							std::shared_ptr<const RBFWithQuadratic::ConstrainedFit> new_fit;
+							rbf = std::make_shared<RBFWithQuadratic>(shape.centers, shape.samples, local_basis_integrals, shape.quadr, rhs, new_fit);
+							return new_fit;
+						});
+						if (!rbf)
+							rbf = std::make_shared<RBFWithQuadratic>(shape.centers, shape.samples, local_basis_integrals, shape.quadr, rhs, fit);
+						set_rbf(rbf, shape.origin);
+					}
 
-				// Set the bases which are nonzero inside the polygon
-				const int n_poly_bases = int(local_to_global.size());
-				b.bases.resize(n_poly_bases);
-				for (int i = 0; i < n_poly_bases; ++i)
-				{
-					b.bases[i].init(-2, local_to_global[i], i, Eigen::MatrixXd::Constant(1, 3, std::nan("")));
+					// Set the bases which are nonzero inside the polygon
+					const int n_poly_bases = int(local_to_global.size());
+					b.bases.resize(n_poly_bases);
+					for (int i = 0; i < n_poly_bases; ++i)
+					{
+						b.bases[i].init(-2, local_to_global[i], i, Eigen::MatrixXd::Constant(1, 3, std::nan("")));
+					}
+
+					// Polygon boundary after geometric mapping from neighboring elements
+					orient_closed_surface(triangulated_vertices, triangulated_faces, false); // stupid viewer is flipping all the faces
+					auto &boundary = mapped_boundary.at(e);
+					boundary.first = triangulated_vertices;
+					boundary.second = triangulated_faces;
 				}
+			});
 
-				// Polygon boundary after geometric mapping from neighboring elements
-				orient_closed_surface(triangulated_vertices, triangulated_faces, false); // stupid viewer is flipping all the faces
-				mapped_boundary[e].first = triangulated_vertices;
-				mapped_boundary[e].second = triangulated_faces;
-			}
+			logger().debug("Harmonic bases of {} polyhedra fitted with {} shapes", polytopes.size(), fit_cache.n_shapes());
 
 			return 0;
 		}
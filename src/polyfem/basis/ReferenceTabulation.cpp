@@ -0,0 +1,70 @@
+#include "ReferenceTabulation.hpp"
+
+#include <polyfem/basis/ElementBases.hpp>
+
+namespace polyfem
+{
+	using namespace assembler;
+
+	namespace basis
+	{
+		const ReferenceTabulation::Table *ReferenceTabulation::find(const Eigen::MatrixXd &uv) const
+		{
+			for (const Table &table : tables_)
+			{
+				if (table.points.rows() == uv.rows() && table.points.cols() == uv.cols() && table.points == uv)
+					return &table;
+			}
+			return nullptr;
+		}
+
+		void ReferenceTabulation::add_points(const ElementBases &bases, const Eigen::MatrixXd &uv)
+		{
+			if (find(uv) != nullptr)
+				return;
+
+			const int n_bases = bases.bases.size();
+			const int dim = uv.cols();
+
+			Table table;
+			table.points = uv;
+			table.data.resize(uv.rows(), n_bases * (1 + dim));
+
+			Eigen::MatrixXd tmp;
+			for (int j = 0; j < n_bases; ++j)
+			{
+				bases.bases[j].eval_basis(uv, tmp);
+				assert(tmp.size() == uv.rows());
+				table.data.col(j) = tmp;
+
+				bases.bases[j].eval_grad(uv, tmp);
+				assert(tmp.rows() == uv.rows() && tmp.cols() == dim);
+				table.data.middleCols(n_bases + j * dim, dim) = tmp;
+			}
+
+			tables_.push_back(std::move(table));
+		}
+
+		bool ReferenceTabulation::evaluate(const ElementBases &bases, const Eigen::MatrixXd &uv, const bool grads, std::vector<AssemblyValues> &basis_values) const
+		{
+			const Table *table = find(uv);
+			if (table == nullptr)
+				return false;
+
+			const int n_bases = bases.bases.size();
+			const int dim = uv.cols();
+
+			assert(table->data.cols() == n_bases * (1 + dim));
+			basis_values.resize(n_bases);
+			for (int j = 0; j < n_bases; ++j)
+			{
+				if (grads)
+					basis_values[j].grad = table->data.middleCols(n_bases + j * dim, dim);
+				else
+					basis_values[j].val = table->data.col(j);
+			}
+
+			return true;
+		}
+	} // namespace basis
+} // namespace polyfem
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <polyfem/assembler/AssemblyValues.hpp>
+
+#include <Eigen/Dense>
+
+#include <vector>
+
+namespace polyfem
+{
+	namespace basis
+	{
+		class ElementBases;
+
+		/// @brief Values and gradients of the local bases of a reference element, shared by all the elements using the same bases.
+		///
+		/// The bases are evaluated once per registered set of points (the quadrature points of the elements), and stored in a single
+		/// block: the first n_bases columns are the values, followed by dim columns per basis for the gradients.
+		/// Only valid for bases that do not depend on the element, e.g., Lagrange bases on the reference simplex or cube.
+		/// The sets of points are registered while building the bases, the evaluations afterwards only read the tables without locking.
+		class ReferenceTabulation
+		{
+		public:
+			/// @brief Tabulate the bases at uv, if they are not already. Not thread safe, it must not run concurrently with evaluate
+			/// @param[in] bases bases of the element, used to tabulate
+			/// @param[in] uv #uv x dim points in the reference element
+			void add_points(const ElementBases &bases, const Eigen::MatrixXd &uv);
+
+			/// @brief Evaluate the bases at uv from the tabulated values
+			/// @param[in] bases bases of the element
+			/// @param[in] uv #uv x dim points in the reference element
+			/// @param[in] grads if true, set the gradients, otherwise the values
+			/// @param[out] basis_values values or gradients of the bases
+			/// @return false if the points are not tabulated, then the caller needs to evaluate the bases
+			bool evaluate(const ElementBases &bases, const Eigen::MatrixXd &uv, const bool grads, std::vector<assembler::AssemblyValues> &basis_values) const;
+
+			/// @brief Number of tabulated sets of points
+			int size() const { return tables_.size(); }
+
+		private:
+			struct Table
+			{
+				Eigen::MatrixXd points;
+				Eigen::MatrixXd data; // #points x (n_bases * (1 + dim))
+			};
+
+			/// @brief Find the table of the points uv, nullptr if there is none
+			const Table *find(const Eigen::MatrixXd &uv) const;
+
+			std::vector<Table> tables_;
+		};
+	} // namespace basis
+} // namespace polyfem
@@ -12,6 +12,7 @@
 #include <iostream>
 #include <fstream>
 #include <array>
+#include <memory>
 ////////////////////////////////////////////////////////////////////////////////
 
 // #define VERBOSE
@@ -196,6 +197,50 @@ RBFWithQuadratic::RBFWithQuadratic(
 	compute_weights(assembler, collocation_points, local_basis_integral, quadr, rhs, with_constraints);
 }
 
+void RBFWithQuadratic::translate_integral_constraints_3d(const Eigen::RowVector3d &origin, Eigen::MatrixXd &local_basis_integral)
+{
+	assert(local_basis_integral.cols() == 9);
+	Eigen::MatrixXd &I = local_basis_integral;
+	I.col(3) -= origin(1) * I.col(0) + origin(0) * I.col(1); // xy
+	I.col(4) -= origin(2) * I.col(1) + origin(1) * I.col(2); // yz
+	I.col(5) -= origin(2) * I.col(0) + origin(0) * I.col(2); // zx
+	for (int d = 0; d < 3; ++d)
+		I.col(6 + d) -= 2 * origin(d) * I.col(d); // x^2, y^2, z^2
+}
+
+// -----------------------------------------------------------------------------
+
+RBFWithQuadratic::RBFWithQuadratic(
+	const Eigen::MatrixXd &centers,
+	const Eigen::MatrixXd &collocation_points,
+	const Eigen::MatrixXd &local_basis_integral,
+	const Quadrature &quadr,
+	const Eigen::MatrixXd &rhs,
+	std::shared_ptr<const ConstrainedFit> &fit)
+	: centers_(centers)
+{
+	assert(is_volume());
+	if (!fit)
+	{
+		auto new_fit = std::make_shared<ConstrainedFit>();
+		compute_kernels_matrix(collocation_points, new_fit->A);
+		compute_constraints_matrix_3d(quadr, new_fit->L, new_fit->moments);
+		new_fit->ldlt = (new_fit->L.transpose() * new_fit->A.transpose() * new_fit->A * new_fit->L).ldlt();
+		if (new_fit->ldlt.info() == Eigen::NumericalIssue)
+		{
+			logger().error("-- WARNING: Numerical issues when solving the harmonic least square.");
+		}
+		fit = new_fit;
+	}
+	assert(fit->A.rows() == rhs.rows());
+
+	// Same as compute_weights, with the geometric part of the system already factorized
+	weights_.setZero(fit->L.rows(), rhs.cols());
+	weights_.bottomRows(9) = fit->moments.solve(local_basis_integral.transpose());
+	const Eigen::MatrixXd b = rhs - fit->A * weights_;
+	weights_ += fit->L * fit->ldlt.solve(fit->L.transpose() * fit->A.transpose() * b);
+}
+
 // -----------------------------------------------------------------------------
 
 void RBFWithQuadratic::basis(const int local_index, const Eigen::MatrixXd &samples, Eigen::MatrixXd &val) const
@@ -616,11 +661,28 @@ void RBFWithQuadratic::compute_constraints_matrix_3d(
 	const Eigen::MatrixXd &local_basis_integral,
 	Eigen::MatrixXd &L,
 	Eigen::MatrixXd &t) const
+{
+	assert(local_basis_integral.cols() == 9);
+
+	Eigen::FullPivLU<Eigen::Matrix<double, 9, 9>> lu;
+	compute_constraints_matrix_3d(quadr, L, lu);
+
+	// Compute t
+	t.resize(L.rows(), num_bases);
+	t.setZero();
+	t.bottomRows(9) = lu.solve(local_basis_integral.transpose());
+}
+
+// -----------------------------------------------------------------------------
+
+void RBFWithQuadratic::compute_constraints_matrix_3d(
+	const Quadrature &quadr,
+	Eigen::MatrixXd &L,
+	Eigen::FullPivLU<Eigen::Matrix<double, 9, 9>> &lu) const
 {
 	const int num_kernels = centers_.rows();
 	const int dim = centers_.cols();
 	assert(dim == 3);
-	assert(local_basis_integral.cols() == 9);
 
 	// K_cst = ∫ψ_k
 	// K_lin = ∫∇x(ψ_k), ∫∇y(ψ_k), ∫∇z(ψ_k)
@@ -684,7 +746,7 @@ void RBFWithQuadratic::compute_constraints_matrix_3d(
 	M_rhs.segment<3>(6) = I_sqr;
 	// M_rhs << I_lin, I_mix, I_sqr;
 	M.bottomRows(dim).rowwise() += 2.0 * M_rhs;
-	Eigen::FullPivLU<Eigen::Matrix<double, 9, 9>> lu(M);
+	lu.compute(M);
 	assert(lu.isInvertible());
 
 	// show_matrix_stats(M);
@@ -699,12 +761,6 @@ void RBFWithQuadratic::compute_constraints_matrix_3d(
 	L.bottomRightCorner(dim, 1).setConstant(-2.0 * volume);
 	L.block(num_kernels + 1, 0, 9, num_kernels + 1) = lu.solve(L.block(num_kernels + 1, 0, 9, num_kernels + 1));
 	// std::cout << L.bottomRightCorner(10, 10) << std::endl;
-
-	// Compute t
-	t.resize(L.rows(), num_bases);
-	t.setZero();
-	t.bottomRows(9) = local_basis_integral.transpose();
-	t.bottomRows(9) = lu.solve(weights_.bottomRows(9));
 }
 
 // -----------------------------------------------------------------------------
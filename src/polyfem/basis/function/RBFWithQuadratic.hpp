@@ -6,6 +6,8 @@
 
 #include <Eigen/Dense>
 
+#include <memory>
+
 namespace polyfem
 {
 	namespace basis
@@ -35,6 +37,45 @@ namespace polyfem
 							 const Eigen::MatrixXd &local_basis_integral, const quadrature::Quadrature &quadr,
 							 Eigen::MatrixXd &rhs, bool with_constraints = true);
 
+			///
+			/// @brief      Geometric part of the constrained least square fit of a polyhedron. It only depends on the kernel
+			///             centers, the collocation points, and the quadrature, so it can be shared by congruent polyhedra.
+			///
+			struct ConstrainedFit
+			{
+				// #S x (#C + 1 + dim + dim*(dim+1)/2) kernels and monomials evaluated on the collocation points
+				Eigen::MatrixXd A;
+				// the weights are w = L v + t, where t only depends on the integral constraints
+				Eigen::MatrixXd L;
+				// moments of the monomials over the polyhedron, maps the integral constraints to t
+				Eigen::FullPivLU<Eigen::Matrix<double, 9, 9>> moments;
+				// factorization of the normal equations of the least square in v
+				Eigen::LDLT<Eigen::MatrixXd> ldlt;
+			};
+
+			///
+			/// @brief      Rewrites the integral constraints of a polyhedron for the monomials centered at origin, the translation
+			///             only adds multiples of the linear constraints to the quadratic ones
+			///
+			/// @param[in]      origin                 Origin of the monomials
+			/// @param[in,out]  local_basis_integral   #B x 9 integral constraints
+			///
+			static void translate_integral_constraints_3d(const Eigen::RowVector3d &origin, Eigen::MatrixXd &local_basis_integral);
+
+			///
+			/// @brief      Initialize RBF functions over a polyhedron with the integral constraints, reusing the geometric part of the fit.
+			///
+			/// @param[in]      centers                #C x 3 positions of the kernels
+			/// @param[in]      collocation_points     #S x 3 positions of the collocation points
+			/// @param[in]      local_basis_integral   #B x 9 of the constant right-hand side for the integral constraint for each basis over the polytope
+			/// @param[in]      quadr                  Quadrature points and weights inside the polytope
+			/// @param[in]      rhs                    #S x #B of boundary conditions
+			/// @param[in,out]  fit                    Geometric part of the fit, computed from centers, collocation_points, and quadr if null
+			///
+			RBFWithQuadratic(const Eigen::MatrixXd &centers, const Eigen::MatrixXd &collocation_points,
+							 const Eigen::MatrixXd &local_basis_integral, const quadrature::Quadrature &quadr,
+							 const Eigen::MatrixXd &rhs, std::shared_ptr<const ConstrainedFit> &fit);
+
 			///
 			/// @brief      Evaluates one RBF function over a list of coordinates
 			///
@@ -88,6 +129,9 @@ namespace polyfem
 			void compute_constraints_matrix_3d(const assembler::LinearAssembler &assembler, const int num_bases, const quadrature::Quadrature &quadr,
 											   const Eigen::MatrixXd &local_basis_integral, Eigen::MatrixXd &L, Eigen::MatrixXd &t) const;
 
+			// Computes L and the factorized moments of the monomials, from which t = lu^-1 local_basis_integral^T
+			void compute_constraints_matrix_3d(const quadrature::Quadrature &quadr, Eigen::MatrixXd &L, Eigen::FullPivLU<Eigen::Matrix<double, 9, 9>> &lu) const;
+
 			// Computes the weights by solving a (possibly constrained) linear least square
 			void compute_weights(const assembler::LinearAssembler &assembler, const Eigen::MatrixXd &collocation_points,
 								 const Eigen::MatrixXd &local_basis_integral, const quadrature::Quadrature &quadr,
@@ -0,0 +1,92 @@
+#include "AsyncOutputQueue.hpp"
+
+#include <polyfem/utils/Logger.hpp>
+
+namespace polyfem::io
+{
+	AsyncOutputQueue::AsyncOutputQueue(const int max_pending)
+		: max_pending_(max_pending)
+	{
+		if (is_async())
+			thread_ = std::thread(&AsyncOutputQueue::run, this);
+	}
+
+	AsyncOutputQueue::~AsyncOutputQueue()
+	{
+		if (!is_async())
+			return;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			stop_ = true;
+		}
+		not_empty_.notify_all();
+		thread_.join();
+	}
+
+	void AsyncOutputQueue::push(std::function<void()> task)
+	{
+		if (!is_async())
+		{
+			run_task(task);
+			return;
+		}
+
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			not_full_.wait(lock, [&] { return tasks_.size() < size_t(max_pending_); });
+			tasks_.push_back(std::move(task));
+		}
+		not_empty_.notify_one();
+	}
+
+	void AsyncOutputQueue::flush()
+	{
+		if (!is_async())
+			return;
+
+		std::unique_lock<std::mutex> lock(mutex_);
+		done_.wait(lock, [&] { return tasks_.empty() && !running_task_; });
+	}
+
+	void AsyncOutputQueue::run()
+	{
+		while (true)
+		{
+			std::function<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				// the remaining tasks are run before stopping, so no output is lost
+				not_empty_.wait(lock, [&] { return stop_ || !tasks_.empty(); });
+				if (tasks_.empty())
+					return;
+
+				task = std::move(tasks_.front());
+				tasks_.pop_front();
+				running_task_ = true;
+			}
+			not_full_.notify_one();
+
+			run_task(task);
+
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				running_task_ = false;
+			}
+			done_.notify_all();
+		}
+	}
+
+	void AsyncOutputQueue::run_task(const std::function<void()> &task)
+	{
+		// an output failure should not stop the simulation
+		try
+		{
+			task();
+		}
+		catch (const std::exception &e)
+		{
+			logger().error("Failed to write output: {}", e.what());
+		}
+	}
+} // namespace polyfem::io
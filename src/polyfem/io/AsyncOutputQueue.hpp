@@ -0,0 +1,51 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace polyfem::io
+{
+	/// Runs output tasks (e.g., writing the files of a time step) on a background thread, in the order they are pushed.
+	/// The number of pending tasks is bounded, pushing blocks until the writer catches up so that the
+	/// queued frames do not accumulate in memory.
+	class AsyncOutputQueue
+	{
+	public:
+		/// @param max_pending maximum number of tasks waiting to be run, if <= 0 the tasks are run synchronously by push
+		explicit AsyncOutputQueue(const int max_pending);
+		~AsyncOutputQueue();
+
+		AsyncOutputQueue(const AsyncOutputQueue &) = delete;
+		AsyncOutputQueue &operator=(const AsyncOutputQueue &) = delete;
+
+		/// @brief Queue a task, blocks while the queue is full
+		/// @param task task to run, it must own all the data it uses
+		void push(std::function<void()> task);
+
+		/// @brief Block until all the pushed tasks have been run
+		void flush();
+
+		/// @brief Check if the tasks are run on a background thread
+		bool is_async() const { return max_pending_ > 0; }
+
+	private:
+		void run();
+		static void run_task(const std::function<void()> &task);
+
+		const int max_pending_;
+
+		std::mutex mutex_;
+		std::condition_variable not_empty_;
+		std::condition_variable not_full_;
+		std::condition_variable done_;
+
+		std::deque<std::function<void()>> tasks_;
+		bool running_task_ = false;
+		bool stop_ = false;
+
+		std::thread thread_;
+	};
+} // namespace polyfem::io
@@ -14,10 +14,13 @@
 #include <polyfem/autogen/auto_q_bases.hpp>
 
 #include <polyfem/utils/Logger.hpp>
+#include <polyfem/utils/MaybeParallelFor.hpp>
 
 #include <igl/AABB.h>
 #include <igl/per_face_normals.h>
 
+#include <numeric>
+
 namespace polyfem::io
 {
 	using namespace mesh;
@@ -168,9 +171,6 @@ namespace polyfem::io
 
 		const Mesh3D &mesh3d = dynamic_cast<const Mesh3D &>(mesh);
 
-		Eigen::MatrixXd points, uv;
-		Eigen::VectorXd weights;
-
 		int actual_dim = 1;
 		if (!is_problem_scalar)
 			actual_dim = 3;
@@ -181,67 +181,66 @@ namespace polyfem::io
 		result.resize(faces.rows(), actual_dim);
 		result.setConstant(std::numeric_limits<double>::quiet_NaN());
 
-		int counter = 0;
+		// every boundary face is written by a single element
+		std::vector<int> counter(mesh3d.n_elements(), 0);
 
-		for (int e = 0; e < mesh3d.n_elements(); ++e)
-		{
-			const basis::ElementBases &gbs = gbases[e];
-			const basis::ElementBases &bs = bases[e];
+		utils::maybe_parallel_for(mesh3d.n_elements(), [&](int start, int end, int thread_id) {
+			Eigen::MatrixXd points, uv;
+			Eigen::VectorXd weights;
+			ElementAssemblyValues vals;
 
-			for (int lf = 0; lf < mesh3d.n_cell_faces(e); ++lf)
+			for (int e = start; e < end; ++e)
 			{
-				const int face_id = mesh3d.cell_face(e, lf);
-				if (!mesh3d.is_boundary_face(face_id))
-					continue;
+				const basis::ElementBases &gbs = gbases[e];
+				const basis::ElementBases &bs = bases[e];
 
-				if (mesh3d.is_simplex(e))
-					utils::BoundarySampler::quadrature_for_tri_face(lf, 4, face_id, mesh3d, uv, points, weights);
-				else if (mesh3d.is_cube(e))
-					utils::BoundarySampler::quadrature_for_quad_face(lf, 4, face_id, mesh3d, uv, points, weights);
-				else
-					assert(false);
-
-				ElementAssemblyValues vals;
-				vals.compute(e, true, points, bs, gbs);
-				RowVectorNd loc_val(actual_dim);
-				loc_val.setZero();
+				for (int lf = 0; lf < mesh3d.n_cell_faces(e); ++lf)
+				{
+					const int face_id = mesh3d.cell_face(e, lf);
+					if (!mesh3d.is_boundary_face(face_id))
+						continue;
 
-				// UIEvaluator::ui_state().debug_data().add_points(vals.val, Eigen::RowVector3d(1,0,0));
+					if (mesh3d.is_simplex(e))
+						utils::BoundarySampler::quadrature_for_tri_face(lf, 4, face_id, mesh3d, uv, points, weights);
+					else if (mesh3d.is_cube(e))
+						utils::BoundarySampler::quadrature_for_quad_face(lf, 4, face_id, mesh3d, uv, points, weights);
+					else
+						assert(false);
 
-				// const auto nodes = bs.local_nodes_for_primitive(face_id, mesh3d);
+					vals.compute(e, true, points, bs, gbs);
+					RowVectorNd loc_val(actual_dim);
+					loc_val.setZero();
 
-				// for(long n = 0; n < nodes.size(); ++n)
-				for (size_t j = 0; j < bs.bases.size(); ++j)
-				{
-					// const auto &b = bs.bases[nodes(n)];
-					// const AssemblyValues &v = vals.basis_values[nodes(n)];
-					const AssemblyValues &v = vals.basis_values[j];
-					for (int d = 0; d < actual_dim; ++d)
+					for (size_t j = 0; j < bs.bases.size(); ++j)
 					{
-						for (size_t g = 0; g < v.global.size(); ++g)
+						const AssemblyValues &v = vals.basis_values[j];
+						for (int d = 0; d < actual_dim; ++d)
 						{
-							loc_val(d) += (v.global[g].val * v.val.array() * fun(v.global[g].index * actual_dim + d) * weights.array()).sum();
+							for (size_t g = 0; g < v.global.size(); ++g)
+							{
+								loc_val(d) += (v.global[g].val * v.val.array() * fun(v.global[g].index * actual_dim + d) * weights.array()).sum();
+							}
 						}
 					}
-				}
 
-				int I;
-				Eigen::RowVector3d C;
-				const Eigen::RowVector3d bary = mesh3d.face_barycenter(face_id);
+					int I;
+					Eigen::RowVector3d C;
+					const Eigen::RowVector3d bary = mesh3d.face_barycenter(face_id);
 
-				const double dist = tree.squared_distance(pts, faces, bary, I, C);
-				assert(dist < 1e-16);
+					const double dist = tree.squared_distance(pts, faces, bary, I, C);
+					assert(dist < 1e-16);
 
-				assert(std::isnan(result(I, 0)));
-				if (compute_avg)
-					result.row(I) = loc_val / weights.sum();
-				else
-					result.row(I) = loc_val;
-				++counter;
+					assert(std::isnan(result(I, 0)));
+					if (compute_avg)
+						result.row(I) = loc_val / weights.sum();
+					else
+						result.row(I) = loc_val;
+					++counter[e];
+				}
 			}
-		}
+		});
 
-		assert(counter == result.rows());
+		assert(std::accumulate(counter.begin(), counter.end(), 0) == result.rows());
 	}
 
 	void Evaluator::interpolate_boundary_function_at_vertices(
@@ -269,8 +268,6 @@ namespace polyfem::io
 
 		const Mesh3D &mesh3d = dynamic_cast<const Mesh3D &>(mesh);
 
-		Eigen::MatrixXd points;
-
 		int actual_dim = 1;
 		if (!is_problem_scalar)
 			actual_dim = 3;
@@ -281,71 +278,81 @@ namespace polyfem::io
 		result.resize(pts.rows(), actual_dim);
 		result.setZero();
 
-		for (int e = 0; e < mesh3d.n_elements(); ++e)
-		{
-			const ElementBases &gbs = gbases[e];
-			const ElementBases &bs = bases[e];
+		// the vertices are shared by several elements, the values are collected per element
+		// and written in element order so that the last element wins as in a serial loop
+		std::vector<std::vector<std::pair<int, RowVectorNd>>> vertex_values(mesh3d.n_elements());
 
-			for (int lf = 0; lf < mesh3d.n_cell_faces(e); ++lf)
+		utils::maybe_parallel_for(mesh3d.n_elements(), [&](int start, int end, int thread_id) {
+			Eigen::MatrixXd points;
+			ElementAssemblyValues vals;
+
+			for (int e = start; e < end; ++e)
 			{
-				const int face_id = mesh3d.cell_face(e, lf);
-				// if (!mesh3d.is_boundary_face(face_id))
-				//     continue;
-				int I;
-				Eigen::RowVector3d C;
-				const Eigen::RowVector3d bary = mesh3d.face_barycenter(face_id);
-
-				const double dist = tree.squared_distance(pts, faces, bary, I, C);
-				if (dist > 1e-15)
-					continue;
+				const ElementBases &gbs = gbases[e];
+				const ElementBases &bs = bases[e];
 
-				if (mesh3d.is_simplex(e))
-					autogen::p_nodes_3d(1, points);
-				else if (mesh3d.is_cube(e))
-					autogen::q_nodes_3d(1, points);
-				else
-					assert(false);
+				for (int lf = 0; lf < mesh3d.n_cell_faces(e); ++lf)
+				{
+					const int face_id = mesh3d.cell_face(e, lf);
+					int I;
+					Eigen::RowVector3d C;
+					const Eigen::RowVector3d bary = mesh3d.face_barycenter(face_id);
 
-				ElementAssemblyValues vals;
-				vals.compute(e, true, points, bs, gbs);
-				Eigen::MatrixXd loc_val(points.rows(), actual_dim);
-				loc_val.setZero();
+					const double dist = tree.squared_distance(pts, faces, bary, I, C);
+					if (dist > 1e-15)
+						continue;
 
-				// UIEvaluator::ui_state().debug_data().add_points(vals.val, Eigen::RowVector3d(1,0,0));
+					if (mesh3d.is_simplex(e))
+						autogen::p_nodes_3d(1, points);
+					else if (mesh3d.is_cube(e))
+						autogen::q_nodes_3d(1, points);
+					else
+						assert(false);
 
-				for (size_t j = 0; j < bs.bases.size(); ++j)
-				{
-					const Basis &b = bs.bases[j];
-					const AssemblyValues &v = vals.basis_values[j];
+					vals.compute(e, true, points, bs, gbs);
+					Eigen::MatrixXd loc_val(points.rows(), actual_dim);
+					loc_val.setZero();
 
-					for (int d = 0; d < actual_dim; ++d)
+					for (size_t j = 0; j < bs.bases.size(); ++j)
 					{
-						for (size_t ii = 0; ii < b.global().size(); ++ii)
-							loc_val.col(d) += b.global()[ii].val * v.val * fun(b.global()[ii].index * actual_dim + d);
+						const Basis &b = bs.bases[j];
+						const AssemblyValues &v = vals.basis_values[j];
+
+						for (int d = 0; d < actual_dim; ++d)
+						{
+							for (size_t ii = 0; ii < b.global().size(); ++ii)
+								loc_val.col(d) += b.global()[ii].val * v.val * fun(b.global()[ii].index * actual_dim + d);
+						}
 					}
-				}
 
-				for (int lv_id = 0; lv_id < faces.cols(); ++lv_id)
-				{
-					const int v_id = faces(I, lv_id);
-					const auto p = pts.row(v_id);
-					const auto &mapped = vals.val;
+					for (int lv_id = 0; lv_id < faces.cols(); ++lv_id)
+					{
+						const int v_id = faces(I, lv_id);
+						const auto p = pts.row(v_id);
+						const auto &mapped = vals.val;
 
-					bool found = false;
+						bool found = false;
 
-					for (int n = 0; n < mapped.rows(); ++n)
-					{
-						if ((p - mapped.row(n)).norm() < 1e-10)
+						for (int n = 0; n < mapped.rows(); ++n)
 						{
-							result.row(v_id) = loc_val.row(n);
-							found = true;
-							break;
+							if ((p - mapped.row(n)).norm() < 1e-10)
+							{
+								vertex_values[e].emplace_back(v_id, loc_val.row(n));
+								found = true;
+								break;
+							}
 						}
-					}
 
-					assert(found);
+						assert(found);
+					}
 				}
 			}
+		});
+
+		for (const auto &values : vertex_values)
+		{
+			for (const auto &[v_id, val] : values)
+				result.row(v_id) = val;
 		}
 	}
 
@@ -408,8 +415,6 @@ namespace polyfem::io
 			return;
 		}
 
-		std::vector<std::pair<std::string, Eigen::MatrixXd>> tmp_t, tmp_s;
-
 		assert(mesh.is_volume());
 		assert(!is_problem_scalar);
 
@@ -418,9 +423,6 @@ namespace polyfem::io
 		Eigen::MatrixXd normals;
 		igl::per_face_normals((pts + disp).eval(), faces, normals);
 
-		Eigen::MatrixXd points, uv, tmp_n, loc_v;
-		Eigen::VectorXd weights;
-
 		const int actual_dim = 3;
 
 		igl::AABB<Eigen::MatrixXd, 3> tree;
@@ -435,123 +437,127 @@ namespace polyfem::io
 		mises.resize(faces.rows(), 1);
 		mises.setConstant(std::numeric_limits<double>::quiet_NaN());
 
-		int counter = 0;
+		// every boundary face is written by a single element
+		std::vector<int> counter(mesh3d.n_elements(), 0);
 
-		for (int e = 0; e < mesh3d.n_elements(); ++e)
-		{
-			const ElementBases &gbs = gbases[e];
-			const ElementBases &bs = bases[e];
+		utils::maybe_parallel_for(mesh3d.n_elements(), [&](int start, int end, int thread_id) {
+			std::vector<std::pair<std::string, Eigen::MatrixXd>> tmp_t, tmp_s;
+			Eigen::MatrixXd points, uv, tmp_n, loc_v;
+			Eigen::VectorXd weights;
+			ElementAssemblyValues vals;
 
-			for (int lf = 0; lf < mesh3d.n_cell_faces(e); ++lf)
+			for (int e = start; e < end; ++e)
 			{
-				const int face_id = mesh3d.cell_face(e, lf);
-				// if (!mesh3d.is_boundary_face(face_id))
-				//     continue;
-
-				int I;
-				Eigen::RowVector3d C;
-				const Eigen::RowVector3d bary = mesh3d.face_barycenter(face_id);
-
-				const double dist = tree.squared_distance(pts, faces, bary, I, C);
-				if (dist > 1e-15)
-					continue;
+				const ElementBases &gbs = gbases[e];
+				const ElementBases &bs = bases[e];
 
-				int lfid = 0;
-				for (; lfid < mesh3d.n_cell_faces(e); ++lfid)
+				for (int lf = 0; lf < mesh3d.n_cell_faces(e); ++lf)
 				{
-					if (mesh.is_simplex(e))
-						loc_v = utils::BoundarySampler::tet_local_node_coordinates_from_face(lfid);
-					else if (mesh.is_cube(e))
-						loc_v = utils::BoundarySampler::hex_local_node_coordinates_from_face(lfid);
-					else
-						assert(false);
+					const int face_id = mesh3d.cell_face(e, lf);
 
-					ElementAssemblyValues vals;
-					vals.compute(e, true, loc_v, bs, gbs);
+					int I;
+					Eigen::RowVector3d C;
+					const Eigen::RowVector3d bary = mesh3d.face_barycenter(face_id);
 
-					int count = 0;
+					const double dist = tree.squared_distance(pts, faces, bary, I, C);
+					if (dist > 1e-15)
+						continue;
 
-					for (int lv_id = 0; lv_id < faces.cols(); ++lv_id)
+					int lfid = 0;
+					for (; lfid < mesh3d.n_cell_faces(e); ++lfid)
 					{
-						const int v_id = faces(I, lv_id);
-						const auto p = pts.row(v_id);
-						const auto &mapped = vals.val;
-						assert(mapped.rows() == faces.cols());
+						if (mesh.is_simplex(e))
+							loc_v = utils::BoundarySampler::tet_local_node_coordinates_from_face(lfid);
+						else if (mesh.is_cube(e))
+							loc_v = utils::BoundarySampler::hex_local_node_coordinates_from_face(lfid);
+						else
+							assert(false);
 
-						for (int n = 0; n < mapped.rows(); ++n)
+						vals.compute(e, true, loc_v, bs, gbs);
+
+						int count = 0;
+
+						for (int lv_id = 0; lv_id < faces.cols(); ++lv_id)
 						{
-							if ((p - mapped.row(n)).norm() < 1e-10)
+							const int v_id = faces(I, lv_id);
+							const auto p = pts.row(v_id);
+							const auto &mapped = vals.val;
+							assert(mapped.rows() == faces.cols());
+
+							for (int n = 0; n < mapped.rows(); ++n)
 							{
-								count++;
-								break;
+								if ((p - mapped.row(n)).norm() < 1e-10)
+								{
+									count++;
+									break;
+								}
 							}
 						}
-					}
 
-					if (count == faces.cols())
-						break;
-				}
-				assert(lfid < mesh3d.n_cell_faces(e));
+						if (count == faces.cols())
+							break;
+					}
+					assert(lfid < mesh3d.n_cell_faces(e));
 
-				if (mesh.is_simplex(e))
-				{
-					utils::BoundarySampler::quadrature_for_tri_face(lfid, 4, face_id, mesh3d, uv, points, weights);
-					utils::BoundarySampler::normal_for_tri_face(lfid, tmp_n);
-				}
-				else if (mesh.is_cube(e))
-				{
-					utils::BoundarySampler::quadrature_for_quad_face(lfid, 4, face_id, mesh3d, uv, points, weights);
-					utils::BoundarySampler::normal_for_quad_face(lfid, tmp_n);
-				}
-				else
-					assert(false);
+					if (mesh.is_simplex(e))
+					{
+						utils::BoundarySampler::quadrature_for_tri_face(lfid, 4, face_id, mesh3d, uv, points, weights);
+						utils::BoundarySampler::normal_for_tri_face(lfid, tmp_n);
+					}
+					else if (mesh.is_cube(e))
+					{
+						utils::BoundarySampler::quadrature_for_quad_face(lfid, 4, face_id, mesh3d, uv, points, weights);
+						utils::BoundarySampler::normal_for_quad_face(lfid, tmp_n);
+					}
+					else
+						assert(false);
 
-				Eigen::RowVector3d tet_n;
-				tet_n.setZero();
-				ElementAssemblyValues vals;
-				vals.compute(e, true, points, bs, gbs);
-				for (int n = 0; n < vals.jac_it.size(); ++n)
-				{
-					Eigen::RowVector3d tmp = tmp_n * vals.jac_it[n];
-					tmp.normalize();
-					tet_n += tmp;
-				}
+					Eigen::RowVector3d tet_n;
+					tet_n.setZero();
+					vals.compute(e, true, points, bs, gbs);
+					for (int n = 0; n < vals.jac_it.size(); ++n)
+					{
+						Eigen::RowVector3d tmp = tmp_n * vals.jac_it[n];
+						tmp.normalize();
+						tet_n += tmp;
+					}
 
-				assembler.compute_scalar_value(e, bs, gbs, points, fun, tmp_s);
-				assembler.compute_tensor_value(e, bs, gbs, points, fun, tmp_t);
+					assembler.compute_scalar_value(e, bs, gbs, points, fun, tmp_s);
+					assembler.compute_tensor_value(e, bs, gbs, points, fun, tmp_t);
 
-				Eigen::MatrixXd loc_val = tmp_t[0].second, local_mises = tmp_s[0].second;
-				Eigen::VectorXd tmp(loc_val.cols());
-				const double tmp_mises = (local_mises.array() * weights.array()).sum();
+					Eigen::MatrixXd loc_val = tmp_t[0].second, local_mises = tmp_s[0].second;
+					Eigen::VectorXd tmp(loc_val.cols());
+					const double tmp_mises = (local_mises.array() * weights.array()).sum();
 
-				for (int d = 0; d < loc_val.cols(); ++d)
-					tmp(d) = (loc_val.col(d).array() * weights.array()).sum();
-				const Eigen::MatrixXd tensor = Eigen::Map<Eigen::MatrixXd>(tmp.data(), 3, 3);
+					for (int d = 0; d < loc_val.cols(); ++d)
+						tmp(d) = (loc_val.col(d).array() * weights.array()).sum();
+					const Eigen::MatrixXd tensor = Eigen::Map<Eigen::MatrixXd>(tmp.data(), 3, 3);
 
-				const Eigen::RowVector3d tmpn = normals.row(I);
-				const Eigen::RowVector3d tmptf = tmpn * tensor;
-				if (skip_orientation || tmpn.dot(tet_n) > 0)
-				{
-					assert(std::isnan(result(I, 0)));
-					assert(std::isnan(stresses(I, 0)));
-					assert(std::isnan(mises(I)));
+					const Eigen::RowVector3d tmpn = normals.row(I);
+					const Eigen::RowVector3d tmptf = tmpn * tensor;
+					if (skip_orientation || tmpn.dot(tet_n) > 0)
+					{
+						assert(std::isnan(result(I, 0)));
+						assert(std::isnan(stresses(I, 0)));
+						assert(std::isnan(mises(I)));
 
-					result.row(I) = tmptf;
-					stresses.row(I) = tmp;
-					mises(I) = tmp_mises;
+						result.row(I) = tmptf;
+						stresses.row(I) = tmp;
+						mises(I) = tmp_mises;
 
-					if (compute_avg)
-					{
-						result.row(I) /= weights.sum();
-						stresses.row(I) /= weights.sum();
-						mises(I) /= weights.sum();
+						if (compute_avg)
+						{
+							result.row(I) /= weights.sum();
+							stresses.row(I) /= weights.sum();
+							mises(I) /= weights.sum();
+						}
+						++counter[e];
 					}
-					++counter;
 				}
 			}
-		}
+		});
 
-		assert(counter == result.rows());
+		assert(std::accumulate(counter.begin(), counter.end(), 0) == result.rows());
 	}
 
 	void Evaluator::average_grad_based_function(
@@ -1354,22 +1360,31 @@ namespace polyfem::io
 
 	Eigen::MatrixXd Evaluator::get_bases_position(
 		const int n_bases,
-		const std::shared_ptr<mesh::MeshNodes> mesh_nodes)
+		const std::vector<basis::ElementBases> &bases)
 	{
 		Eigen::MatrixXd func;
-		func.setZero(n_bases, mesh_nodes->node_position(0).size());
 
-		for (int i = 0; i < n_bases; i++)
-			func.row(i) = mesh_nodes->node_position(i);
+		for (const basis::ElementBases &bs : bases)
+		{
+			for (const basis::Basis &b : bs.bases)
+			{
+				for (const basis::Local2Global &g : b.global())
+				{
+					if (func.size() == 0)
+						func.setZero(n_bases, g.node.size());
+					func.row(g.index) = g.node;
+				}
+			}
+		}
 
 		return func;
 	}
 
 	Eigen::MatrixXd Evaluator::generate_linear_field(
 		const int n_bases,
-		const std::shared_ptr<mesh::MeshNodes> mesh_nodes,
+		const std::vector<basis::ElementBases> &bases,
 		const Eigen::MatrixXd &grad)
 	{
-		return utils::flatten(get_bases_position(n_bases, mesh_nodes) * grad.transpose());
+		return utils::flatten(get_bases_position(n_bases, bases) * grad.transpose());
 	}
 } // namespace polyfem::io
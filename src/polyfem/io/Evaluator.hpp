@@ -399,11 +399,12 @@ namespace polyfem::io
 
 		static Eigen::MatrixXd generate_linear_field(
 			const int n_bases,
-			const std::shared_ptr<mesh::MeshNodes> mesh_nodes,
+			const std::vector<basis::ElementBases> &bases,
 			const Eigen::MatrixXd &grad);
 
+		/// position of every node of the bases, taken from the bases so that it follows their numbering
 		static Eigen::MatrixXd get_bases_position(
 			const int n_bases,
-			const std::shared_ptr<mesh::MeshNodes> mesh_nodes);
+			const std::vector<basis::ElementBases> &bases);
 	};
 } // namespace polyfem::io
\ No newline at end of file
@@ -217,6 +217,85 @@ namespace polyfem::io
 		return true;
 	}
 
+	bool write_sparse_matrix_binary(const std::string &path, const StiffnessMatrix &mat)
+	{
+		typedef StiffnessMatrix::StorageIndex StorageIndex;
+
+		std::ofstream out(path, std::ios::out | std::ios::binary);
+
+		if (!out.good())
+		{
+			logger().error("Failed to write to file: {}", path);
+			out.close();
+
+			return false;
+		}
+
+		StiffnessMatrix compressed;
+		const StiffnessMatrix *m = &mat;
+		if (!mat.isCompressed())
+		{
+			compressed = mat;
+			compressed.makeCompressed();
+			m = &compressed;
+		}
+
+		const StiffnessMatrix::Index rows = m->rows(), cols = m->cols(), nnz = m->nonZeros();
+		out.write((const char *)(&rows), sizeof(rows));
+		out.write((const char *)(&cols), sizeof(cols));
+		out.write((const char *)(&nnz), sizeof(nnz));
+		out.write((const char *)m->outerIndexPtr(), (m->outerSize() + 1) * sizeof(StorageIndex));
+		out.write((const char *)m->innerIndexPtr(), nnz * sizeof(StorageIndex));
+		out.write((const char *)m->valuePtr(), nnz * sizeof(double));
+		out.close();
+
+		if (!out.good())
+		{
+			logger().error("Failed to write to file: {}", path);
+			return false;
+		}
+
+		return true;
+	}
+
+	bool read_sparse_matrix_binary(const std::string &path, StiffnessMatrix &mat)
+	{
+		typedef StiffnessMatrix::StorageIndex StorageIndex;
+
+		std::ifstream in(path, std::ios::in | std::ios::binary);
+		if (!in.good())
+		{
+			logger().error("Failed to open file: {}", path);
+			in.close();
+
+			return false;
+		}
+
+		StiffnessMatrix::Index rows = 0, cols = 0, nnz = 0;
+		in.read((char *)(&rows), sizeof(rows));
+		in.read((char *)(&cols), sizeof(cols));
+		in.read((char *)(&nnz), sizeof(nnz));
+		if (!in.good() || rows < 0 || cols < 0 || nnz < 0)
+		{
+			logger().error("Invalid sparse matrix header in file: {}", path);
+			return false;
+		}
+
+		mat.resize(rows, cols);
+		mat.resizeNonZeros(nnz);
+		in.read((char *)mat.outerIndexPtr(), (mat.outerSize() + 1) * sizeof(StorageIndex));
+		in.read((char *)mat.innerIndexPtr(), nnz * sizeof(StorageIndex));
+		in.read((char *)mat.valuePtr(), nnz * sizeof(double));
+		if (!in.good())
+		{
+			logger().error("Truncated sparse matrix in file: {}", path);
+			mat.resize(0, 0);
+			return false;
+		}
+
+		return true;
+	}
+
 	template <typename T>
 	bool import_matrix(
 		const std::string &path, const json &import, Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> &mat)
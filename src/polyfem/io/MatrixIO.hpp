@@ -38,6 +38,12 @@ namespace polyfem::io
 
 	bool write_sparse_matrix_csv(const std::string &path, const Eigen::SparseMatrix<double> &mat);
 
+	/// Writes a sparse matrix in compressed binary format.
+	bool write_sparse_matrix_binary(const std::string &path, const StiffnessMatrix &mat);
+
+	/// Reads a sparse matrix written by write_sparse_matrix_binary.
+	bool read_sparse_matrix_binary(const std::string &path, StiffnessMatrix &mat);
+
 	template <typename T>
 	bool import_matrix(const std::string &path, const json &import, Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> &mat);
 } // namespace polyfem::io
@@ -1165,7 +1165,7 @@ namespace polyfem::io
 			vtm.add_dataset("Wireframe", "data", path_stem + "_wire" + opts.file_extension());
 		if (opts.points)
 			vtm.add_dataset("Points", "data", path_stem + "_points" + opts.file_extension());
-		vtm.save(base_path + ".vtm");
+		write_output([vtm, path = base_path + ".vtm"]() mutable { vtm.save(path); });
 	}
 
 	void OutGeometryData::save_volume(
@@ -1197,13 +1197,27 @@ namespace polyfem::io
 		Eigen::MatrixXd discr;
 		std::vector<std::vector<int>> elements;
 
-		if (opts.use_sampler)
-			build_vis_mesh(mesh, disc_orders, gbases,
-						   state.polys, state.polys_3d, opts.boundary_only,
-						   points, tets, el_id, discr);
-		else
-			build_high_order_vis_mesh(mesh, disc_orders, bases,
-									  points, elements, el_id, discr);
+		// the visualization mesh only depends on the bases, it is built once and reused for every frame
+		if (!vis_mesh_cache_.valid || vis_mesh_cache_.use_sampler != opts.use_sampler || vis_mesh_cache_.boundary_only != opts.boundary_only)
+		{
+			vis_mesh_cache_ = VisMeshCache();
+			if (opts.use_sampler)
+				build_vis_mesh(mesh, disc_orders, gbases,
+							   state.polys, state.polys_3d, opts.boundary_only,
+							   vis_mesh_cache_.points, vis_mesh_cache_.tets, vis_mesh_cache_.el_id, vis_mesh_cache_.discr);
+			else
+				build_high_order_vis_mesh(mesh, disc_orders, bases,
+										  vis_mesh_cache_.points, vis_mesh_cache_.elements, vis_mesh_cache_.el_id, vis_mesh_cache_.discr);
+
+			vis_mesh_cache_.valid = true;
+			vis_mesh_cache_.use_sampler = opts.use_sampler;
+			vis_mesh_cache_.boundary_only = opts.boundary_only;
+		}
+		points = vis_mesh_cache_.points;
+		tets = vis_mesh_cache_.tets;
+		el_id = vis_mesh_cache_.el_id;
+		discr = vis_mesh_cache_.discr;
+		elements = vis_mesh_cache_.elements;
 
 		Eigen::MatrixXd fun, exact_fun, err, node_fun;
 
@@ -1690,9 +1704,11 @@ namespace polyfem::io
 			}
 
 			if (elements.empty())
-				writer.write_mesh(path, points, tets);
+				write_output([tmpw, path, points, tets]() { tmpw->write_mesh(path, points, tets); });
 			else
-				writer.write_mesh(path, points, elements, true, disc_orders.maxCoeff() == 1);
+				write_output([tmpw, path, points, elements, is_linear = disc_orders.maxCoeff() == 1]() {
+					tmpw->write_mesh(path, points, elements, true, is_linear);
+				});
 		}
 		else
 		{
@@ -1921,7 +1937,9 @@ namespace polyfem::io
 			solution_frames.back().solution = fun;
 
 		if (opts.solve_export_to_file)
-			writer.write_mesh(export_surface, boundary_vis_vertices, boundary_vis_elements);
+			write_output([tmpw, export_surface, boundary_vis_vertices, boundary_vis_elements]() {
+				tmpw->write_mesh(export_surface, boundary_vis_vertices, boundary_vis_elements);
+			});
 		else
 		{
 			solution_frames.back().name = export_surface;
@@ -2013,10 +2031,11 @@ namespace polyfem::io
 			// Write the solution last so it is the default for warp-by-vector
 			writer.add_field("solution", surface_displacements);
 
-			writer.write_mesh(
-				export_surface.substr(0, export_surface.length() - 4) + "_contact.vtu",
-				collision_mesh.rest_positions(),
-				problem_dim == 3 ? collision_mesh.faces() : collision_mesh.edges());
+			write_output([tmpw, path = export_surface.substr(0, export_surface.length() - 4) + "_contact.vtu",
+						  V = Eigen::MatrixXd(collision_mesh.rest_positions()),
+						  F = Eigen::MatrixXi(problem_dim == 3 ? collision_mesh.faces() : collision_mesh.edges())]() {
+				tmpw->write_mesh(path, V, F);
+			});
 		}
 	}
 
@@ -2205,7 +2224,7 @@ namespace polyfem::io
 		// Write the solution last so it is the default for warp-by-vector
 		writer.add_field("solution", fun);
 
-		writer.write_mesh(name, points, edges);
+		write_output([tmpw, name, points, edges]() { tmpw->write_mesh(name, points, edges); });
 	}
 
 	void OutGeometryData::save_points(
@@ -2260,7 +2279,7 @@ namespace polyfem::io
 			writer.add_field("sidesets", b_sidesets);
 			// Write the solution last so it is the default for warp-by-vector
 			writer.add_field("solution", fun);
-			writer.write_mesh(path, points, cells, false, false);
+			write_output([tmpw, path, points, cells]() { tmpw->write_mesh(path, points, cells, false, false); });
 		}
 	}
 
@@ -2269,12 +2288,40 @@ namespace polyfem::io
 		const std::function<std::string(int)> &vtu_names,
 		int time_steps, double t0, double dt, int skip_frame) const
 	{
-		paraviewo::PVDWriter::save_pvd(name, vtu_names, time_steps, t0, dt, skip_frame);
+		write_output([=]() { paraviewo::PVDWriter::save_pvd(name, vtu_names, time_steps, t0, dt, skip_frame); });
+	}
+
+	void OutGeometryData::init_output_queue(const int max_pending_frames)
+	{
+		if (output_queue_)
+			output_queue_->flush();
+		output_queue_ = std::make_shared<AsyncOutputQueue>(max_pending_frames);
+	}
+
+	void OutGeometryData::flush_output() const
+	{
+		if (output_queue_)
+			output_queue_->flush();
+	}
+
+	void OutGeometryData::close_output_queue()
+	{
+		flush_output();
+		output_queue_ = nullptr;
+	}
+
+	void OutGeometryData::write_output(std::function<void()> task) const
+	{
+		if (output_queue_)
+			output_queue_->push(std::move(task));
+		else
+			task();
 	}
 
 	void OutGeometryData::init_sampler(const polyfem::mesh::Mesh &mesh, const double vismesh_rel_area)
 	{
 		ref_element_sampler.init(mesh.is_volume(), mesh.n_elements(), vismesh_rel_area);
+		clear_vis_mesh_cache();
 	}
 
 	void OutGeometryData::build_grid(const polyfem::mesh::Mesh &mesh, const double spacing)
@@ -2738,6 +2785,10 @@ namespace polyfem::io
 		logger().info("non_regular_boundary_count: \t{}", non_regular_boundary_count);
 		logger().info("undefined_count: \t{}", undefined_count);
 		logger().info("total count:\t {}", mesh.n_elements());
+
+		topology_memory = mesh.topology_memory();
+		if (topology_memory > 0)
+			logger().info("topology memory: \t{:.2f}MB", topology_memory / (1024. * 1024.));
 	}
 
 	void OutStatsData::save_json(
@@ -2809,6 +2860,8 @@ namespace polyfem::io
 		// j["time_computing_errors"] = runtime.computing_errors_time;
 
 		j["solver_info"] = solver_info;
+		j["num_factorizations"] = n_factorizations;
+		j["num_reused_factorizations"] = n_reused_factorizations;
 
 		j["count_simplex"] = simplex_count;
 		j["count_regular"] = regular_count;
@@ -2823,6 +2876,8 @@ namespace polyfem::io
 
 		j["is_simplicial"] = mesh.n_elements() == simplex_count;
 
+		j["topology_memory"] = topology_memory;
+
 		j["peak_memory"] = getPeakRSS() / (1024 * 1024);
 
 		const int actual_dim = problem.is_scalar() ? 1 : mesh.dimension();
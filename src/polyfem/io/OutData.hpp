@@ -15,6 +15,7 @@
 #include <paraviewo/HDF5VTUWriter.hpp>
 
 #include <polyfem/utils/RefElementSampler.hpp>
+#include <polyfem/io/AsyncOutputQueue.hpp>
 
 #include <Eigen/Dense>
 
@@ -265,7 +266,42 @@ namespace polyfem::io
 		void save_pvd(const std::string &name, const std::function<std::string(int)> &vtu_names,
 					  int time_steps, double t0, double dt, int skip_frame = 1) const;
 
+		/// @brief writes the output files on a background thread from now on
+		/// @param[in] max_pending_frames maximum number of files waiting to be written before the solver blocks, <= 0 to write synchronously
+		void init_output_queue(const int max_pending_frames);
+
+		/// @brief waits until all the queued output files are written
+		void flush_output() const;
+
+		/// @brief waits until all the queued output files are written and writes synchronously from now on
+		void close_output_queue();
+
+		/// @brief discards the visualization mesh cached by save_volume, needs to be called when the bases change
+		void clear_vis_mesh_cache() { vis_mesh_cache_ = VisMeshCache(); }
+
 	private:
+		/// writes the output files in the background if the queue is initialized
+		std::shared_ptr<AsyncOutputQueue> output_queue_;
+
+		/// @brief runs the task on the output queue, or immediately if there is none
+		/// @param[in] task task writing the files, it must own all the data it uses
+		void write_output(std::function<void()> task) const;
+
+		/// visualization mesh of save_volume, it does not change from a frame to the next
+		struct VisMeshCache
+		{
+			bool valid = false;
+			bool use_sampler;
+			bool boundary_only;
+
+			Eigen::MatrixXd points;
+			Eigen::MatrixXi tets;
+			std::vector<std::vector<int>> elements;
+			Eigen::MatrixXi el_id;
+			Eigen::MatrixXd discr;
+		};
+		mutable VisMeshCache vis_mesh_cache_;
+
 		/// used to sample the solution
 		utils::RefElementSampler ref_element_sampler;
 
@@ -411,6 +447,9 @@ namespace polyfem::io
 		/// num dof is the total dof in the system
 		long long nn_zero, mat_size, num_dofs;
 
+		/// factorizations of the system matrix computed and reused across time steps in transient linear solves
+		long n_factorizations = 0, n_reused_factorizations = 0;
+
 		/// statiscs on angle, compute only when using p_ref (false by default)
 		double max_angle;
 		/// statiscs on tri/tet quality, compute only when using p_ref (false by default)
@@ -439,6 +478,8 @@ namespace polyfem::io
 		int undefined_count;
 		/// statiscs on the mesh (irregular boundary quad/hex part of the mesh), see Polyspline paper for desciption
 		int multi_singular_boundary_count;
+		/// memory used by the mesh connectivity in bytes, 0 if the mesh does not report it
+		size_t topology_memory = 0;
 
 		/// @brief compute errors
 		/// @param[in] n_bases number of base
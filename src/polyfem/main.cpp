@@ -1,4 +1,5 @@
 #include <filesystem>
+#include <sstream>
 
 #include <CLI/CLI.hpp>
 
@@ -13,6 +14,7 @@
 
 #include <polyfem/utils/JSONUtils.hpp>
 #include <polyfem/utils/Logger.hpp>
+#include <polyfem/utils/Tracer.hpp>
 
 #include <polysolve/LinearSolver.hpp>
 
@@ -99,10 +101,20 @@ int main(int argc, char **argv)
 	command_line.add_option("--log_level", log_level, "Log level")
 		->transform(CLI::CheckedTransformer(SPDLOG_LEVEL_NAMES_TO_LEVELS, CLI::ignore_case));
 
+	std::string trace_file = "";
+	command_line.add_option("--trace", trace_file, "Saves a Chrome trace (chrome://tracing, ui.perfetto.dev) of the timed scopes to this JSON file");
+
+	bool trace_summary = false;
+	command_line.add_flag("--trace_summary", trace_summary, "Logs the calls and time of every timed scope at the end of the run");
+
 	CLI11_PARSE(command_line, argc, argv);
 
+	if (!trace_file.empty() || trace_summary)
+		utils::Tracer::enable();
+
 	json in_args = json({});
 
+	int res;
 	if (!json_file.empty())
 	{
 		const bool ok = load_json(json_file, in_args);
@@ -111,14 +123,25 @@ int main(int argc, char **argv)
 			log_and_throw_error(fmt::format("unable to open {} file", json_file));
 
 		if (in_args.contains("states"))
-			return optimization_simulation(command_line, max_threads, is_strict, log_level, in_args);
+			res = optimization_simulation(command_line, max_threads, is_strict, log_level, in_args);
 		else
-			return forward_simulation(command_line, "", output_dir, max_threads,
-									  is_strict, fallback_solver, log_level, in_args);
+			res = forward_simulation(command_line, "", output_dir, max_threads,
+									 is_strict, fallback_solver, log_level, in_args);
 	}
 	else
-		return forward_simulation(command_line, hdf5_file, output_dir, max_threads,
-								  is_strict, fallback_solver, log_level, in_args);
+		res = forward_simulation(command_line, hdf5_file, output_dir, max_threads,
+								 is_strict, fallback_solver, log_level, in_args);
+
+	if (!trace_file.empty())
+		utils::Tracer::write_chrome_trace(trace_file);
+	if (trace_summary)
+	{
+		std::stringstream summary;
+		utils::Tracer::write_summary(summary);
+		logger().info("Timed scopes:\n{}", summary.str());
+	}
+
+	return res;
 }
 
 int forward_simulation(const CLI::App &command_line,
@@ -374,6 +374,8 @@ namespace polyfem::mesh
 
 		const auto tmp = node_ids_;
 
+		// the vertex nodes can be renumbered past the vertices, the other nodes get the default
+		node_ids_.assign(std::max<int>(n_vertices(), in_node_to_node.size()), -1);
 		for (int n = 0; n < n_vertices(); ++n)
 		{
 			node_ids_[in_node_to_node[n]] = tmp[n];
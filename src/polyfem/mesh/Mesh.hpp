@@ -157,6 +157,11 @@ namespace polyfem
 			///
 			/// @return number of boundary elements
 			int n_boundary_elements() const { return (is_volume() ? n_faces() : n_edges()); }
+			///
+			/// @brief memory used by the connectivity of the mesh
+			///
+			/// @return size in bytes, 0 if unknown
+			virtual size_t topology_memory() const { return 0; }
 
 			///
 			/// @brief number of cells
@@ -25,6 +25,8 @@ namespace polyfem
 
 			// TODO refine high order mesh!
 			orders_.resize(0, 0);
+			// the refinement edits the per-entity lists
+			MeshProcessing3D::expand_topology(mesh_);
 			if (mesh_.type == MeshType::TET)
 			{
 				MeshProcessing3D::refine_red_refinement_tet(mesh_, n_refinement);
@@ -51,27 +53,27 @@ namespace polyfem
 			assert(in_ordered_vertices_[2] == 2);
 			assert(in_ordered_vertices_[in_ordered_vertices_.size() - 1] == n_vertices() - 1);
 
-			in_ordered_edges_.resize(mesh_.edges.size(), 2);
+			in_ordered_edges_.resize(mesh_.n_edges(), 2);
 
-			for (int e = 0; e < (int)mesh_.edges.size(); ++e)
+			for (int e = 0; e < (int)mesh_.n_edges(); ++e)
 			{
-				assert(mesh_.edges[e].vs.size() == 2);
+				assert(mesh_.edge_vertices[e].size() == 2);
 				for (int lv = 0; lv < 2; ++lv)
 				{
-					in_ordered_edges_(e, lv) = mesh_.edges[e].vs[lv];
+					in_ordered_edges_(e, lv) = mesh_.edge_vertices[e][lv];
 				}
 			}
 			assert(in_ordered_edges_.size() > 0);
 
-			in_ordered_faces_.resize(mesh_.faces.size(), mesh_.faces[0].vs.size());
+			in_ordered_faces_.resize(mesh_.n_faces(), mesh_.face_vertices[0].size());
 
-			for (int f = 0; f < (int)mesh_.faces.size(); ++f)
+			for (int f = 0; f < (int)mesh_.n_faces(); ++f)
 			{
-				assert(in_ordered_faces_.cols() == mesh_.faces[f].vs.size());
+				assert(in_ordered_faces_.cols() == mesh_.face_vertices[f].size());
 
 				for (int lv = 0; lv < in_ordered_faces_.cols(); ++lv)
 				{
-					in_ordered_faces_(f, lv) = mesh_.faces[f].vs[lv];
+					in_ordered_faces_(f, lv) = mesh_.face_vertices[f][lv];
 				}
 			}
 			assert(in_ordered_faces_.size() > 0);
@@ -185,11 +187,13 @@ namespace polyfem
 			fclose(f);
 
 			// remove horrible kernels and replace with barycenters
-			for (int c = 0; c < n_cells(); ++c)
+			for (Element &ele : mesh_.elements)
 			{
-				auto bary = cell_barycenter(c);
-				for (int d = 0; d < 3; ++d)
-					mesh_.elements[c].v_in_Kernel[d] = bary(d);
+				Eigen::Vector3d bary = Eigen::Vector3d::Zero();
+				for (const uint32_t v : ele.vs)
+					bary += mesh_.points.col(v);
+				bary /= ele.vs.size();
+				ele.v_in_Kernel = {bary(0), bary(1), bary(2)};
 			}
 
 			Navigation3D::prepare_mesh(mesh_);
@@ -426,40 +430,40 @@ namespace polyfem
 
 			std::fstream f(path, std::ios::out);
 
-			f << mesh_.points.cols() << " " << mesh_.faces.size() << " " << 3 * mesh_.elements.size() << std::endl;
+			f << mesh_.points.cols() << " " << mesh_.n_faces() << " " << 3 * mesh_.n_elements() << std::endl;
 			for (int i = 0; i < mesh_.points.cols(); i++)
 				f << mesh_.points(0, i) << " " << mesh_.points(1, i) << " " << mesh_.points(2, i) << std::endl;
 
-			for (auto f_ : mesh_.faces)
+			for (int fid = 0; fid < mesh_.n_faces(); fid++)
 			{
-				f << f_.vs.size() << " ";
-				for (auto vid : f_.vs)
+				f << mesh_.face_vertices[fid].size() << " ";
+				for (auto vid : mesh_.face_vertices[fid])
 					f << vid << " ";
 				f << std::endl;
 			}
 
-			for (uint32_t i = 0; i < mesh_.elements.size(); i++)
+			for (uint32_t i = 0; i < mesh_.n_elements(); i++)
 			{
-				f << mesh_.elements[i].fs.size() << " ";
-				for (auto fid : mesh_.elements[i].fs)
+				f << mesh_.element_faces[i].size() << " ";
+				for (auto fid : mesh_.element_faces[i])
 					f << fid << " ";
 				f << std::endl;
-				f << mesh_.elements[i].fs_flag.size() << " ";
-				for (auto f_flag : mesh_.elements[i].fs_flag)
-					f << f_flag << " ";
+				f << mesh_.element_faces[i].size() << " ";
+				for (int j = 0; j < mesh_.element_faces[i].size(); j++)
+					f << mesh_.element_face_flag(i, j) << " ";
 				f << std::endl;
 			}
 
-			for (uint32_t i = 0; i < mesh_.elements.size(); i++)
+			for (uint32_t i = 0; i < mesh_.n_elements(); i++)
 			{
-				f << mesh_.elements[i].hex << std::endl;
+				f << mesh_.element_hex[i] << std::endl;
 			}
 
 			f << "KERNEL"
-			<< " " << mesh_.elements.size() << std::endl;
-			for (uint32_t i = 0; i < mesh_.elements.size(); i++)
+			<< " " << mesh_.n_elements() << std::endl;
+			for (uint32_t i = 0; i < mesh_.n_elements(); i++)
 			{
-				f << mesh_.elements[i].v_in_Kernel[0] << " " << mesh_.elements[i].v_in_Kernel[1] << " " << mesh_.elements[i].v_in_Kernel[2] << std::endl;
+				f << mesh_.element_kernels(0, i) << " " << mesh_.element_kernels(1, i) << " " << mesh_.element_kernels(2, i) << std::endl;
 			}
 			f.close();
 
@@ -1017,14 +1021,7 @@ namespace polyfem
 			const double scaling = 1.0 / (V.rowwise().maxCoeff() - V.rowwise().minCoeff()).maxCoeff();
 			V = (V.colwise() - shift) * scaling;
 
-			for (int i = 0; i < n_cells(); ++i)
-			{
-				for (int d = 0; d < 3; ++d)
-				{
-					auto val = mesh_.elements[i].v_in_Kernel[d];
-					mesh_.elements[i].v_in_Kernel[d] = (val - shift(d)) * scaling;
-				}
-			}
+			mesh_.element_kernels = (mesh_.element_kernels.colwise() - shift) * scaling;
 
 			for (auto &n : edge_nodes_)
 			{
@@ -1072,8 +1069,8 @@ namespace polyfem
 		{
 			ranges.clear();
 
-			std::vector<Eigen::MatrixXi> local_tris(mesh_.elements.size());
-			std::vector<Eigen::MatrixXd> local_pts(mesh_.elements.size());
+			std::vector<Eigen::MatrixXi> local_tris(mesh_.n_elements());
+			std::vector<Eigen::MatrixXd> local_pts(mesh_.n_elements());
 			Eigen::MatrixXi tets;
 
 			int total_tris = 0;
@@ -1087,12 +1084,13 @@ namespace polyfem
 			Eigen::MatrixXd cell_barys;
 			cell_barycenters(cell_barys);
 
-			for (std::size_t e = 0; e < mesh_.elements.size(); ++e)
+			for (std::size_t e = 0; e < mesh_.n_elements(); ++e)
 			{
-				const Element &el = mesh_.elements[e];
+				const IndexRange el_vs = mesh_.element_vertices[e];
+				const IndexRange el_fs = mesh_.element_faces[e];
 
-				const int n_vertices = el.vs.size();
-				const int n_faces = el.fs.size();
+				const int n_vertices = el_vs.size();
+				const int n_faces = el_fs.size();
 
 				Eigen::MatrixXd local_pt(n_vertices + n_faces, 3);
 
@@ -1100,7 +1098,7 @@ namespace polyfem
 
 				for (int i = 0; i < n_vertices; ++i)
 				{
-					const int global_index = el.vs[i];
+					const int global_index = el_vs[i];
 					local_pt.row(i) = mesh_.points.col(global_index).transpose();
 					global_to_local[global_index] = i;
 				}
@@ -1108,10 +1106,10 @@ namespace polyfem
 				int n_local_faces = 0;
 				for (int i = 0; i < n_faces; ++i)
 				{
-					const Face &f = mesh_.faces[el.fs[i]];
-					n_local_faces += f.vs.size();
+					const int fid = el_fs[i];
+					n_local_faces += mesh_.face_vertices[fid].size();
 
-					local_pt.row(n_vertices + i) = face_barys.row(f.id); // node_from_face(f.id);
+					local_pt.row(n_vertices + i) = face_barys.row(fid); // node_from_face(fid);
 				}
 
 				Eigen::MatrixXi local_faces(n_local_faces, 3);
@@ -1119,14 +1117,14 @@ namespace polyfem
 				int face_index = 0;
 				for (int i = 0; i < n_faces; ++i)
 				{
-					const Face &f = mesh_.faces[el.fs[i]];
-					const int n_face_vertices = f.vs.size();
+					const IndexRange f_vs = mesh_.face_vertices[el_fs[i]];
+					const int n_face_vertices = f_vs.size();
 
-					const Eigen::RowVector3d e0 = (point(f.vs[0]) - local_pt.row(n_vertices + i));
-					const Eigen::RowVector3d e1 = (point(f.vs[1]) - local_pt.row(n_vertices + i));
+					const Eigen::RowVector3d e0 = (point(f_vs[0]) - local_pt.row(n_vertices + i));
+					const Eigen::RowVector3d e1 = (point(f_vs[1]) - local_pt.row(n_vertices + i));
 					const Eigen::RowVector3d normal = e0.cross(e1);
 					// const Eigen::RowVector3d check_dir = (node_from_element(e)-p);
-					const Eigen::RowVector3d check_dir = (cell_barys.row(e) - point(f.vs[1]));
+					const Eigen::RowVector3d check_dir = (cell_barys.row(e) - point(f_vs[1]));
 
 					const bool reverse_order = normal.dot(check_dir) > 0;
 
@@ -1135,13 +1133,13 @@ namespace polyfem
 						const int jp = (j + 1) % n_face_vertices;
 						if (reverse_order)
 						{
-							local_faces(face_index, 0) = global_to_local[f.vs[jp]];
-							local_faces(face_index, 1) = global_to_local[f.vs[j]];
+							local_faces(face_index, 0) = global_to_local[f_vs[jp]];
+							local_faces(face_index, 1) = global_to_local[f_vs[j]];
 						}
 						else
 						{
-							local_faces(face_index, 0) = global_to_local[f.vs[j]];
-							local_faces(face_index, 1) = global_to_local[f.vs[jp]];
+							local_faces(face_index, 0) = global_to_local[f_vs[j]];
+							local_faces(face_index, 1) = global_to_local[f_vs[jp]];
 						}
 						local_faces(face_index, 2) = n_vertices + i;
 
@@ -1177,7 +1175,7 @@ namespace polyfem
 
 		bool CMesh3D::is_boundary_element(const int element_global_id) const
 		{
-			const auto &fs = mesh_.elements[element_global_id].fs;
+			const IndexRange fs = mesh_.element_faces[element_global_id];
 
 			for (auto f_id : fs)
 			{
@@ -1185,7 +1183,7 @@ namespace polyfem
 					return true;
 			}
 
-			const auto &vs = mesh_.elements[element_global_id].vs;
+			const IndexRange vs = mesh_.element_vertices[element_global_id];
 
 			for (auto v_id : vs)
 			{
@@ -1317,12 +1315,6 @@ namespace polyfem
 		void CMesh3D::set_point(const int global_index, const RowVectorNd &p)
 		{
 			mesh_.points.col(global_index) = p.transpose();
-			if (mesh_.vertices[global_index].v.size() == 3)
-			{
-				mesh_.vertices[global_index].v[0] = p[0];
-				mesh_.vertices[global_index].v[1] = p[1];
-				mesh_.vertices[global_index].v[2] = p[2];
-			}
 		}
 
 		RowVectorNd CMesh3D::point(const int global_index) const
@@ -1333,8 +1325,7 @@ namespace polyfem
 
 		RowVectorNd CMesh3D::kernel(const int c) const
 		{
-			RowVectorNd pt(3);
-			pt << mesh_.elements[c].v_in_Kernel[0], mesh_.elements[c].v_in_Kernel[1], mesh_.elements[c].v_in_Kernel[2];
+			RowVectorNd pt = mesh_.element_kernels.col(c).transpose();
 			return pt;
 		}
 
@@ -1343,45 +1334,45 @@ namespace polyfem
 			std::vector<ElementType> &ele_tag = elements_tag_;
 			ele_tag.clear();
 
-			ele_tag.resize(mesh_.elements.size());
+			ele_tag.resize(mesh_.n_elements());
 			for (auto &t : ele_tag)
 				t = ElementType::REGULAR_INTERIOR_CUBE;
 
 			// boundary flags
-			std::vector<bool> bv_flag(mesh_.vertices.size(), false), be_flag(mesh_.edges.size(), false), bf_flag(mesh_.faces.size(), false);
-			for (auto f : mesh_.faces)
-				if (f.boundary)
-					bf_flag[f.id] = true;
+			std::vector<bool> bv_flag(mesh_.n_vertices(), false), be_flag(mesh_.n_edges(), false), bf_flag(mesh_.n_faces(), false);
+			for (int fid = 0; fid < mesh_.n_faces(); ++fid)
+				if (mesh_.face_boundary[fid])
+					bf_flag[fid] = true;
 				else
 				{
-					for (auto nhid : f.neighbor_hs)
-						if (!mesh_.elements[nhid].hex)
-							bf_flag[f.id] = true;
+					for (auto nhid : mesh_.face_elements[fid])
+						if (!mesh_.element_hex[nhid])
+							bf_flag[fid] = true;
 				}
-			for (uint32_t i = 0; i < mesh_.faces.size(); ++i)
+			for (uint32_t i = 0; i < mesh_.n_faces(); ++i)
 				if (bf_flag[i])
-					for (uint32_t j = 0; j < mesh_.faces[i].vs.size(); ++j)
+					for (uint32_t j = 0; j < mesh_.face_vertices[i].size(); ++j)
 					{
-						uint32_t eid = mesh_.faces[i].es[j];
+						uint32_t eid = mesh_.face_edges[i][j];
 						be_flag[eid] = true;
-						bv_flag[mesh_.faces[i].vs[j]] = true;
+						bv_flag[mesh_.face_vertices[i][j]] = true;
 					}
 
-			for (auto &ele : mesh_.elements)
+			for (int h = 0; h < mesh_.n_elements(); ++h)
 			{
-				if (ele.hex)
+				if (mesh_.element_hex[h])
 				{
 					bool attaching_non_hex = false, on_boundary = false;
 					;
-					for (auto vid : ele.vs)
+					for (auto vid : mesh_.element_vertices[h])
 					{
-						for (auto eleid : mesh_.vertices[vid].neighbor_hs)
-							if (!mesh_.elements[eleid].hex)
+						for (auto eleid : mesh_.vertex_elements[vid])
+							if (!mesh_.element_hex[eleid])
 							{
 								attaching_non_hex = true;
 								break;
 							}
-						if (mesh_.vertices[vid].boundary)
+						if (mesh_.vertex_boundary[vid])
 						{
 							on_boundary = true;
 							break;
@@ -1391,32 +1382,32 @@ namespace polyfem
 					}
 					if (attaching_non_hex)
 					{
-						ele_tag[ele.id] = ElementType::INTERFACE_CUBE;
+						ele_tag[h] = ElementType::INTERFACE_CUBE;
 						continue;
 					}
 
 					if (on_boundary)
 					{
-						ele_tag[ele.id] = ElementType::MULTI_SINGULAR_BOUNDARY_CUBE;
+						ele_tag[h] = ElementType::MULTI_SINGULAR_BOUNDARY_CUBE;
 						// has no boundary edge--> singular
 						bool boundary_edge = false, boundary_edge_singular = false, interior_edge_singular = false;
 						int n_interior_edge_singular = 0;
-						for (auto eid : ele.es)
+						for (auto eid : mesh_.element_edges[h])
 						{
 							int en = 0;
 							if (be_flag[eid])
 							{
 								boundary_edge = true;
-								for (auto nhid : mesh_.edges[eid].neighbor_hs)
-									if (mesh_.elements[nhid].hex)
+								for (auto nhid : mesh_.edge_elements[eid])
+									if (mesh_.element_hex[nhid])
 										en++;
 								if (en > 2)
 									boundary_edge_singular = true;
 							}
 							else
 							{
-								for (auto nhid : mesh_.edges[eid].neighbor_hs)
-									if (mesh_.elements[nhid].hex)
+								for (auto nhid : mesh_.edge_elements[eid])
+									if (mesh_.element_hex[nhid])
 										en++;
 								if (en != 4)
 								{
@@ -1430,14 +1421,14 @@ namespace polyfem
 
 						bool has_singular_v = false, has_iregular_v = false;
 						int n_in_irregular_v = 0;
-						for (auto vid : ele.vs)
+						for (auto vid : mesh_.element_vertices[h])
 						{
 							int vn = 0;
 							if (bv_flag[vid])
 							{
 								int nh = 0;
-								for (auto nhid : mesh_.vertices[vid].neighbor_hs)
-									if (mesh_.elements[nhid].hex)
+								for (auto nhid : mesh_.vertex_elements[vid])
+									if (mesh_.element_hex[nhid])
 										nh++;
 								if (nh > 4)
 									has_iregular_v = true;
@@ -1445,12 +1436,12 @@ namespace polyfem
 							}
 							else
 							{
-								if (mesh_.vertices[vid].neighbor_hs.size() != 8)
+								if (mesh_.vertex_elements[vid].size() != 8)
 									n_in_irregular_v++;
 								int n_irregular_e = 0;
-								for (auto eid : mesh_.vertices[vid].neighbor_es)
+								for (auto eid : mesh_.vertex_edges[vid])
 								{
-									if (mesh_.edges[eid].neighbor_hs.size() != 4)
+									if (mesh_.edge_elements[eid].size() != 4)
 										n_irregular_e++;
 								}
 								if (n_irregular_e != 0 && n_irregular_e != 2)
@@ -1461,8 +1452,8 @@ namespace polyfem
 							}
 						}
 						int n_irregular_e = 0;
-						for (auto eid : ele.es)
-							if (!be_flag[eid] && mesh_.edges[eid].neighbor_hs.size() != 4)
+						for (auto eid : mesh_.element_edges[h])
+							if (!be_flag[eid] && mesh_.edge_elements[eid].size() != 4)
 								n_irregular_e++;
 						if (has_singular_v)
 							continue;
@@ -1470,10 +1461,10 @@ namespace polyfem
 						{
 							if (n_irregular_e == 1)
 							{
-								ele_tag[ele.id] = ElementType::SIMPLE_SINGULAR_BOUNDARY_CUBE;
+								ele_tag[h] = ElementType::SIMPLE_SINGULAR_BOUNDARY_CUBE;
 							}
 							else if (n_irregular_e == 0 && n_in_irregular_v == 0 && !has_iregular_v)
-								ele_tag[ele.id] = ElementType::REGULAR_BOUNDARY_CUBE;
+								ele_tag[h] = ElementType::REGULAR_BOUNDARY_CUBE;
 							else
 								continue;
 						}
@@ -1482,28 +1473,28 @@ namespace polyfem
 
 					// type 1
 					bool has_irregular_v = false;
-					for (auto vid : ele.vs)
-						if (mesh_.vertices[vid].neighbor_hs.size() != 8)
+					for (auto vid : mesh_.element_vertices[h])
+						if (mesh_.vertex_elements[vid].size() != 8)
 						{
 							has_irregular_v = true;
 							break;
 						}
 					if (!has_irregular_v)
 					{
-						ele_tag[ele.id] = ElementType::REGULAR_INTERIOR_CUBE;
+						ele_tag[h] = ElementType::REGULAR_INTERIOR_CUBE;
 						continue;
 					}
 					// type 2
 					bool has_singular_v = false;
 					int n_irregular_v = 0;
-					for (auto vid : ele.vs)
+					for (auto vid : mesh_.element_vertices[h])
 					{
-						if (mesh_.vertices[vid].neighbor_hs.size() != 8)
+						if (mesh_.vertex_elements[vid].size() != 8)
 							n_irregular_v++;
 						int n_irregular_e = 0;
-						for (auto eid : mesh_.vertices[vid].neighbor_es)
+						for (auto eid : mesh_.vertex_edges[vid])
 						{
-							if (mesh_.edges[eid].neighbor_hs.size() != 4)
+							if (mesh_.edge_elements[eid].size() != 4)
 								n_irregular_e++;
 						}
 						if (n_irregular_e != 0 && n_irregular_e != 2)
@@ -1514,29 +1505,29 @@ namespace polyfem
 					}
 					if (!has_singular_v && n_irregular_v == 2)
 					{
-						ele_tag[ele.id] = ElementType::SIMPLE_SINGULAR_INTERIOR_CUBE;
+						ele_tag[h] = ElementType::SIMPLE_SINGULAR_INTERIOR_CUBE;
 						continue;
 					}
 
-					ele_tag[ele.id] = ElementType::MULTI_SINGULAR_INTERIOR_CUBE;
+					ele_tag[h] = ElementType::MULTI_SINGULAR_INTERIOR_CUBE;
 				}
 				else
 				{
-					ele_tag[ele.id] = ElementType::INTERIOR_POLYTOPE;
-					for (auto fid : ele.fs)
-						if (mesh_.faces[fid].boundary)
+					ele_tag[h] = ElementType::INTERIOR_POLYTOPE;
+					for (auto fid : mesh_.element_faces[h])
+						if (mesh_.face_boundary[fid])
 						{
-							ele_tag[ele.id] = ElementType::BOUNDARY_POLYTOPE;
+							ele_tag[h] = ElementType::BOUNDARY_POLYTOPE;
 							break;
 						}
 				}
 			}
 
 			// TODO correct?
-			for (auto &ele : mesh_.elements)
+			for (int h = 0; h < mesh_.n_elements(); ++h)
 			{
-				if (ele.vs.size() == 4)
-					ele_tag[ele.id] = ElementType::SIMPLEX;
+				if (mesh_.element_vertices[h].size() == 4)
+					ele_tag[h] = ElementType::SIMPLEX;
 			}
 		}
 
@@ -1545,7 +1536,7 @@ namespace polyfem
 			const int n_vertices = n_face_vertices(gid);
 			assert(n_vertices == 4);
 
-			const auto &vertices = mesh_.faces[gid].vs;
+			const IndexRange vertices = mesh_.face_vertices[gid];
 
 			const auto v1 = point(vertices[0]);
 			const auto v2 = point(vertices[1]);
@@ -1563,8 +1554,8 @@ namespace polyfem
 
 		RowVectorNd CMesh3D::edge_barycenter(const int e) const
 		{
-			const int v0 = mesh_.edges[e].vs[0];
-			const int v1 = mesh_.edges[e].vs[1];
+			const int v0 = mesh_.edge_vertices[e][0];
+			const int v1 = mesh_.edge_vertices[e][1];
 			return 0.5 * (point(v0) + point(v1));
 		}
 
@@ -1574,7 +1565,7 @@ namespace polyfem
 			RowVectorNd bary(3);
 			bary.setZero();
 
-			const auto &vertices = mesh_.faces[f].vs;
+			const IndexRange vertices = mesh_.face_vertices[f];
 			for (int lv = 0; lv < n_vertices; ++lv)
 			{
 				bary += point(vertices[lv]);
@@ -1588,7 +1579,7 @@ namespace polyfem
 			RowVectorNd bary(3);
 			bary.setZero();
 
-			const auto &vertices = mesh_.elements[c].vs;
+			const IndexRange vertices = mesh_.element_vertices[c];
 			for (int lv = 0; lv < n_vertices; ++lv)
 			{
 				bary += point(vertices[lv]);
@@ -1679,7 +1670,10 @@ namespace polyfem
 			Mesh::append(mesh);
 
 			const CMesh3D &mesh3d = dynamic_cast<const CMesh3D &>(mesh);
-			mesh_.append(mesh3d.mesh_);
+			Mesh3DStorage other = mesh3d.mesh_;
+			MeshProcessing3D::expand_topology(other);
+			MeshProcessing3D::expand_topology(mesh_);
+			mesh_.append(other);
 
 			Navigation3D::prepare_mesh(mesh_);
 			compute_elements_tag();
@@ -29,27 +29,28 @@ namespace polyfem
 
 			void refine(const int n_refinement, const double t) override;
 
-			int n_cells() const override { return int(mesh_.elements.size()); }
-			int n_faces() const override { return int(mesh_.faces.size()); }
-			int n_edges() const override { return int(mesh_.edges.size()); }
+			int n_cells() const override { return mesh_.n_elements(); }
+			int n_faces() const override { return mesh_.n_faces(); }
+			int n_edges() const override { return mesh_.n_edges(); }
 			int n_vertices() const override { return int(mesh_.points.cols()); }
-
-			inline int n_face_vertices(const int f_id) const override { return mesh_.faces[f_id].vs.size(); }
-			inline int n_cell_vertices(const int c_id) const override { return mesh_.elements[c_id].vs.size(); }
-			inline int n_cell_edges(const int c_id) const override { return mesh_.elements[c_id].es.size(); }
-			inline int n_cell_faces(const int c_id) const override { return mesh_.elements[c_id].fs.size(); }
-			inline int cell_vertex(const int c_id, const int lv_id) const override { return mesh_.elements[c_id].vs[lv_id]; }
-			inline int cell_face(const int c_id, const int lf_id) const override { return mesh_.elements[c_id].fs[lf_id]; }
-			inline int cell_edge(const int c_id, const int le_id) const override { return mesh_.elements[c_id].es[le_id]; }
-			inline int face_vertex(const int f_id, const int lv_id) const override { return mesh_.faces[f_id].vs[lv_id]; }
-			inline int edge_vertex(const int e_id, const int lv_id) const override { return mesh_.edges[e_id].vs[lv_id]; }
+			size_t topology_memory() const override { return mesh_.memory(); }
+
+			inline int n_face_vertices(const int f_id) const override { return mesh_.face_vertices[f_id].size(); }
+			inline int n_cell_vertices(const int c_id) const override { return mesh_.element_vertices[c_id].size(); }
+			inline int n_cell_edges(const int c_id) const override { return mesh_.element_edges[c_id].size(); }
+			inline int n_cell_faces(const int c_id) const override { return mesh_.element_faces[c_id].size(); }
+			inline int cell_vertex(const int c_id, const int lv_id) const override { return mesh_.element_vertices[c_id][lv_id]; }
+			inline int cell_face(const int c_id, const int lf_id) const override { return mesh_.element_faces[c_id][lf_id]; }
+			inline int cell_edge(const int c_id, const int le_id) const override { return mesh_.element_edges[c_id][le_id]; }
+			inline int face_vertex(const int f_id, const int lv_id) const override { return mesh_.face_vertices[f_id][lv_id]; }
+			inline int edge_vertex(const int e_id, const int lv_id) const override { return mesh_.edge_vertices[e_id][lv_id]; }
 
 			void elements_boxes(std::vector<std::array<Eigen::Vector3d, 2>> &boxes) const override;
 			void barycentric_coords(const RowVectorNd &p, const int el_id, Eigen::MatrixXd &coord) const override;
 
-			bool is_boundary_vertex(const int vertex_global_id) const override { return mesh_.vertices[vertex_global_id].boundary; }
-			bool is_boundary_edge(const int edge_global_id) const override { return mesh_.edges[edge_global_id].boundary; }
-			bool is_boundary_face(const int face_global_id) const override { return mesh_.faces[face_global_id].boundary; }
+			bool is_boundary_vertex(const int vertex_global_id) const override { return mesh_.vertex_boundary[vertex_global_id]; }
+			bool is_boundary_edge(const int edge_global_id) const override { return mesh_.edge_boundary[edge_global_id]; }
+			bool is_boundary_face(const int face_global_id) const override { return mesh_.face_boundary[face_global_id]; }
 			bool is_boundary_element(const int element_global_id) const override;
 
 			bool save(const std::string &path) const override;
@@ -80,8 +81,8 @@ namespace polyfem
 			Navigation3D::Index get_index_from_element_edge(int hi, int v0, int v1) const override { return Navigation3D::get_index_from_element_edge(mesh_, hi, v0, v1); }
 			Navigation3D::Index get_index_from_element_face(int hi, int v0, int v1, int v2) const override { return Navigation3D::get_index_from_element_tri(mesh_, hi, v0, v1, v2); }
 
-			inline std::vector<uint32_t> vertex_neighs(const int v_gid) const override { return mesh_.vertices[v_gid].neighbor_hs; }
-			inline std::vector<uint32_t> edge_neighs(const int e_gid) const override { return mesh_.edges[e_gid].neighbor_hs; }
+			inline std::vector<uint32_t> vertex_neighs(const int v_gid) const override { return std::vector<uint32_t>(mesh_.vertex_elements[v_gid].begin(), mesh_.vertex_elements[v_gid].end()); }
+			inline std::vector<uint32_t> edge_neighs(const int e_gid) const override { return std::vector<uint32_t>(mesh_.edge_elements[e_gid].begin(), mesh_.edge_elements[e_gid].end()); }
 
 			// Navigation in a surface mesh
 			Navigation3D::Index switch_vertex(Navigation3D::Index idx) const override { return Navigation3D::switch_vertex(mesh_, idx); }
@@ -96,12 +97,12 @@ namespace polyfem
 			void get_vertex_elements_neighs(const int v_id, std::vector<int> &ids) const override
 			{
 				ids.clear();
-				ids.insert(ids.begin(), mesh_.vertices[v_id].neighbor_hs.begin(), mesh_.vertices[v_id].neighbor_hs.end());
+				ids.insert(ids.begin(), mesh_.vertex_elements[v_id].begin(), mesh_.vertex_elements[v_id].end());
 			}
 			void get_edge_elements_neighs(const int e_id, std::vector<int> &ids) const override
 			{
 				ids.clear();
-				ids.insert(ids.begin(), mesh_.edges[e_id].neighbor_hs.begin(), mesh_.edges[e_id].neighbor_hs.end());
+				ids.insert(ids.begin(), mesh_.edge_elements[e_id].begin(), mesh_.edge_elements[e_id].end());
 			}
 
 			void compute_boundary_ids(const double eps) override;
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <vector>
+#include <cassert>
+#include <cstdint>
 #include <Eigen/Dense>
 
 namespace polyfem
@@ -50,6 +52,49 @@ namespace polyfem
 			std::vector<double> v_in_Kernel;
 		};
 
+		/// read-only view of a list of indices, a row of an Incidence or a std::vector
+		class IndexRange
+		{
+		public:
+			IndexRange() = default;
+			IndexRange(const uint32_t *begin, const uint32_t *end) : begin_(begin), end_(end) {}
+			IndexRange(const std::vector<uint32_t> &v) : begin_(v.data()), end_(v.data() + v.size()) {}
+
+			const uint32_t *begin() const { return begin_; }
+			const uint32_t *end() const { return end_; }
+			size_t size() const { return end_ - begin_; }
+			bool empty() const { return begin_ == end_; }
+
+			uint32_t operator[](const size_t i) const
+			{
+				assert(i < size());
+				return begin_[i];
+			}
+			uint32_t front() const { return (*this)[0]; }
+			uint32_t back() const { return (*this)[size() - 1]; }
+
+		private:
+			const uint32_t *begin_ = nullptr;
+			const uint32_t *end_ = nullptr;
+		};
+
+		/// incidence relation in compressed rows, the row i is indices[offsets[i]], ..., indices[offsets[i + 1] - 1]
+		struct Incidence
+		{
+			std::vector<size_t> offsets;
+			std::vector<uint32_t> indices;
+
+			int size() const { return offsets.empty() ? 0 : int(offsets.size() - 1); }
+			IndexRange operator[](const int i) const { return IndexRange(indices.data() + offsets[i], indices.data() + offsets[i + 1]); }
+
+			void clear()
+			{
+				std::vector<size_t>().swap(offsets);
+				std::vector<uint32_t>().swap(indices);
+			}
+			size_t memory() const { return offsets.capacity() * sizeof(size_t) + indices.capacity() * sizeof(uint32_t); }
+		};
+
 		enum class MeshType
 		{
 			TRI = 0,
@@ -60,6 +105,8 @@ namespace polyfem
 			HEX
 		};
 
+		/// The mesh is edited (loading, refinement, append) through the per entity lists (vertices, edges, faces, elements).
+		/// Navigation3D::prepare_mesh then moves them to the compact topology, the lists stay empty until MeshProcessing3D::expand_topology.
 		class Mesh3DStorage
 		{
 		public:
@@ -74,6 +121,41 @@ namespace polyfem
 			Eigen::MatrixXi FV, FE, FH, FHi; // FV (3, nf), FE(3, nf), FH (2, nf), FHi(2, nf)
 			Eigen::MatrixXi HV, HF;          // HV(4, nh), HE(6, nh), HF(4, nh)
 
+			// compact topology, same ordering and content as the per entity lists
+			Incidence vertex_vertices, vertex_edges, vertex_faces, vertex_elements;
+			Incidence edge_vertices, edge_faces, edge_elements;
+			Incidence face_vertices, face_edges, face_elements;
+			Incidence element_vertices, element_edges, element_faces;
+			/// orientation of the faces of the elements, same layout as element_faces.indices
+			std::vector<bool> element_faces_flag;
+			std::vector<bool> vertex_boundary, edge_boundary, face_boundary;
+			std::vector<bool> element_hex;
+			/// a point in the kernel of every element
+			Eigen::Matrix3Xd element_kernels;
+
+			int n_vertices() const { return points.cols(); }
+			int n_edges() const { return edge_vertices.size(); }
+			int n_faces() const { return face_vertices.size(); }
+			int n_elements() const { return element_vertices.size(); }
+
+			bool element_face_flag(const int h, const int lf) const { return element_faces_flag[element_faces.offsets[h] + lf]; }
+
+			/// bytes used by the points and the topology
+			size_t memory() const
+			{
+				size_t res = (points.size() + element_kernels.size()) * sizeof(double);
+				res += (EV.size() + FV.size() + FE.size() + FH.size() + FHi.size() + HV.size() + HF.size()) * sizeof(int);
+				for (const Incidence *i : {&vertex_vertices, &vertex_edges, &vertex_faces, &vertex_elements,
+										   &edge_vertices, &edge_faces, &edge_elements,
+										   &face_vertices, &face_edges, &face_elements,
+										   &element_vertices, &element_edges, &element_faces})
+					res += i->memory();
+				for (const std::vector<bool> *b : {&element_faces_flag, &vertex_boundary, &edge_boundary, &face_boundary, &element_hex})
+					res += b->capacity() / 8;
+				return res;
+			}
+
+			/// appends the per entity lists of other, both meshes must be expanded
 			void append(const Mesh3DStorage &other)
 			{
 				if (other.type != type)
@@ -1,5 +1,6 @@
 #include "MeshProcessing3D.hpp"
 #include <polyfem/utils/Logger.hpp>
+#include <polyfem/utils/MaybeParallelFor.hpp>
 
 #include <Eigen/Dense>
 
@@ -8,6 +9,7 @@
 #include <set>
 #include <queue>
 #include <iterator>
+#include <numeric>
 #include <cassert>
 
 using namespace polyfem::mesh;
@@ -15,6 +17,178 @@ using namespace polyfem;
 using namespace std;
 using namespace Eigen;
 
+namespace
+{
+	// copies one list of every entity to the rows of res
+	template <typename Entity, typename Rows>
+	void build_incidence(const std::vector<Entity> &entities, Rows rows, Incidence &res)
+	{
+		const int n = entities.size();
+		res.offsets.assign(n + 1, 0);
+		utils::maybe_parallel_for(n, [&](int start, int end, int thread_id) {
+			for (int i = start; i < end; ++i)
+			{
+				assert(entities[i].id == i);
+				res.offsets[i + 1] = rows(entities[i]).size();
+			}
+		});
+		std::partial_sum(res.offsets.begin(), res.offsets.end(), res.offsets.begin());
+
+		res.indices.resize(res.offsets.back());
+		utils::maybe_parallel_for(n, [&](int start, int end, int thread_id) {
+			for (int i = start; i < end; ++i)
+			{
+				const std::vector<uint32_t> &row = rows(entities[i]);
+				std::copy(row.begin(), row.end(), res.indices.begin() + res.offsets[i]);
+			}
+		});
+	}
+
+	template <typename T>
+	void release(std::vector<T> &v)
+	{
+		std::vector<T>().swap(v);
+	}
+} // namespace
+
+void MeshProcessing3D::compact_topology(Mesh3DStorage &hmi)
+{
+	assert(hmi.vertices.size() == hmi.points.cols());
+
+	build_incidence(hmi.vertices, [](const Vertex &v) -> const auto & { return v.neighbor_vs; }, hmi.vertex_vertices);
+	build_incidence(hmi.vertices, [](const Vertex &v) -> const auto & { return v.neighbor_es; }, hmi.vertex_edges);
+	build_incidence(hmi.vertices, [](const Vertex &v) -> const auto & { return v.neighbor_fs; }, hmi.vertex_faces);
+	build_incidence(hmi.vertices, [](const Vertex &v) -> const auto & { return v.neighbor_hs; }, hmi.vertex_elements);
+
+	build_incidence(hmi.edges, [](const Edge &e) -> const auto & { return e.vs; }, hmi.edge_vertices);
+	build_incidence(hmi.edges, [](const Edge &e) -> const auto & { return e.neighbor_fs; }, hmi.edge_faces);
+	build_incidence(hmi.edges, [](const Edge &e) -> const auto & { return e.neighbor_hs; }, hmi.edge_elements);
+
+	build_incidence(hmi.faces, [](const Face &f) -> const auto & { return f.vs; }, hmi.face_vertices);
+	build_incidence(hmi.faces, [](const Face &f) -> const auto & { return f.es; }, hmi.face_edges);
+	build_incidence(hmi.faces, [](const Face &f) -> const auto & { return f.neighbor_hs; }, hmi.face_elements);
+
+	build_incidence(hmi.elements, [](const Element &h) -> const auto & { return h.vs; }, hmi.element_vertices);
+	build_incidence(hmi.elements, [](const Element &h) -> const auto & { return h.es; }, hmi.element_edges);
+	build_incidence(hmi.elements, [](const Element &h) -> const auto & { return h.fs; }, hmi.element_faces);
+
+	// the bits of std::vector<bool> cannot be written concurrently
+	hmi.vertex_boundary.resize(hmi.vertices.size());
+	for (const auto &v : hmi.vertices)
+		hmi.vertex_boundary[v.id] = v.boundary;
+	hmi.edge_boundary.resize(hmi.edges.size());
+	for (const auto &e : hmi.edges)
+		hmi.edge_boundary[e.id] = e.boundary;
+	hmi.face_boundary.resize(hmi.faces.size());
+	for (const auto &f : hmi.faces)
+		hmi.face_boundary[f.id] = f.boundary;
+
+	hmi.element_hex.resize(hmi.elements.size());
+	hmi.element_faces_flag.resize(hmi.element_faces.indices.size());
+	hmi.element_kernels.resize(3, hmi.elements.size());
+	for (const auto &ele : hmi.elements)
+	{
+		hmi.element_hex[ele.id] = ele.hex;
+
+		assert(ele.fs_flag.size() == ele.fs.size());
+		for (int i = 0; i < ele.fs_flag.size(); ++i)
+			hmi.element_faces_flag[hmi.element_faces.offsets[ele.id] + i] = ele.fs_flag[i];
+
+		if (ele.v_in_Kernel.size() == 3)
+			hmi.element_kernels.col(ele.id) = Vector3d(ele.v_in_Kernel[0], ele.v_in_Kernel[1], ele.v_in_Kernel[2]);
+		else
+		{
+			hmi.element_kernels.col(ele.id).setZero();
+			for (const auto vid : ele.vs)
+				hmi.element_kernels.col(ele.id) += hmi.points.col(vid);
+			hmi.element_kernels.col(ele.id) /= ele.vs.size();
+		}
+	}
+
+	release(hmi.vertices);
+	release(hmi.edges);
+	release(hmi.faces);
+	release(hmi.elements);
+}
+
+void MeshProcessing3D::expand_topology(Mesh3DStorage &hmi)
+{
+	const auto to_vector = [](const IndexRange &r) { return std::vector<uint32_t>(r.begin(), r.end()); };
+
+	hmi.vertices.resize(hmi.n_vertices());
+	utils::maybe_parallel_for(hmi.vertices.size(), [&](int start, int end, int thread_id) {
+		for (int i = start; i < end; ++i)
+		{
+			Vertex &v = hmi.vertices[i];
+			v.id = i;
+			v.v.assign(hmi.points.col(i).data(), hmi.points.col(i).data() + 3);
+			v.neighbor_vs = to_vector(hmi.vertex_vertices[i]);
+			v.neighbor_es = to_vector(hmi.vertex_edges[i]);
+			v.neighbor_fs = to_vector(hmi.vertex_faces[i]);
+			v.neighbor_hs = to_vector(hmi.vertex_elements[i]);
+			v.boundary = hmi.vertex_boundary[i];
+			v.boundary_hex = false;
+		}
+	});
+
+	hmi.edges.resize(hmi.n_edges());
+	utils::maybe_parallel_for(hmi.edges.size(), [&](int start, int end, int thread_id) {
+		for (int i = start; i < end; ++i)
+		{
+			Edge &e = hmi.edges[i];
+			e.id = i;
+			e.vs = to_vector(hmi.edge_vertices[i]);
+			e.neighbor_fs = to_vector(hmi.edge_faces[i]);
+			e.neighbor_hs = to_vector(hmi.edge_elements[i]);
+			e.boundary = hmi.edge_boundary[i];
+			e.boundary_hex = false;
+		}
+	});
+
+	hmi.faces.resize(hmi.n_faces());
+	utils::maybe_parallel_for(hmi.faces.size(), [&](int start, int end, int thread_id) {
+		for (int i = start; i < end; ++i)
+		{
+			Face &f = hmi.faces[i];
+			f.id = i;
+			f.vs = to_vector(hmi.face_vertices[i]);
+			f.es = to_vector(hmi.face_edges[i]);
+			f.neighbor_hs = to_vector(hmi.face_elements[i]);
+			f.boundary = hmi.face_boundary[i];
+			f.boundary_hex = false;
+		}
+	});
+
+	hmi.elements.resize(hmi.n_elements());
+	utils::maybe_parallel_for(hmi.elements.size(), [&](int start, int end, int thread_id) {
+		for (int i = start; i < end; ++i)
+		{
+			Element &ele = hmi.elements[i];
+			ele.id = i;
+			ele.vs = to_vector(hmi.element_vertices[i]);
+			ele.es = to_vector(hmi.element_edges[i]);
+			ele.fs = to_vector(hmi.element_faces[i]);
+			ele.fs_flag.resize(ele.fs.size());
+			for (int j = 0; j < ele.fs.size(); ++j)
+				ele.fs_flag[j] = hmi.element_face_flag(i, j);
+			ele.hex = hmi.element_hex[i];
+			ele.v_in_Kernel.assign(hmi.element_kernels.col(i).data(), hmi.element_kernels.col(i).data() + 3);
+		}
+	});
+
+	for (Incidence *i : {&hmi.vertex_vertices, &hmi.vertex_edges, &hmi.vertex_faces, &hmi.vertex_elements,
+						 &hmi.edge_vertices, &hmi.edge_faces, &hmi.edge_elements,
+						 &hmi.face_vertices, &hmi.face_edges, &hmi.face_elements,
+						 &hmi.element_vertices, &hmi.element_edges, &hmi.element_faces})
+		i->clear();
+	release(hmi.element_faces_flag);
+	release(hmi.vertex_boundary);
+	release(hmi.edge_boundary);
+	release(hmi.face_boundary);
+	release(hmi.element_hex);
+	hmi.element_kernels.resize(3, 0);
+}
+
 void MeshProcessing3D::build_connectivity(Mesh3DStorage &hmi)
 {
 	hmi.edges.clear();
@@ -1734,7 +1908,7 @@ void MeshProcessing3D::ele_subdivison_levels(const Mesh3DStorage &hmi, std::vect
 
 // template<typename T>
 // void MeshProcessing3D::set_intersection_own(const std::vector<T> &A, const std::vector<T> &B, std::vector<T> &C, const int &num){
-void MeshProcessing3D::set_intersection_own(const std::vector<uint32_t> &A, const std::vector<uint32_t> &B, std::array<uint32_t, 2> &C, int &num)
+void MeshProcessing3D::set_intersection_own(const IndexRange &A, const IndexRange &B, std::array<uint32_t, 2> &C, int &num)
 {
 	// void MeshProcessing3D::set_intersection_own( std::vector<uint32_t> &A,  std::vector<uint32_t> &B, std::vector<uint32_t> &C, int &num)
 	//  C.resize(num);
@@ -46,6 +46,10 @@ namespace polyfem
 				{2, 3}};
 
 			void build_connectivity(Mesh3DStorage &hmi);
+			// moves the per entity lists to the compact topology and releases them, built in parallel
+			void compact_topology(Mesh3DStorage &hmi);
+			// rebuilds the per entity lists from the compact topology to edit the mesh
+			void expand_topology(Mesh3DStorage &hmi);
 			void reorder_hex_mesh_propogation(Mesh3DStorage &hmi);
 			bool scaled_jacobian(Mesh3DStorage &hmi, Mesh_Quality &mq);
 			double a_jacobian(Eigen::Vector3d &v0, Eigen::Vector3d &v1, Eigen::Vector3d &v2, Eigen::Vector3d &v3);
@@ -61,7 +65,7 @@ namespace polyfem
 			void ele_subdivison_levels(const Mesh3DStorage &hmi, std::vector<int> &Ls);
 
 			// template<typename T>
-			void set_intersection_own(const std::vector<uint32_t> &A, const std::vector<uint32_t> &B, std::array<uint32_t, 2> &C, int &num);
+			void set_intersection_own(const IndexRange &A, const IndexRange &B, std::array<uint32_t, 2> &C, int &num);
 		} // namespace MeshProcessing3D
 	}     // namespace mesh
 } // namespace polyfem
@@ -19,10 +19,14 @@ using namespace std;
 
 void polyfem::mesh::Navigation3D::prepare_mesh(Mesh3DStorage &M)
 {
+	if (M.elements.empty() && M.n_elements() > 0)
+		MeshProcessing3D::expand_topology(M);
+
 	if (M.type != MeshType::TET)
 		M.type = MeshType::HYB;
 	MeshProcessing3D::build_connectivity(M);
 	MeshProcessing3D::global_orientation_hexes(M);
+	MeshProcessing3D::compact_topology(M);
 }
 
 polyfem::mesh::Navigation3D::Index polyfem::mesh::Navigation3D::get_index_from_element_face(const Mesh3DStorage &M, int hi)
@@ -39,11 +43,11 @@ polyfem::mesh::Navigation3D::Index polyfem::mesh::Navigation3D::get_index_from_e
 		idx.vertex = M.FV(0, idx.face);
 		idx.edge = M.FE(0, idx.face);
 
-		if (M.elements[hi].fs_flag[idx.element_patch])
+		if (M.element_face_flag(hi, idx.element_patch))
 			idx.edge = M.FE(2, idx.face);
 		// get_index_from_element_face_time += timer.getElapsedTime();
 	}
-	else if (M.elements[hi].hex)
+	else if (M.element_hex[hi])
 	{
 		idx.element = hi;
 		// idx.element_patch = 0;
@@ -54,25 +58,26 @@ polyfem::mesh::Navigation3D::Index polyfem::mesh::Navigation3D::get_index_from_e
 		// idx.edge = M.faces[idx.face].es[0];
 
 		vector<uint32_t> fvs, fvs_;
-		fvs.insert(fvs.end(), M.elements[hi].vs.begin(), M.elements[hi].vs.begin() + 4);
+		fvs.insert(fvs.end(), M.element_vertices[hi].begin(), M.element_vertices[hi].begin() + 4);
 		sort(fvs.begin(), fvs.end());
 		idx.element_patch = -1;
 
 		for (uint32_t i = 0; i < 6; i++)
 		{
 			idx.element_patch = i;
-			fvs_ = M.faces[M.elements[hi].fs[i]].vs;
+			const IndexRange face_vs = M.face_vertices[M.element_faces[hi][i]];
+			fvs_.assign(face_vs.begin(), face_vs.end());
 			sort(fvs_.begin(), fvs_.end());
 			if (std::equal(fvs.begin(), fvs.end(), fvs_.begin()))
 				break;
 		}
-		idx.face = M.elements[hi].fs[idx.element_patch];
+		idx.face = M.element_faces[hi][idx.element_patch];
 
-		idx.vertex = M.elements[hi].vs[0];
-		idx.face_corner = find(M.faces[idx.face].vs.begin(), M.faces[idx.face].vs.end(), idx.vertex) - M.faces[idx.face].vs.begin();
+		idx.vertex = M.element_vertices[hi][0];
+		idx.face_corner = find(M.face_vertices[idx.face].begin(), M.face_vertices[idx.face].end(), idx.vertex) - M.face_vertices[idx.face].begin();
 
-		int v0 = idx.vertex, v1 = M.elements[hi].vs[1];
-		const vector<uint32_t> &ves0 = M.vertices[v0].neighbor_es, &ves1 = M.vertices[v1].neighbor_es;
+		int v0 = idx.vertex, v1 = M.element_vertices[hi][1];
+		const IndexRange ves0 = M.vertex_edges[v0], ves1 = M.vertex_edges[v1];
 		std::array<uint32_t, 2> sharedes;
 		int num = 1;
 		MeshProcessing3D::set_intersection_own(ves0, ves1, sharedes, num);
@@ -92,24 +97,24 @@ polyfem::mesh::Navigation3D::Index polyfem::mesh::Navigation3D::get_index_from_e
 	// igl::Timer timer; timer.start();
 	Index idx;
 
-	if (hi >= M.elements.size())
-		hi = hi % M.elements.size();
+	if (hi >= M.n_elements())
+		hi = hi % M.n_elements();
 	idx.element = hi;
 
-	if (lf >= M.elements[hi].fs.size())
-		lf = lf % M.elements[hi].fs.size();
+	if (lf >= M.element_faces[hi].size())
+		lf = lf % M.element_faces[hi].size();
 	idx.element_patch = lf;
-	idx.face = M.elements[hi].fs[idx.element_patch];
+	idx.face = M.element_faces[hi][idx.element_patch];
 
-	if (lv >= M.faces[idx.face].vs.size())
-		lv = lv % M.faces[idx.face].vs.size();
+	if (lv >= M.face_vertices[idx.face].size())
+		lv = lv % M.face_vertices[idx.face].size();
 	idx.face_corner = lv;
-	idx.vertex = M.faces[idx.face].vs[idx.face_corner];
+	idx.vertex = M.face_vertices[idx.face][idx.face_corner];
 
 	int ei = idx.face_corner;
-	if (M.elements[hi].fs_flag[idx.element_patch])
-		ei = (idx.face_corner + M.faces[idx.face].vs.size() - 1) % M.faces[idx.face].vs.size();
-	idx.edge = M.faces[idx.face].es[ei];
+	if (M.element_face_flag(hi, idx.element_patch))
+		ei = (idx.face_corner + M.face_vertices[idx.face].size() - 1) % M.face_vertices[idx.face].size();
+	idx.edge = M.face_edges[idx.face][ei];
 	// timer.stop();
 	//  get_index_from_element_face_time += timer.getElapsedTime();
 
@@ -158,20 +163,20 @@ polyfem::mesh::Navigation3D::Index polyfem::mesh::Navigation3D::get_index_from_e
 	}
 	else
 	{
-		for (int i = 0; i < M.elements[hi].fs.size(); i++)
+		for (int i = 0; i < M.element_faces[hi].size(); i++)
 		{
-			const auto &fid = M.elements[hi].fs[i];
-			for (int j = 0; j < M.faces[fid].es.size(); j++)
+			const auto &fid = M.element_faces[hi][i];
+			for (int j = 0; j < M.face_edges[fid].size(); j++)
 			{
-				const auto &eid = M.faces[fid].es[j];
-				assert(M.edges[eid].vs[0] < M.edges[eid].vs[1]);
-				if (M.edges[eid].vs[0] == v0 && M.edges[eid].vs[1] == v1)
+				const auto &eid = M.face_edges[fid][j];
+				assert(M.edge_vertices[eid][0] < M.edge_vertices[eid][1]);
+				if (M.edge_vertices[eid][0] == v0 && M.edge_vertices[eid][1] == v1)
 				{
 					idx.element_patch = i;
 					idx.face = fid;
 					idx.edge = eid;
-					for (int k = 0; k < M.faces[fid].vs.size(); k++)
-						if (M.faces[fid].vs[k] == idx.vertex)
+					for (int k = 0; k < M.face_vertices[fid].size(); k++)
+						if (M.face_vertices[fid][k] == idx.vertex)
 							idx.face_corner = k;
 
 					assert(idx.vertex == v0i);
@@ -259,11 +264,11 @@ polyfem::mesh::Navigation3D::Index polyfem::mesh::Navigation3D::get_index_from_e
 	}
 	else
 	{
-		assert(M.elements[idx.element].fs.size() == 4);
+		assert(M.element_faces[idx.element].size() == 4);
 		for (int i = 0; i < 4; i++)
 		{
-			const auto fid = M.elements[idx.element].fs[i];
-			const auto &fvid = M.faces[fid].vs;
+			const auto fid = M.element_faces[idx.element][i];
+			const IndexRange fvid = M.face_vertices[fid];
 			int fv0 = fvid[0], fv1 = fvid[1], fv2 = fvid[2];
 			if (fv0 > fv2)
 				swap(fv0, fv2);
@@ -284,8 +289,8 @@ polyfem::mesh::Navigation3D::Index polyfem::mesh::Navigation3D::get_index_from_e
 
 			for (int j = 0; j < 3; j++)
 			{
-				const auto eid = M.faces[fid].es[j];
-				const auto &veid = M.edges[eid].vs;
+				const auto eid = M.face_edges[fid][j];
+				const IndexRange veid = M.edge_vertices[eid];
 				assert(veid[0] < veid[1]);
 				if (veid[0] == v0_ && veid[1] == v1_)
 				{
@@ -329,15 +334,15 @@ polyfem::mesh::Navigation3D::Index polyfem::mesh::Navigation3D::switch_vertex(co
 	}
 	else
 	{
-		if (idx.vertex == M.edges[idx.edge].vs[0])
-			idx.vertex = M.edges[idx.edge].vs[1];
+		if (idx.vertex == M.edge_vertices[idx.edge][0])
+			idx.vertex = M.edge_vertices[idx.edge][1];
 		else
-			idx.vertex = M.edges[idx.edge].vs[0];
+			idx.vertex = M.edge_vertices[idx.edge][0];
 
-		int &corner = idx.face_corner, n = M.faces[idx.face].vs.size(), corner_1 = (corner - 1 + n) % n, corner1 = (corner + 1) % n;
-		if (M.faces[idx.face].vs[corner1] == idx.vertex)
+		int &corner = idx.face_corner, n = M.face_vertices[idx.face].size(), corner_1 = (corner - 1 + n) % n, corner1 = (corner + 1) % n;
+		if (M.face_vertices[idx.face][corner1] == idx.vertex)
 			idx.face_corner = corner1;
-		else if (M.faces[idx.face].vs[corner_1] == idx.vertex)
+		else if (M.face_vertices[idx.face][corner_1] == idx.vertex)
 			idx.face_corner = corner_1;
 	}
 	// switch_vertex_time += timer.getElapsedTime();
@@ -357,11 +362,11 @@ polyfem::mesh::Navigation3D::Index polyfem::mesh::Navigation3D::switch_edge(cons
 	}
 	else
 	{
-		int n = M.faces[idx.face].vs.size();
-		if (idx.edge == M.faces[idx.face].es[idx.face_corner])
-			idx.edge = M.faces[idx.face].es[(idx.face_corner - 1 + n) % n];
+		int n = M.face_vertices[idx.face].size();
+		if (idx.edge == M.face_edges[idx.face][idx.face_corner])
+			idx.edge = M.face_edges[idx.face][(idx.face_corner - 1 + n) % n];
 		else
-			idx.edge = M.faces[idx.face].es[idx.face_corner];
+			idx.edge = M.face_edges[idx.face][idx.face_corner];
 	}
 	// switch_edge_time += timer.getElapsedTime();
 	return idx;
@@ -393,7 +398,7 @@ polyfem::mesh::Navigation3D::Index polyfem::mesh::Navigation3D::switch_face(cons
 	}
 	else
 	{
-		const vector<uint32_t> &efs = M.edges[idx.edge].neighbor_fs, &hfs = M.elements[idx.element].fs;
+		const IndexRange efs = M.edge_faces[idx.edge], hfs = M.element_faces[idx.element];
 		std::array<uint32_t, 2> sharedfs;
 		int num = 2;
 		MeshProcessing3D::set_intersection_own(efs, hfs, sharedfs, num);
@@ -408,7 +413,7 @@ polyfem::mesh::Navigation3D::Index polyfem::mesh::Navigation3D::switch_face(cons
 				break;
 			}
 
-		const vector<uint32_t> &fvs = M.faces[idx.face].vs;
+		const IndexRange fvs = M.face_vertices[idx.face];
 		for (int i = 0; i < fvs.size(); i++)
 			if (idx.vertex == fvs[i])
 			{
@@ -446,19 +451,19 @@ polyfem::mesh::Navigation3D::Index polyfem::mesh::Navigation3D::switch_element(c
 	}
 	else
 	{
-		if (M.faces[idx.face].neighbor_hs.size() == 1)
+		if (M.face_elements[idx.face].size() == 1)
 		{
 			idx.element = -1;
 			return idx;
 		}
 		else
 		{
-			if (M.faces[idx.face].neighbor_hs[0] == idx.element)
-				idx.element = M.faces[idx.face].neighbor_hs[1];
+			if (M.face_elements[idx.face][0] == idx.element)
+				idx.element = M.face_elements[idx.face][1];
 			else
-				idx.element = M.faces[idx.face].neighbor_hs[0];
+				idx.element = M.face_elements[idx.face][0];
 
-			const vector<uint32_t> &fs = M.elements[idx.element].fs;
+			const IndexRange fs = M.element_faces[idx.element];
 			for (int i = 0; i < fs.size(); i++)
 				if (idx.face == fs[i])
 				{
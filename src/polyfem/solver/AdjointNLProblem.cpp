@@ -3,6 +3,7 @@
 #include <polyfem/solver/forms/adjoint_forms/CompositeForm.hpp>
 #include <polyfem/utils/Logger.hpp>
 #include <polyfem/utils/MaybeParallelFor.hpp>
+#include <polyfem/utils/par_for.hpp>
 #include <polyfem/utils/Timer.hpp>
 #include <polyfem/io/OBJWriter.hpp>
 #include <polyfem/State.hpp>
@@ -11,6 +12,14 @@
 
 #include <polyfem/solver/NLProblem.hpp>
 
+#ifdef POLYFEM_WITH_TBB
+#include <tbb/task_arena.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+
 namespace polyfem::solver
 {
 	AdjointNLProblem::AdjointNLProblem(std::shared_ptr<CompositeForm> composite_form, const std::vector<std::shared_ptr<VariableToSimulation>> &variables_to_simulation, const std::vector<std::shared_ptr<State>> &all_states, const json &args)
@@ -42,6 +51,12 @@ namespace polyfem::solver
 				solve_in_order.push_back(i);
 		}
 
+		for (const auto &state : all_states_)
+			state->diff_cached.set_storage(args["solver"]["advanced"]["checkpointing"]);
+
+		forward_times.assign(all_states_.size(), 0);
+		adjoint_times.assign(all_states_.size(), 0);
+
 		active_state_mask.assign(all_states_.size(), false);
 		for (int i = 0; i < all_states_.size(); i++)
 		{
@@ -84,8 +99,19 @@ namespace polyfem::solver
 
 			{
 				POLYFEM_SCOPED_TIMER("adjoint solve");
+				// the forms are not thread safe (they log and keep state while evaluated),
+				// so the adjoint rhs are assembled serially and only the adjoint solves run in parallel
+				std::vector<Eigen::MatrixXd> adjoint_rhs(all_states_.size());
 				for (int i = 0; i < all_states_.size(); i++)
-					all_states_[i]->solve_adjoint_cached(composite_form_->compute_adjoint_rhs(x, *all_states_[i])); // caches inside state
+					adjoint_rhs[i] = composite_form_->compute_adjoint_rhs(x, *all_states_[i]);
+
+				std::vector<int> states(all_states_.size());
+				std::iota(states.begin(), states.end(), 0);
+				run_state_jobs(
+					states, [&](const int i) {
+						all_states_[i]->solve_adjoint_cached(adjoint_rhs[i]); // caches inside state
+					},
+					adjoint_times);
 			}
 
 			{
@@ -224,42 +250,81 @@ namespace polyfem::solver
 		all_states_[0]->set_log_level(static_cast<spdlog::level::level_enum>(solve_log_level)); // log level is global, only need to change in one state
 		
 		if (solve_in_parallel)
-		{
 			logger().info("Run simulations in parallel...");
 
-			utils::maybe_parallel_for(all_states_.size(), [&](int start, int end, int thread_id) {
-				for (int i = start; i < end; i++)
-				{
-					auto state = all_states_[i];
-					if (active_state_mask[i] || state->diff_cached.size() == 0)
-					{
-						state->assemble_rhs();
-						state->assemble_mass_mat();
-						Eigen::MatrixXd sol, pressure; // solution is also cached in state
-						state->solve_problem(sol, pressure);
-					}
-				}
-			});
+		std::vector<int> states;
+		for (int i : solve_in_order)
+		{
+			if (active_state_mask[i] || all_states_[i]->diff_cached.size() == 0)
+				states.push_back(i);
+		}
+
+		run_state_jobs(
+			states, [&](const int i) {
+				auto state = all_states_[i];
+				state->assemble_rhs();
+				state->assemble_mass_mat();
+				Eigen::MatrixXd sol, pressure; // solution is also cached in state
+				state->solve_problem(sol, pressure);
+			},
+			forward_times);
+
+		all_states_[0]->set_log_level(cur_log_level);
+
+		cur_grad.resize(0);
+	}
+
+	void AdjointNLProblem::run_state_jobs(const std::vector<int> &states, const std::function<void(int)> &job, std::vector<double> &times) const
+	{
+		const auto timed_job = [&](const int i) {
+			times[i] = 0;
+			utils::Timer timer(times[i]);
+			job(i);
+		};
+
+		if (!solve_in_parallel || states.size() <= 1)
+		{
+			for (int i : states)
+				timed_job(i);
 		}
 		else
 		{
-			Eigen::MatrixXd sol, pressure; // solution is also cached in state
-			for (int i : solve_in_order)
-			{
-				auto state = all_states_[i];
-				if (active_state_mask[i] || state->diff_cached.size() == 0)
+			// longest processing time first, the states have not been timed yet on the first run
+			std::vector<int> order = states;
+			std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return times[a] > times[b]; });
+
+			double total_time = 0;
+			for (int i : states)
+				total_time += times[i];
+			const int n_threads = utils::get_n_threads();
+
+			// every worker pulls the next state from the queue when it is done with the previous one
+			std::atomic<int> next(0);
+			utils::maybe_parallel_for(order.size(), [&](int start, int end, int thread_id) {
+				for (int k = next++; k < order.size(); k = next++)
 				{
-					state->assemble_rhs();
-					state->assemble_mass_mat();
-
-					state->solve_problem(sol, pressure);
+					const int i = order[k];
+#ifdef POLYFEM_WITH_TBB
+					// the threads used inside the solve are proportional to the expected cost of the state
+					const int n_state_threads = total_time > 0
+													? std::clamp(int(std::round(n_threads * times[i] / total_time)), 1, n_threads)
+													: std::max(1, n_threads / int(order.size()));
+					tbb::task_arena arena(n_state_threads);
+					arena.execute([&]() { timed_job(i); });
+#else
+					timed_job(i);
+#endif
 				}
-			}
+			});
 		}
 
-		all_states_[0]->set_log_level(cur_log_level);
+		if (states.empty())
+			return;
 
-		cur_grad.resize(0);
+		const auto slowest = std::max_element(states.begin(), states.end(), [&](int a, int b) { return times[a] < times[b]; });
+		for (int i : states)
+			logger().debug("State {} solved in {:.3g}s", i, times[i]);
+		logger().info("Solved {} states, slowest is state {} ({:.3g}s)", states.size(), *slowest, times[*slowest]);
 	}
 
 	bool AdjointNLProblem::stop(const TVector &x)
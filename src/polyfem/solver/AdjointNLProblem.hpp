@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <polyfem/Common.hpp>
 #include "FullNLProblem.hpp"
@@ -45,6 +46,10 @@ namespace polyfem::solver
 		std::shared_ptr<State> get_state(int id) { return all_states_[id]; }
 
 	private:
+		// runs job(i) for every state i in states and stores its wall time in times[i]
+		// in parallel the states are scheduled longest first, using the times of the previous run
+		void run_state_jobs(const std::vector<int> &states, const std::function<void(int)> &job, std::vector<double> &times) const;
+
 		std::shared_ptr<CompositeForm> composite_form_;
 		std::vector<std::shared_ptr<VariableToSimulation>> variables_to_simulation_;
 		std::vector<std::shared_ptr<State>> all_states_;
@@ -59,6 +64,10 @@ namespace polyfem::solver
 		std::vector<int> solve_in_order;
 		const bool better_initial_guess;
 
+		// wall time of the last forward and adjoint solve of every state
+		std::vector<double> forward_times;
+		std::vector<double> adjoint_times;
+
 		std::vector<std::shared_ptr<AdjointForm>> stopping_conditions_; // if all the stopping conditions are non-positive, stop the optimization
 	};
 } // namespace polyfem::solver
@@ -0,0 +1,151 @@
+#include "DiffCache.hpp"
+
+#include <polyfem/io/MatrixIO.hpp>
+#include <polyfem/utils/Logger.hpp>
+
+#include <filesystem>
+#include <random>
+
+namespace polyfem::solver
+{
+	void DiffCache::set_storage(const json &checkpointing)
+	{
+		const std::string mode = checkpointing["storage"];
+		StorageMode storage_mode;
+		if (mode == "memory")
+			storage_mode = StorageMode::MEMORY;
+		else if (mode == "recompute")
+			storage_mode = StorageMode::RECOMPUTE;
+		else if (mode == "disk")
+			storage_mode = StorageMode::DISK;
+		else
+			log_and_throw_error("Unknown adjoint storage mode {}!", mode);
+
+		set_storage(storage_mode, checkpointing["checkpoints"].get<int>(), checkpointing["directory"].get<std::string>());
+	}
+
+	void DiffCache::cache_quantities_transient(
+		const int cur_step,
+		const int cur_bdf_order,
+		const Eigen::MatrixXd &u,
+		const Eigen::MatrixXd &v,
+		const Eigen::MatrixXd &acc,
+		const StiffnessMatrix &gradu_h,
+		// const StiffnessMatrix &gradu_h_prev,
+		const ipc::CollisionConstraints &contact_set,
+		const ipc::FrictionConstraints &friction_constraint_set,
+		const double barrier_stiffness)
+	{
+		bdf_order_(cur_step) = cur_bdf_order;
+		barrier_stiffness_(cur_step) = barrier_stiffness;
+
+		u_.col(cur_step) = u;
+		v_.col(cur_step) = v;
+		acc_.col(cur_step) = acc;
+
+		// the lagged friction constraints cannot be recomputed from the solution, they are always kept
+		friction_constraint_set_[cur_step] = friction_constraint_set;
+
+		if (is_checkpoint(cur_step))
+		{
+			gradu_h_[cur_step] = gradu_h;
+			// gradu_h_prev_[cur_step] = gradu_h_prev;
+			contact_set_[cur_step] = contact_set;
+		}
+		else if (storage_.mode == StorageMode::DISK)
+		{
+			const std::string path = spill_path(cur_step);
+			if (!io::write_sparse_matrix_binary(path, gradu_h))
+				log_and_throw_error("Unable to spill the adjoint Jacobian of step {} to {}!", cur_step, path);
+			spilled_files_[cur_step] = path;
+
+			gradu_h_[cur_step] = StiffnessMatrix();
+			contact_set_[cur_step] = contact_set;
+		}
+		else
+		{
+			gradu_h_[cur_step] = StiffnessMatrix();
+			contact_set_[cur_step] = ipc::CollisionConstraints();
+		}
+
+		cur_size_++;
+	}
+
+	StiffnessMatrix DiffCache::gradu_h(const int step) const
+	{
+		assert(step < size());
+
+		if (is_checkpoint(step))
+			return gradu_h_[step];
+
+		StiffnessMatrix gradu_h;
+		if (storage_.mode == StorageMode::DISK)
+		{
+			if (!io::read_sparse_matrix_binary(spilled_files_[step], gradu_h))
+				log_and_throw_error("Unable to read the adjoint Jacobian of step {} from {}!", step, spilled_files_[step]);
+		}
+		else
+		{
+			if (!recompute_)
+				log_and_throw_error("Adjoint Jacobian of step {} was not stored and cannot be recomputed!", step);
+			logger().trace("Recomputing the adjoint Jacobian of step {}", step);
+			recompute_(step, &gradu_h, nullptr);
+		}
+
+		return gradu_h;
+	}
+
+	ipc::CollisionConstraints DiffCache::contact_set(const int step) const
+	{
+		assert(step < size());
+
+		if (storage_.mode != StorageMode::RECOMPUTE || is_checkpoint(step))
+			return contact_set_[step];
+
+		if (!recompute_)
+			log_and_throw_error("Contact set of step {} was not stored and cannot be recomputed!", step);
+
+		ipc::CollisionConstraints contact_set;
+		recompute_(step, nullptr, &contact_set);
+		return contact_set;
+	}
+
+	std::string DiffCache::spill_path(const int step)
+	{
+		if (spill_directory_.empty())
+		{
+			const std::filesystem::path dir = storage_.directory.empty() ? std::filesystem::temp_directory_path() : std::filesystem::path(storage_.directory);
+			if (!std::filesystem::exists(dir))
+				std::filesystem::create_directories(dir);
+
+			// create_directory fails if the name is taken, by another cache of this or of another process
+			std::random_device rd;
+			for (int attempt = 0; attempt < 100 && spill_directory_.empty(); ++attempt)
+			{
+				const std::filesystem::path candidate = dir / fmt::format("polyfem_diff_cache_{:016x}", (uint64_t(rd()) << 32) | rd());
+				if (std::filesystem::create_directory(candidate))
+					spill_directory_ = candidate.string();
+			}
+
+			if (spill_directory_.empty())
+				log_and_throw_error("Unable to create a directory for the adjoint Jacobians in {}!", dir.string());
+		}
+
+		return (std::filesystem::path(spill_directory_) / fmt::format("step_{}.bin", step)).string();
+	}
+
+	void DiffCache::remove_spilled_files()
+	{
+		for (std::string &path : spilled_files_)
+			path.clear();
+
+		if (spill_directory_.empty())
+			return;
+
+		std::error_code ec;
+		std::filesystem::remove_all(spill_directory_, ec);
+		if (ec)
+			logger().warn("Unable to remove {}: {}", spill_directory_, ec.message());
+		spill_directory_.clear();
+	}
+} // namespace polyfem::solver
@@ -1,33 +1,100 @@
 #pragma once
 
 #include <polyfem/Common.hpp>
+#include <polyfem/utils/Types.hpp>
 
 #include <ipc/ipc.hpp>
 
+#include <functional>
+#include <memory>
+
+namespace polysolve
+{
+    class LinearSolver;
+}
+
 namespace polyfem::solver
 {
     class DiffCache
     {
     public:
+        /// How the per time step Jacobians and contact sets of a transient forward solve are kept for the adjoint solve
+        enum class StorageMode
+        {
+            MEMORY,    ///< keep every step in memory
+            RECOMPUTE, ///< keep only the checkpoint steps in memory, recompute the others from the cached solutions
+            DISK       ///< keep only the checkpoint steps in memory, spill the Jacobians of the others to disk
+        };
+
+        /// Recomputes the force Jacobian and/or the contact set of a time step (nullptr if not requested)
+        typedef std::function<void(const int step, StiffnessMatrix *gradu_h, ipc::CollisionConstraints *contact_set)> RecomputeCallback;
+
+        DiffCache() = default;
+        ~DiffCache() { remove_spilled_files(); }
+
+        // the spilled files belong to a single cache, which removes them
+        DiffCache(const DiffCache &) = delete;
+        DiffCache &operator=(const DiffCache &) = delete;
+
+        /// @brief Set the storage of the per step quantities, taken into account at the next init
+        /// @param mode storage mode
+        /// @param checkpoints number of time steps kept in memory (the last ones, first visited by the backward sweep), negative to keep all
+        /// @param directory where the Jacobians are spilled in DISK mode (in a subdirectory unique to this cache), system temporary directory if empty
+        void set_storage(const StorageMode mode, const int checkpoints, const std::string &directory = "")
+        {
+            requested_storage_.mode = mode;
+            requested_storage_.checkpoints = checkpoints;
+            requested_storage_.directory = directory;
+        }
+
+        /// @brief Set the storage from the optimization json ("solver/advanced/checkpointing")
+        void set_storage(const json &checkpointing);
+
+        void set_recompute_callback(const RecomputeCallback &recompute) { recompute_ = recompute; }
+
         void init(const int ndof, const int n_time_steps = 0)
         {
+            remove_spilled_files();
+            storage_ = requested_storage_;
+
             cur_size_ = 0;
             n_time_steps_ = n_time_steps;
-            
+
             u_.setZero(ndof, n_time_steps + 1);
             if (n_time_steps_ > 0)
             {
                 bdf_order_.setZero(n_time_steps + 1);
+                barrier_stiffness_.setZero(n_time_steps + 1);
                 v_.setZero(ndof, n_time_steps + 1);
                 acc_.setZero(ndof, n_time_steps + 1);
                 // gradu_h_prev_.resize(n_time_steps + 1);
             }
+            gradu_h_.clear();
             gradu_h_.resize(n_time_steps + 1);
+            spilled_files_.assign(n_time_steps + 1, "");
 
+            contact_set_.clear();
             contact_set_.resize(n_time_steps + 1);
+            friction_constraint_set_.clear();
             friction_constraint_set_.resize(n_time_steps + 1);
+
+            adjoint_solver_ = nullptr;
+            adjoint_solver_exact_ = false;
+        }
+
+        /// @brief Check if the Jacobian and the contact set of a step are kept in memory
+        /// Static solves and the initial step are always kept, since there is no history to recompute them from.
+        bool is_checkpoint(const int step) const
+        {
+            return storage_.mode == StorageMode::MEMORY
+                   || storage_.checkpoints < 0
+                   || step == 0
+                   || step > n_time_steps_ - storage_.checkpoints;
         }
 
+        /// @brief Check if the Jacobian and the contact set of a step need to be computed during the forward solve
+        bool needs_quantities(const int step) const { return storage_.mode != StorageMode::RECOMPUTE || is_checkpoint(step); }
+
         void cache_quantities_static(
             const Eigen::MatrixXd &u,
             const StiffnessMatrix &gradu_h,
@@ -52,28 +119,27 @@ namespace polyfem::solver
             const StiffnessMatrix &gradu_h,
             // const StiffnessMatrix &gradu_h_prev,
             const ipc::CollisionConstraints &contact_set,
-            const ipc::FrictionConstraints &friction_constraint_set)
+            const ipc::FrictionConstraints &friction_constraint_set,
+            const double barrier_stiffness = 0);
+
+        /// @brief Cache a factorization for the static adjoint solves of the current forward solution
+        /// @param solver linear solver holding the factorization
+        /// @param exact true if it is the factorization of gradu_h(0), false if it is of a nearby matrix (e.g., the last Newton Hessian)
+        /// Const since it is filled lazily by the adjoint solve.
+        void cache_adjoint_solver(const std::shared_ptr<polysolve::LinearSolver> &solver, const bool exact) const
         {
-            bdf_order_(cur_step) = cur_bdf_order;
-
-            u_.col(cur_step) = u;
-            v_.col(cur_step) = v;
-            acc_.col(cur_step) = acc;
-
-            gradu_h_[cur_step] = gradu_h;
-            // gradu_h_prev_[cur_step] = gradu_h_prev;
-
-            contact_set_[cur_step] = contact_set;
-            friction_constraint_set_[cur_step] = friction_constraint_set;
-
-            cur_size_++;
+            adjoint_solver_ = solver;
+            adjoint_solver_exact_ = solver != nullptr && exact;
         }
+        const std::shared_ptr<polysolve::LinearSolver> &adjoint_solver() const { return adjoint_solver_; }
+        bool is_adjoint_solver_exact() const { return adjoint_solver_exact_; }
 
         void cache_adjoints(const Eigen::MatrixXd &adjoint_mat) { adjoint_mat_ = adjoint_mat; }
         const Eigen::MatrixXd &adjoint_mat() const { return adjoint_mat_; }
 
         inline int size() const { return cur_size_; }
         inline int bdf_order(const int step) const { assert(step < size()); return bdf_order_(step); }
+        inline double barrier_stiffness(const int step) const { assert(step < size()); return barrier_stiffness_(step); }
 
         Eigen::VectorXd u(const int step) const { assert(step < size()); return u_.col(step); }
         Eigen::VectorXd v(const int step) const { assert(step < size()); return v_.col(step); }
@@ -82,17 +148,31 @@ namespace polyfem::solver
         void cache_disp_grad(const Eigen::MatrixXd &disp_grad) { disp_grad_ = disp_grad; }
         Eigen::MatrixXd disp_grad() const { assert(disp_grad_.size() > 0); return disp_grad_; }
 
-        const StiffnessMatrix &gradu_h(const int step) const { assert(step < size()); return gradu_h_[step]; }
+        /// Returned by value, since it can be read back from disk or recomputed
+        StiffnessMatrix gradu_h(const int step) const;
         // const StiffnessMatrix &gradu_h_prev(const int step) const { assert(step < size()); return gradu_h_prev_[step]; }
 
-        const ipc::CollisionConstraints &contact_set(const int step) const { assert(step < size()); return contact_set_[step]; }
+        /// Returned by value, since it can be recomputed
+        ipc::CollisionConstraints contact_set(const int step) const;
         const ipc::FrictionConstraints &friction_constraint_set(const int step) const { assert(step < size()); return friction_constraint_set_[step]; }
 
     private:
+        std::string spill_path(const int step);
+        void remove_spilled_files();
 
         int n_time_steps_ = 0;
         int cur_size_ = 0;
-    
+
+        struct Storage
+        {
+            StorageMode mode = StorageMode::MEMORY;
+            int checkpoints = -1;
+            std::string directory;
+        };
+        Storage storage_; // used by the current forward solve
+        Storage requested_storage_; // used from the next forward solve on
+        RecomputeCallback recompute_;
+
         Eigen::MatrixXd u_; // PDE solution
         Eigen::MatrixXd v_; // velocity in transient elastic simulations
         Eigen::MatrixXd acc_; // acceleration in transient elastic simulations
@@ -100,13 +180,19 @@ namespace polyfem::solver
         Eigen::MatrixXd disp_grad_; // macro linear displacement in homogenization
 
         Eigen::VectorXi bdf_order_; // BDF orders used at each time step in forward simulation
-        
+        Eigen::VectorXd barrier_stiffness_; // barrier stiffness used at each time step in forward simulation
+
         std::vector<StiffnessMatrix> gradu_h_; // gradient of force at time T wrt. u  at time T
         // std::vector<StiffnessMatrix> gradu_h_prev_; // gradient of force at time T wrt. u at time (T-1) in transient simulations
+        std::vector<std::string> spilled_files_; // files of the Jacobians spilled to disk, empty if in memory
+        std::string spill_directory_; // directory owned by this cache holding the spilled files, created at the first spill
 
         std::vector<ipc::CollisionConstraints> contact_set_;
         std::vector<ipc::FrictionConstraints> friction_constraint_set_;
 
         Eigen::MatrixXd adjoint_mat_;
+
+        mutable std::shared_ptr<polysolve::LinearSolver> adjoint_solver_; // factorization reused by the static adjoint solves
+        mutable bool adjoint_solver_exact_ = false;
     };
-}
\ No newline at end of file
+}
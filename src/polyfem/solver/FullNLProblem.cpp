@@ -1,5 +1,10 @@
 #include "FullNLProblem.hpp"
 
+#include <polyfem/utils/Logger.hpp>
+#include <polyfem/utils/Timer.hpp>
+
+#include <algorithm>
+
 namespace polyfem::solver
 {
 	FullNLProblem::FullNLProblem(const std::vector<std::shared_ptr<Form>> &forms)
@@ -19,6 +24,12 @@ namespace polyfem::solver
 			f->set_project_to_psd(project_to_psd);
 	}
 
+	void FullNLProblem::set_hessian_expected(bool val)
+	{
+		for (auto &f : forms_)
+			f->set_hessian_expected(val);
+	}
+
 	void FullNLProblem::init_lagging(const TVector &x)
 	{
 		for (auto &f : forms_)
@@ -88,8 +99,12 @@ namespace polyfem::solver
 	{
 		double val = 0;
 		for (auto &f : forms_)
-			if (f->enabled())
-				val += f->value(x);
+		{
+			if (!f->enabled())
+				continue;
+			POLYFEM_TRACE_SCOPE(f->name() + " value");
+			val += f->value(x);
+		}
 		return val;
 	}
 
@@ -100,6 +115,7 @@ namespace polyfem::solver
 		{
 			if (!f->enabled())
 				continue;
+			POLYFEM_TRACE_SCOPE(f->name() + " gradient");
 			TVector tmp;
 			f->first_derivative(x, tmp);
 			grad += tmp;
@@ -108,14 +124,166 @@ namespace polyfem::solver
 
 	void FullNLProblem::hessian(const TVector &x, THessian &hessian)
 	{
-		hessian.resize(x.size(), x.size());
-		for (auto &f : forms_)
+		assemble_hessian(x, Eigen::VectorXi(), x.size(), hessian);
+	}
+
+	void FullNLProblem::assemble_hessian(const TVector &x, const Eigen::VectorXi &dof_map, const int out_size, THessian &hessian)
+	{
+		assert(dof_map.size() == 0 || dof_map.size() == x.size());
+
+		form_hessians_.resize(forms_.size());
+
+		const bool same_union = hessian_patterns_.size() == forms_.size()
+								&& hessian_cache_.rows() == out_size
+								&& hessian_dof_map_.size() == dof_map.size()
+								&& hessian_dof_map_ == dof_map;
+
+		for (size_t i = 0; i < forms_.size(); ++i)
 		{
-			if (!f->enabled())
+			THessian &tmp = form_hessians_[i];
+			if (forms_[i]->enabled())
+			{
+				POLYFEM_TRACE_SCOPE(forms_[i]->name() + " hessian");
+				forms_[i]->second_derivative(x, tmp);
+				tmp.makeCompressed();
+				assert(tmp.rows() == x.size() && tmp.cols() == x.size());
+			}
+			else
+			{
+				tmp.resize(0, 0);
+			}
+
+			// only the map of the form is rebuilt, the union of the static forms (elastic, inertia, ...) is kept
+			if (same_union && !has_same_pattern(hessian_patterns_[i], tmp))
+				build_form_slots(i);
+		}
+
+		if (!same_union)
+			build_hessian_pattern(dof_map, out_size);
+
+		{
+			POLYFEM_SCOPED_TIMER("scatter hessian");
+
+			double *values = hessian_cache_.valuePtr();
+			std::fill(values, values + hessian_cache_.nonZeros(), 0.0);
+
+			std::vector<Eigen::Triplet<double>> overflow;
+			for (size_t i = 0; i < forms_.size(); ++i)
+			{
+				const double *form_values = form_hessians_[i].valuePtr();
+				const std::vector<long> &slots = hessian_patterns_[i].slots;
+				for (size_t k = 0; k < slots.size(); ++k)
+				{
+					if (slots[k] >= 0)
+						values[slots[k]] += form_values[k];
+				}
+
+				for (const auto &[r, c, k] : hessian_patterns_[i].overflow)
+					overflow.emplace_back(r, c, form_values[k]);
+			}
+
+			if (overflow.empty())
+				hessian = hessian_cache_;
+			else
+			{
+				// new entries of the forms whose pattern changed (e.g., new contacts)
+				THessian extra(out_size, out_size);
+				extra.setFromTriplets(overflow.begin(), overflow.end());
+				hessian = hessian_cache_ + extra;
+			}
+		}
+	}
+
+	bool FullNLProblem::has_same_pattern(const FormHessianPattern &pattern, const THessian &hessian) const
+	{
+		assert(hessian.isCompressed());
+
+		if (pattern.outer.size() != size_t(hessian.outerSize() + 1) || pattern.inner.size() != size_t(hessian.nonZeros()))
+			return false;
+
+		return std::equal(pattern.outer.begin(), pattern.outer.end(), hessian.outerIndexPtr())
+			   && std::equal(pattern.inner.begin(), pattern.inner.end(), hessian.innerIndexPtr());
+	}
+
+	void FullNLProblem::build_hessian_pattern(const Eigen::VectorXi &dof_map, const int out_size)
+	{
+		POLYFEM_SCOPED_TIMER("build hessian pattern");
+
+		const auto map_dof = [&dof_map](const long i) -> long { return dof_map.size() == 0 ? i : dof_map(i); };
+
+		// union of the patterns of all forms, without the dropped DOFs
+		std::vector<Eigen::Triplet<double>> entries;
+		size_t n_entries = 0;
+		for (const auto &tmp : form_hessians_)
+			n_entries += tmp.nonZeros();
+		entries.reserve(n_entries);
+
+		for (const auto &tmp : form_hessians_)
+		{
+			for (long k = 0; k < tmp.outerSize(); ++k)
+			{
+				const long c = map_dof(k);
+				if (c < 0)
+					continue;
+
+				for (THessian::InnerIterator it(tmp, k); it; ++it)
+				{
+					const long r = map_dof(it.row());
+					if (r >= 0)
+						entries.emplace_back(r, c, 0.0);
+				}
+			}
+		}
+
+		hessian_cache_.resize(out_size, out_size);
+		hessian_cache_.setFromTriplets(entries.begin(), entries.end());
+		hessian_cache_.makeCompressed();
+		hessian_dof_map_ = dof_map;
+
+		// scatter map of every form into the union pattern
+		hessian_patterns_.resize(forms_.size());
+		for (size_t i = 0; i < forms_.size(); ++i)
+			build_form_slots(i);
+
+		logger().trace("Rebuilt hessian sparsity pattern ({} non-zeros)", hessian_cache_.nonZeros());
+	}
+
+	void FullNLProblem::build_form_slots(const size_t i)
+	{
+		const Eigen::VectorXi &dof_map = hessian_dof_map_;
+		const auto map_dof = [&dof_map](const long d) -> long { return dof_map.size() == 0 ? d : dof_map(d); };
+
+		const THessian::StorageIndex *cache_outer = hessian_cache_.outerIndexPtr();
+		const THessian::StorageIndex *cache_inner = hessian_cache_.innerIndexPtr();
+
+		const THessian &tmp = form_hessians_[i];
+		FormHessianPattern &pattern = hessian_patterns_[i];
+
+		pattern.outer.assign(tmp.outerIndexPtr(), tmp.outerIndexPtr() + tmp.outerSize() + 1);
+		pattern.inner.assign(tmp.innerIndexPtr(), tmp.innerIndexPtr() + tmp.nonZeros());
+		pattern.slots.assign(tmp.nonZeros(), -1);
+		pattern.overflow.clear();
+
+		for (long k = 0; k < tmp.outerSize(); ++k)
+		{
+			const long c = map_dof(k);
+			if (c < 0)
 				continue;
-			THessian tmp;
-			f->second_derivative(x, tmp);
-			hessian += tmp;
+
+			for (long p = pattern.outer[k]; p < pattern.outer[k + 1]; ++p)
+			{
+				const long r = map_dof(pattern.inner[p]);
+				if (r < 0)
+					continue;
+
+				const THessian::StorageIndex *begin = cache_inner + cache_outer[c];
+				const THessian::StorageIndex *end = cache_inner + cache_outer[c + 1];
+				const THessian::StorageIndex *pos = std::lower_bound(begin, end, THessian::StorageIndex(r));
+				if (pos != end && *pos == r)
+					pattern.slots[p] = pos - cache_inner;
+				else
+					pattern.overflow.push_back({{r, c, p}});
+			}
 		}
 	}
 
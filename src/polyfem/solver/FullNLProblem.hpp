@@ -4,6 +4,7 @@
 
 #include <cppoptlib/problem.h>
 
+#include <array>
 #include <memory>
 #include <vector>
 
@@ -35,6 +36,8 @@ namespace polyfem::solver
 		virtual void post_step(const int iter_num, const TVector &x);
 
 		virtual void set_project_to_psd(bool val);
+		/// @brief Tell the forms that the Hessian will be requested at the point of the next gradient
+		void set_hessian_expected(bool val);
 
 		virtual void solution_changed(const TVector &new_x);
 
@@ -49,6 +52,35 @@ namespace polyfem::solver
 		virtual bool stop(const TVector &x) { return false; }
 
 	protected:
+		/// @brief Sum the Hessians of the enabled forms into a matrix with a cached sparsity pattern.
+		/// Each form scatters its values through a cached index map. The union pattern is built once,
+		/// when the pattern of a form (e.g., contact) changes only its map is rebuilt and its entries
+		/// outside of the union are added on top.
+		/// @param[in] x Full size solution
+		/// @param[in] dof_map Maps the full DOFs to the rows/cols of the output, -1 drops the DOF (empty keeps all DOFs)
+		/// @param[in] out_size Size of the output matrix
+		/// @param[out] hessian Sum of the Hessians of the forms
+		void assemble_hessian(const TVector &x, const Eigen::VectorXi &dof_map, const int out_size, THessian &hessian);
+
 		std::vector<std::shared_ptr<Form>> forms_;
+
+	private:
+		/// @brief Sparsity pattern of the Hessian of a form and its position in the global Hessian
+		struct FormHessianPattern
+		{
+			std::vector<THessian::StorageIndex> outer;
+			std::vector<THessian::StorageIndex> inner;
+			std::vector<long> slots; ///< Index in the values of the global Hessian (-1 if the entry is dropped or not in the union)
+			std::vector<std::array<long, 3>> overflow; ///< Row, col, and index in the form values of the entries not in the union
+		};
+
+		bool has_same_pattern(const FormHessianPattern &pattern, const THessian &hessian) const;
+		void build_hessian_pattern(const Eigen::VectorXi &dof_map, const int out_size);
+		void build_form_slots(const size_t i);
+
+		std::vector<THessian> form_hessians_;             ///< Hessians of the forms, kept to reuse their memory
+		std::vector<FormHessianPattern> hessian_patterns_; ///< Cached patterns of the forms
+		THessian hessian_cache_;                          ///< Global Hessian with the union pattern
+		Eigen::VectorXi hessian_dof_map_;                 ///< DOF map used to build the cached pattern
 	};
 } // namespace polyfem::solver
@@ -109,11 +109,35 @@ namespace polyfem::solver
 
 	void NLProblem::hessian(const TVector &x, THessian &hessian)
 	{
-		THessian full_hessian;
-		FullNLProblem::hessian(reduced_to_full(x), full_hessian);
-		assert(full_hessian.rows() == full_size());
-		assert(full_hessian.cols() == full_size());
-		utils::full_to_reduced_matrix(full_size(), current_size(), boundary_nodes_, full_hessian, hessian);
+		if (current_size() == full_size())
+		{
+			FullNLProblem::hessian(reduced_to_full(x), hessian);
+			return;
+		}
+
+		// the Dirichlet DOFs are dropped directly when scattering the form hessians
+		if (full_to_reduced_dofs_.size() != full_size())
+		{
+			assert(std::is_sorted(boundary_nodes_.begin(), boundary_nodes_.end()));
+			full_to_reduced_dofs_.resize(full_size());
+			int index = 0;
+			size_t k = 0;
+			for (int i = 0; i < full_size(); ++i)
+			{
+				if (k < boundary_nodes_.size() && boundary_nodes_[k] == i)
+				{
+					++k;
+					full_to_reduced_dofs_(i) = -1;
+				}
+				else
+				{
+					full_to_reduced_dofs_(i) = index++;
+				}
+			}
+			assert(index == reduced_size());
+		}
+
+		assemble_hessian(reduced_to_full(x), full_to_reduced_dofs_, current_size(), hessian);
 	}
 
 	void NLProblem::solution_changed(const TVector &newX)
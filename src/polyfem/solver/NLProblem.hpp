@@ -84,6 +84,8 @@ namespace polyfem::solver
 		const int n_boundary_samples_;
 		double t_;
 
+		Eigen::VectorXi full_to_reduced_dofs_; ///< Reduced index of each full DOF (-1 for Dirichlet DOFs)
+
 		template <class FullMat, class ReducedMat>
 		static void full_to_reduced_aux(const std::vector<int> &boundary_nodes, const int full_size, const int reduced_size, const FullMat &full, ReducedMat &reduced);
 
@@ -85,6 +85,9 @@ namespace cppoptlib
 		// Compute the search/update direction
 		virtual bool compute_update_direction(ProblemType &objFunc, const TVector &x_vec, const TVector &grad, TVector &direction) = 0;
 
+		// Second order solvers tell the problem that the hessian follows the gradient, so that they are assembled together
+		virtual void expect_hessian(ProblemType &objFunc, const bool val) {}
+
 		virtual int default_descent_strategy() = 0;
 		virtual void increase_descent_strategy() = 0;
 
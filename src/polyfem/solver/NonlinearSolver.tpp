@@ -121,6 +121,8 @@ namespace cppoptlib
 
 		do
 		{
+			POLYFEM_TRACE_SCOPE(name() + " iteration");
+
 			if (name() == "MMA")
 			{
 				POLYFEM_SCOPED_TIMER("constraint set update", constraint_set_update_time);
@@ -142,7 +144,9 @@ namespace cppoptlib
 
 			{
 				POLYFEM_SCOPED_TIMER("compute gradient", grad_time);
+				expect_hessian(objFunc, true);
 				objFunc.gradient(x, grad);
+				expect_hessian(objFunc, false);
 			}
 
 			const double grad_norm = compute_grad_norm(x, grad);
@@ -1,6 +1,8 @@
 #include "OperatorSplittingSolver.hpp"
 #include <unsupported/Eigen/SparseExtra>
 
+#include <algorithm>
+
 #ifdef POLYFEM_WITH_OPENVDB
 #include <openvdb/openvdb.h>
 #endif
@@ -77,62 +79,152 @@ namespace polyfem::solver
 			logger().debug("hash grid in {} dimension: {}", d, hash_table_cell_num(d));
 			total_cell_num *= hash_table_cell_num(d);
 		}
-		hash_table.resize(total_cell_num);
-		for (int e = 0; e < T.rows(); e++)
-		{
-			Eigen::VectorXd min_ = V.row(T(e, 0));
-			Eigen::VectorXd max_ = min_;
 
-			for (int i = 1; i < T.cols(); i++)
-			{
-				Eigen::VectorXd p = V.row(T(e, i));
-				min_ = min_.cwiseMin(p);
-				max_ = max_.cwiseMax(p);
-			}
+		// range of hash cells overlapped by the bounding box of every element, [min, max)
+		const int n_elements = T.rows();
+		Eigen::Matrix<long, Eigen::Dynamic, Eigen::Dynamic> cell_range(2 * dim, n_elements);
+		std::vector<long> element_offsets(n_elements + 1, 0);
+#ifdef POLYFEM_WITH_TBB
+		tbb::parallel_for(0, n_elements, 1, [&](int e)
+#else
+		for (int e = 0; e < n_elements; e++)
+#endif
+						  {
+							  Eigen::VectorXd min_ = V.row(T(e, 0));
+							  Eigen::VectorXd max_ = min_;
 
-			Eigen::Matrix<long, Eigen::Dynamic, 1, Eigen::ColMajor, 3, 1> min_int(dim), max_int(dim);
+							  for (int i = 1; i < T.cols(); i++)
+							  {
+								  Eigen::VectorXd p = V.row(T(e, i));
+								  min_ = min_.cwiseMin(p);
+								  max_ = max_.cwiseMax(p);
+							  }
 
-			for (int d = 0; d < dim; d++)
-			{
-				double temp = hash_table_cell_num(d) / (max_domain(d) - min_domain(d));
-				min_int(d) = floor((min_(d) * (1 - 1e-14) - min_domain(d)) * temp);
-				max_int(d) = ceil((max_(d) * (1 + 1e-14) - min_domain(d)) * temp);
+							  long n_cells = 1;
+							  for (int d = 0; d < dim; d++)
+							  {
+								  double temp = hash_table_cell_num(d) / (max_domain(d) - min_domain(d));
+								  cell_range(d, e) = std::max(0l, (long)floor((min_(d) * (1 - 1e-14) - min_domain(d)) * temp));
+								  cell_range(dim + d, e) = std::min(hash_table_cell_num(d), (long)ceil((max_(d) * (1 + 1e-14) - min_domain(d)) * temp));
+								  n_cells *= std::max(0l, cell_range(dim + d, e) - cell_range(d, e));
+							  }
+							  element_offsets[e + 1] = n_cells;
+						  }
+#ifdef POLYFEM_WITH_TBB
+		);
+#endif
+		for (int e = 0; e < n_elements; e++)
+			element_offsets[e + 1] += element_offsets[e];
 
-				min_int = min_int.cwiseMax(0);
-				max_int = max_int.cwiseMin(hash_table_cell_num);
-			}
+		// (cell, element) pairs, sorted by element
+		std::vector<long> pair_cells(element_offsets.back());
+#ifdef POLYFEM_WITH_TBB
+		tbb::parallel_for(0, n_elements, 1, [&](int e)
+#else
+		for (int e = 0; e < n_elements; e++)
+#endif
+						  {
+							  long k = element_offsets[e];
+							  for (long x = cell_range(0, e); x < cell_range(dim, e); x++)
+							  {
+								  for (long y = cell_range(1, e); y < cell_range(dim + 1, e); y++)
+								  {
+									  if (dim == 2)
+										  pair_cells[k++] = x + y * hash_table_cell_num(0);
+									  else
+									  {
+										  for (long z = cell_range(2, e); z < cell_range(dim + 2, e); z++)
+											  pair_cells[k++] = x + (y + z * hash_table_cell_num(1)) * hash_table_cell_num(0);
+									  }
+								  }
+							  }
+						  }
+#ifdef POLYFEM_WITH_TBB
+		);
+#endif
 
-			for (long x = min_int(0); x < max_int(0); x++)
-			{
-				for (long y = min_int(1); y < max_int(1); y++)
-				{
-					if (dim == 2)
-					{
-						long idx = x + y * hash_table_cell_num(0);
-						hash_table[idx].push_back(e);
-					}
-					else
-					{
-						for (long z = min_int(2); z < max_int(2); z++)
-						{
-							long idx = x + (y + z * hash_table_cell_num(1)) * hash_table_cell_num(0);
-							hash_table[idx].push_back(e);
-						}
-					}
-				}
-			}
-		}
+		// counting sort by cell, the elements of every cell stay in increasing order
+		hash_table_offsets.assign(total_cell_num + 1, 0);
+		for (const long c : pair_cells)
+			++hash_table_offsets[c + 1];
+		for (long i = 0; i < total_cell_num; i++)
+			hash_table_offsets[i + 1] += hash_table_offsets[i];
 
-		float average_intersection_num = 0;
-		int max_intersection_num = 0;
-		for (int i = 0; i < hash_table.size(); i++)
+		hash_table_elements.resize(pair_cells.size());
+		std::vector<long> fill(hash_table_offsets.begin(), hash_table_offsets.end() - 1);
+		for (int e = 0; e < n_elements; e++)
 		{
-			average_intersection_num += hash_table[i].size();
-			(hash_table[i].size() > max_intersection_num) ? (max_intersection_num = hash_table[i].size()) : 1;
+			for (long k = element_offsets[e]; k < element_offsets[e + 1]; k++)
+				hash_table_elements[fill[pair_cells[k]]++] = e;
 		}
-		average_intersection_num /= hash_table.size();
-		logger().debug("average intersection number for hash grid: {}", average_intersection_num);
+
+		long max_intersection_num = 0;
+		for (long i = 0; i < total_cell_num; i++)
+			max_intersection_num = std::max(max_intersection_num, hash_table_offsets[i + 1] - hash_table_offsets[i]);
+		logger().debug("average intersection number for hash grid: {}", double(hash_table_elements.size()) / total_cell_num);
 		logger().debug("max intersection number for hash grid: {}", max_intersection_num);
+
+		// elements sharing a vertex, through the vertex to element map
+		std::vector<int> vertex_offsets(V.rows() + 1, 0);
+		for (int e = 0; e < n_elements; e++)
+			for (int i = 0; i < T.cols(); i++)
+				++vertex_offsets[T(e, i) + 1];
+		for (int v = 0; v < V.rows(); v++)
+			vertex_offsets[v + 1] += vertex_offsets[v];
+		std::vector<int> vertex_elements(vertex_offsets.back());
+		std::vector<int> vertex_fill(vertex_offsets.begin(), vertex_offsets.end() - 1);
+		for (int e = 0; e < n_elements; e++)
+			for (int i = 0; i < T.cols(); i++)
+				vertex_elements[vertex_fill[T(e, i)]++] = e;
+
+		std::vector<std::vector<int>> neighbors(n_elements);
+#ifdef POLYFEM_WITH_TBB
+		tbb::parallel_for(0, n_elements, 1, [&](int e)
+#else
+		for (int e = 0; e < n_elements; e++)
+#endif
+						  {
+							  std::vector<int> &n = neighbors[e];
+							  for (int i = 0; i < T.cols(); i++)
+								  n.insert(n.end(), vertex_elements.begin() + vertex_offsets[T(e, i)], vertex_elements.begin() + vertex_offsets[T(e, i) + 1]);
+							  std::sort(n.begin(), n.end());
+							  n.erase(std::unique(n.begin(), n.end()), n.end());
+							  n.erase(std::find(n.begin(), n.end(), e));
+						  }
+#ifdef POLYFEM_WITH_TBB
+		);
+#endif
+		element_neighbors_offsets.assign(n_elements + 1, 0);
+		for (int e = 0; e < n_elements; e++)
+			element_neighbors_offsets[e + 1] = element_neighbors_offsets[e] + neighbors[e].size();
+		element_neighbors.resize(element_neighbors_offsets.back());
+		for (int e = 0; e < n_elements; e++)
+			std::copy(neighbors[e].begin(), neighbors[e].end(), element_neighbors.begin() + element_neighbors_offsets[e]);
+
+		// inverse of the geometric map linearized at the element centers
+		Eigen::MatrixXd reference_center(1, dim);
+		reference_center.setConstant(shape == dim + 1 ? 1. / (dim + 1) : 0.5);
+		element_centers.resize(dim, n_elements);
+		element_inverse_jacobians.resize(dim * dim, n_elements);
+#ifdef POLYFEM_WITH_TBB
+		tbb::parallel_for(0, n_elements, 1, [&](int e)
+#else
+		for (int e = 0; e < n_elements; e++)
+#endif
+						  {
+							  Eigen::MatrixXd center, jacobi;
+							  compute_gbase_val(e, reference_center, center);
+							  compute_gbase_jacobi(e, reference_center, jacobi);
+							  element_centers.col(e) = center.transpose();
+							  // degenerate elements start from the reference center
+							  if (std::abs(jacobi.determinant()) > 0)
+								  Eigen::Map<Eigen::MatrixXd>(element_inverse_jacobians.col(e).data(), dim, dim) = jacobi.inverse();
+							  else
+								  element_inverse_jacobians.col(e).setZero();
+						  }
+#ifdef POLYFEM_WITH_TBB
+		);
+#endif
 	}
 
 	void OperatorSplittingSolver::initialize_solver(const mesh::Mesh &mesh,
@@ -278,11 +370,12 @@ namespace polyfem::solver
 											RowVectorNd &vel_2,
 											Eigen::MatrixXd &local_pos,
 											const Eigen::MatrixXd &sol,
-											const double dt)
+											const double dt,
+											const int hint)
 	{
 		pos_2 = pos_1 - vel_1 * dt;
 
-		return interpolator(gbases, bases, pos_2, vel_2, local_pos, sol);
+		return interpolator(gbases, bases, pos_2, vel_2, local_pos, sol, hint);
 	}
 
 	int OperatorSplittingSolver::interpolator(const std::vector<basis::ElementBases> &gbases,
@@ -290,12 +383,13 @@ namespace polyfem::solver
 											  const RowVectorNd &pos,
 											  RowVectorNd &vel,
 											  Eigen::MatrixXd &local_pos,
-											  const Eigen::MatrixXd &sol)
+											  const Eigen::MatrixXd &sol,
+											  const int hint)
 	{
 		bool insideDomain = true;
 
 		int new_elem;
-		if ((new_elem = search_cell(gbases, pos, local_pos)) == -1)
+		if ((new_elem = search_cell(gbases, pos, local_pos, hint)) == -1)
 		{
 			insideDomain = false;
 			RowVectorNd pos_ = pos;
@@ -397,7 +491,7 @@ namespace polyfem::solver
 									  pos_(d) = mapped(i, d) - vel_(d) * dt;
 
 								  Eigen::MatrixXd local_pos;
-								  interpolator(gbases, bases, pos_, vel_, local_pos, sol);
+								  interpolator(gbases, bases, pos_, vel_, local_pos, sol, e);
 
 								  new_sol.block(global * dim, 0, dim, 1) = vel_.transpose();
 							  }
@@ -718,8 +812,7 @@ namespace polyfem::solver
 			}
 		}
 
-		// advect
-		std::vector<assembler::ElementAssemblyValues> velocity_interpolator(ppe * n_el);
+		// advect, the particles are searched starting from the cells they were in
 #ifdef POLYFEM_WITH_TBB
 		tbb::parallel_for(0, (int)(ppe * n_el), 1, [&](int pI)
 #else
@@ -727,26 +820,26 @@ namespace polyfem::solver
 #endif
 						  {
 							  // update particle position via advection
-							  RowVectorNd newvel;
-							  Eigen::MatrixXd local_pos;
-							  cellI_particle[pI] = trace_back(gbases, bases, position_particle[pI], velocity_particle[pI],
-															  position_particle[pI], newvel, local_pos, sol, -dt);
-
-							  // RK3:
-							  // RowVectorNd bypass, vel2, vel3;
-							  // trace_back( gbases, bases, position_particle[pI], velocity_particle[pI],
-							  //     bypass, vel2, sol, -0.5 * dt);
-							  // trace_back( gbases, bases, position_particle[pI], vel2,
-							  //     bypass, vel3, sol, -0.75 * dt);
-							  // trace_back( gbases, bases, position_particle[pI],
-							  //     2 * velocity_particle[pI] + 3 * vel2 + 4 * vel3,
-							  //     position_particle[pI], bypass, sol, -dt / 9);
+							  position_particle[pI] += velocity_particle[pI] * dt;
+						  }
+#ifdef POLYFEM_WITH_TBB
+		);
+#endif
+		std::vector<Eigen::MatrixXd> local_pos_particle;
+		locate_points(gbases, position_particle, cellI_particle, local_pos_particle);
 
+		std::vector<assembler::ElementAssemblyValues> velocity_interpolator(ppe * n_el);
+#ifdef POLYFEM_WITH_TBB
+		tbb::parallel_for(0, (int)(ppe * n_el), 1, [&](int pI)
+#else
+		for (int pI = 0; pI < ppe * n_el; ++pI)
+#endif
+						  {
 							  // prepare P2G
 							  if (cellI_particle[pI] >= 0)
 							  {
 								  // construct interpolator (always linear for P2G, can use gaussian or bspline later)
-								  velocity_interpolator[pI].compute(cellI_particle[pI], dim == 3, local_pos,
+								  velocity_interpolator[pI].compute(cellI_particle[pI], dim == 3, local_pos_particle[pI],
 																	gbases[cellI_particle[pI]], gbases[cellI_particle[pI]]);
 							  }
 						  }
@@ -852,7 +945,7 @@ namespace polyfem::solver
 								  RowVectorNd newvel;
 								  Eigen::MatrixXd local_pos;
 								  cellI_particle[ppe * e + j] = trace_back(gbases, bases, position_particle[ppe * e + j], velocity_particle[e * ppe + j],
-																		   position_particle[ppe * e + j], newvel, local_pos, sol, -dt);
+																		   position_particle[ppe * e + j], newvel, local_pos, sol, -dt, e);
 
 								  // RK3:
 								  // RowVectorNd bypass, vel2, vel3;
@@ -1119,8 +1212,32 @@ namespace polyfem::solver
 		}
 	}
 
-	long OperatorSplittingSolver::search_cell(const std::vector<basis::ElementBases> &gbases, const RowVectorNd &pos, Eigen::MatrixXd &local_pts)
+	bool OperatorSplittingSolver::is_inside_reference(const Eigen::MatrixXd &local_pts) const
 	{
+		if (shape == dim + 1)
+			return local_pts.minCoeff() > -1e-13 && local_pts.sum() < 1 + 1e-13;
+		else
+			return local_pts.minCoeff() > -1e-13 && local_pts.maxCoeff() < 1 + 1e-13;
+	}
+
+	long OperatorSplittingSolver::search_cell(const std::vector<basis::ElementBases> &gbases, const RowVectorNd &pos, Eigen::MatrixXd &local_pts, const long hint)
+	{
+		// the traced back positions are usually in the hint or in one of its neighbors
+		if (hint >= 0)
+		{
+			calculate_local_pts(gbases[hint], hint, pos, local_pts);
+			if (is_inside_reference(local_pts))
+				return hint;
+
+			for (int i = element_neighbors_offsets[hint]; i < element_neighbors_offsets[hint + 1]; i++)
+			{
+				const int e = element_neighbors[i];
+				calculate_local_pts(gbases[e], e, pos, local_pts);
+				if (is_inside_reference(local_pts))
+					return e;
+			}
+		}
+
 		Eigen::Matrix<long, Eigen::Dynamic, 1> pos_int(dim);
 		for (int d = 0; d < dim; d++)
 		{
@@ -1138,25 +1255,36 @@ namespace polyfem::solver
 			dim_num *= hash_table_cell_num(d);
 		}
 
-		const std::vector<long> &list = hash_table[idx];
-		for (auto it = list.begin(); it != list.end(); it++)
+		for (long i = hash_table_offsets[idx]; i < hash_table_offsets[idx + 1]; i++)
 		{
-			calculate_local_pts(gbases[*it], *it, pos, local_pts);
-
-			if (shape == dim + 1)
-			{
-				if (local_pts.minCoeff() > -1e-13 && local_pts.sum() < 1 + 1e-13)
-					return *it;
-			}
-			else
-			{
-				if (local_pts.minCoeff() > -1e-13 && local_pts.maxCoeff() < 1 + 1e-13)
-					return *it;
-			}
+			const int e = hash_table_elements[i];
+			calculate_local_pts(gbases[e], e, pos, local_pts);
+			if (is_inside_reference(local_pts))
+				return e;
 		}
 		return -1; // not inside any elem
 	}
 
+	void OperatorSplittingSolver::locate_points(const std::vector<basis::ElementBases> &gbases,
+												const std::vector<Eigen::Matrix<double, 1, Eigen::Dynamic, Eigen::RowMajor, 1, 3>> &points,
+												std::vector<int> &cells,
+												std::vector<Eigen::MatrixXd> &local_pts)
+	{
+		assert(cells.size() == points.size());
+		local_pts.resize(points.size());
+#ifdef POLYFEM_WITH_TBB
+		tbb::parallel_for(0, (int)points.size(), 1, [&](int i)
+#else
+		for (int i = 0; i < points.size(); ++i)
+#endif
+						  {
+							  cells[i] = search_cell(gbases, points[i], local_pts[i], cells[i]);
+						  }
+#ifdef POLYFEM_WITH_TBB
+		);
+#endif
+	}
+
 	bool OperatorSplittingSolver::outside_quad(const std::vector<RowVectorNd> &vert, const RowVectorNd &pos)
 	{
 		double a = (vert[1](0) - vert[0](0)) * (pos(1) - vert[0](1)) - (vert[1](1) - vert[0](1)) * (pos(0) - vert[0](0));
@@ -1278,26 +1406,34 @@ namespace polyfem::solver
 													  const RowVectorNd &pos,
 													  Eigen::MatrixXd &local_pos)
 	{
-		local_pos = Eigen::MatrixXd::Zero(1, dim);
+		// initial guess from the cached linearization of the inverse map, exact for simplices
+		local_pos.resize(1, dim);
+		const Eigen::Map<const Eigen::MatrixXd> inv_jacobi(element_inverse_jacobians.col(elem_idx).data(), dim, dim);
+		local_pos.row(0) = (inv_jacobi * (pos.transpose() - element_centers.col(elem_idx))).transpose();
+		local_pos.array() += shape == dim + 1 ? 1. / (dim + 1) : 0.5;
 
-		// if(shape == 4 && dim == 2 && outside_quad(vert, pos))
-		// {
-		//     local_pos(0) = local_pos(1) = -1;
-		//     return;
-		// }
 		Eigen::MatrixXd res;
-		int iter_times = 0;
-		int max_iter = 20;
-		do
+		Eigen::MatrixXd mapped;
+		std::vector<Eigen::MatrixXd> grads;
+		const int max_iter = 20;
+		for (int iter_times = 0;; iter_times++)
 		{
-			res = -pos;
-
-			Eigen::MatrixXd mapped;
 			gbase.eval_geom_mapping(local_pos, mapped);
-			for (int d = 0; d < dim; d++)
-				res(d) += mapped(0, d);
+			res = mapped.leftCols(dim) - pos;
+			if (res.norm() <= 1e-12)
+				break;
+
+			// the map of simplices is linear, one step is enough
+			if (shape == dim + 1 && iter_times > 0)
+				break;
+
+			if (iter_times >= max_iter)
+			{
+				for (int d = 0; d < dim; d++)
+					local_pos(d) = -1;
+				break;
+			}
 
-			std::vector<Eigen::MatrixXd> grads;
 			gbase.eval_geom_mapping_grads(local_pos, grads);
 			Eigen::MatrixXd jacobi = grads[0].transpose();
 
@@ -1306,15 +1442,6 @@ namespace polyfem::solver
 			{
 				local_pos(d) -= delta(d);
 			}
-			iter_times++;
-			if (shape == dim + 1)
-				break;
-		} while (res.norm() > 1e-12 && iter_times < max_iter);
-
-		if (iter_times >= max_iter)
-		{
-			for (int d = 0; d < dim; d++)
-				local_pos(d) = -1;
 		}
 	}
 
@@ -61,6 +61,7 @@ namespace polyfem
 
 			int handle_boundary_advection(RowVectorNd &pos);
 
+			// hint is an element close to the traced back position (e.g., the one it started from), or -1
 			int trace_back(const std::vector<basis::ElementBases> &gbases,
 						   const std::vector<basis::ElementBases> &bases,
 						   const RowVectorNd &pos_1,
@@ -69,14 +70,16 @@ namespace polyfem
 						   RowVectorNd &vel_2,
 						   Eigen::MatrixXd &local_pos,
 						   const Eigen::MatrixXd &sol,
-						   const double dt);
+						   const double dt,
+						   const int hint = -1);
 
 			int interpolator(const std::vector<basis::ElementBases> &gbases,
 							 const std::vector<basis::ElementBases> &bases,
 							 const RowVectorNd &pos,
 							 RowVectorNd &vel,
 							 Eigen::MatrixXd &local_pos,
-							 const Eigen::MatrixXd &sol);
+							 const Eigen::MatrixXd &sol,
+							 const int hint = -1);
 
 			void interpolator(const RowVectorNd &pos, double &val);
 
@@ -133,7 +136,18 @@ namespace polyfem
 
 			void initialize_density(const std::shared_ptr<assembler::Problem> &problem);
 
-			long search_cell(const std::vector<basis::ElementBases> &gbases, const RowVectorNd &pos, Eigen::MatrixXd &local_pts);
+			// finds the element containing pos, trying first hint and the elements around it, then the hash grid
+			// returns -1 if pos is outside the mesh
+			long search_cell(const std::vector<basis::ElementBases> &gbases, const RowVectorNd &pos, Eigen::MatrixXd &local_pts, const long hint = -1);
+
+			// locates all the points in parallel, on input cells contains the hints (or -1), on output the elements containing
+			// the points (or -1 if outside the mesh) and local_pts their local coordinates
+			void locate_points(const std::vector<basis::ElementBases> &gbases,
+							   const std::vector<Eigen::Matrix<double, 1, Eigen::Dynamic, Eigen::RowMajor, 1, 3>> &points,
+							   std::vector<int> &cells,
+							   std::vector<Eigen::MatrixXd> &local_pts);
+
+			bool is_inside_reference(const Eigen::MatrixXd &local_pts) const;
 
 			bool outside_quad(const std::vector<RowVectorNd> &vert, const RowVectorNd &pos);
 
@@ -158,9 +172,20 @@ namespace polyfem
 			Eigen::MatrixXd V;
 			Eigen::MatrixXi T;
 
-			std::vector<std::vector<long>> hash_table;
+			// hash grid in CSR format, the elements overlapping cell i are hash_table_elements[hash_table_offsets[i]], ..., hash_table_elements[hash_table_offsets[i + 1] - 1]
+			std::vector<long> hash_table_offsets;
+			std::vector<int> hash_table_elements;
 			Eigen::Matrix<long, Eigen::Dynamic, 1, Eigen::ColMajor, 3, 1> hash_table_cell_num;
 
+			// elements sharing a vertex with element e, in CSR format as the hash grid
+			std::vector<int> element_neighbors_offsets;
+			std::vector<int> element_neighbors;
+
+			// affine approximation of the inverse geometric map around the element centers, used as initial guess in calculate_local_pts
+			// the columns are the physical centers (dim x n_el) and the inverse jacobians (dim * dim x n_el)
+			Eigen::MatrixXd element_centers;
+			Eigen::MatrixXd element_inverse_jacobians;
+
 			std::vector<Eigen::Matrix<double, 1, Eigen::Dynamic, Eigen::RowMajor, 1, 3>> position_particle;
 			std::vector<Eigen::Matrix<double, 1, Eigen::Dynamic, Eigen::RowMajor, 1, 3>> velocity_particle;
 			std::vector<int> cellI_particle;
@@ -289,6 +289,10 @@ namespace polyfem::solver
 		{
 			map = std::make_shared<LinearFilter>(*(states[args["state"]]->mesh), args["radius"]);
 		}
+		else if (type == "helmholtz-filter")
+		{
+			map = std::make_shared<HelmholtzFilter>(*(states[args["state"]]->mesh), args["radius"]);
+		}
 		else if (type == "custom-symmetric")
 		{
 			map = std::make_shared<CustomSymmetric>(args);
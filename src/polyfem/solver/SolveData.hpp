@@ -17,6 +17,12 @@
 #include <string>
 #include <unordered_map>
 
+namespace cppoptlib
+{
+	template <typename ProblemType>
+	class NonlinearSolver;
+} // namespace cppoptlib
+
 namespace polyfem::time_integrator
 {
 	class ImplicitTimeIntegrator;
@@ -118,6 +124,8 @@ namespace polyfem::solver
 	public:
 		std::shared_ptr<assembler::RhsAssembler> rhs_assembler;
 		std::shared_ptr<solver::NLProblem> nl_problem;
+		/// Nonlinear solver kept across time steps (e.g., to reuse the symbolic factorization)
+		std::shared_ptr<cppoptlib::NonlinearSolver<solver::NLProblem>> nl_solver;
 
 		std::shared_ptr<solver::BCLagrangianForm> al_lagr_form;
 		std::shared_ptr<solver::BCPenaltyForm> al_pen_form;
@@ -22,6 +22,15 @@ namespace cppoptlib
 
 		std::string name() const override { return "Newton"; }
 
+		/// @brief Linear solver holding the factorization of the last Hessian
+		/// The factorization is of the Hessian at the last iterate before the final step, possibly projected or regularized.
+		/// @param size expected size of the factorized Hessian
+		/// @return nullptr if the last factorization failed or has a different size
+		std::shared_ptr<polysolve::LinearSolver> last_factorization(const int size) const
+		{
+			return (has_factorization && factorization_size == size) ? linear_solver : nullptr;
+		}
+
 	protected:
 		const double characteristic_length;
 
@@ -33,6 +42,9 @@ namespace cppoptlib
 
 		static bool has_hessian_nans(const polyfem::StiffnessMatrix &hessian);
 
+		/// @brief Check if the sparsity pattern of hessian is exactly the one of the last analyzed Hessian
+		bool is_analyzed_pattern(const polyfem::StiffnessMatrix &hessian) const;
+
 		// ====================================================================
 		//                        Solver parameters
 		// ====================================================================
@@ -48,6 +60,8 @@ namespace cppoptlib
 
 		void reset(const int ndof) override;
 
+		void expect_hessian(ProblemType &objFunc, const bool val) override;
+
 		virtual int default_descent_strategy() override { return force_psd_projection ? 1 : 0; }
 		void increase_descent_strategy() override;
 
@@ -59,10 +73,25 @@ namespace cppoptlib
 			return this->descent_strategy == 2 ? spdlog::level::warn : spdlog::level::debug;
 		}
 
-		std::unique_ptr<polysolve::LinearSolver> linear_solver; ///< Linear solver used to solve the linear system
+		std::shared_ptr<polysolve::LinearSolver> linear_solver; ///< Linear solver used to solve the linear system
 		bool force_psd_projection = false;                      ///< Whether to force the Hessian to be positive semi-definite
 		double reg_weight = 0;                                  ///< Regularization Coefficients
 
+		bool reuse_symbolic_factorization = true; ///< Skip analyzePattern if the Hessian sparsity is unchanged
+		bool has_analyzed_pattern = false;        ///< Whether linear_solver holds a symbolic factorization
+		bool has_factorization = false;           ///< Whether linear_solver holds a numerical factorization
+		int factorization_size = 0;               ///< Size of the Hessian factorized by linear_solver
+		long analyzed_rows = 0;                   ///< Size of the last analyzed Hessian
+		long analyzed_cols = 0;
+		std::vector<polyfem::StiffnessMatrix::StorageIndex> analyzed_outer; ///< Outer indices of the last analyzed Hessian
+		std::vector<polyfem::StiffnessMatrix::StorageIndex> analyzed_inner; ///< Inner indices of the last analyzed Hessian
+
+		// Symbolic factorization counters (of the current solve and of the lifetime of the solver)
+		long n_analyze_pattern = 0;
+		long n_reused_pattern = 0;
+		long total_analyze_pattern = 0;
+		long total_reused_pattern = 0;
+
 		// ====================================================================
 		//                            Solver info
 		// ====================================================================
@@ -15,6 +15,7 @@ namespace cppoptlib
 		linear_solver->setParameters(linear_solver_params);
 
 		force_psd_projection = solver_params["force_psd_projection"];
+		reuse_symbolic_factorization = solver_params.value("reuse_symbolic_factorization", true);
 	}
 
 	// =======================================================================
@@ -58,6 +59,21 @@ namespace cppoptlib
 		assert(linear_solver != nullptr);
 		reg_weight = 0;
 		internal_solver_info = json::array();
+		// the symbolic factorization is kept across solves (e.g., time steps)
+		n_analyze_pattern = 0;
+		n_reused_pattern = 0;
+	}
+
+	// =======================================================================
+
+	template <typename ProblemType>
+	void SparseNewtonDescentSolver<ProblemType>::expect_hessian(ProblemType &objFunc, const bool val)
+	{
+		const bool expected = val && this->descent_strategy != 2;
+		// same projection as assemble_hessian, otherwise the hessian computed with the gradient is not reused
+		if (expected)
+			objFunc.set_project_to_psd(this->descent_strategy == 1);
+		objFunc.set_hessian_expected(expected);
 	}
 
 	// =======================================================================
@@ -128,15 +144,46 @@ namespace cppoptlib
 		const polyfem::StiffnessMatrix &hessian, const TVector &grad, TVector &direction)
 	{
 		POLYFEM_SCOPED_TIMER("linear solve", this->inverting_time);
-		// TODO: get the correct size
-		linear_solver->analyzePattern(hessian, hessian.rows());
+
+		if (reuse_symbolic_factorization && is_analyzed_pattern(hessian))
+		{
+			++n_reused_pattern;
+			++total_reused_pattern;
+		}
+		else
+		{
+			// TODO: get the correct size
+			linear_solver->analyzePattern(hessian, hessian.rows());
+			has_analyzed_pattern = true;
+			analyzed_rows = hessian.rows();
+			analyzed_cols = hessian.cols();
+			// an uncompressed pattern is never reused
+			if (reuse_symbolic_factorization && hessian.isCompressed())
+			{
+				analyzed_outer.assign(hessian.outerIndexPtr(), hessian.outerIndexPtr() + hessian.outerSize() + 1);
+				analyzed_inner.assign(hessian.innerIndexPtr(), hessian.innerIndexPtr() + hessian.nonZeros());
+			}
+			else
+			{
+				analyzed_outer.clear();
+				analyzed_inner.clear();
+			}
+			++n_analyze_pattern;
+			++total_analyze_pattern;
+		}
 
 		try
 		{
+			has_factorization = false;
 			linear_solver->factorize(hessian);
+			has_factorization = true;
+			factorization_size = hessian.rows();
 		}
 		catch (const std::runtime_error &err)
 		{
+			// redo the symbolic factorization on the next attempt
+			has_analyzed_pattern = false;
+
 			increase_descent_strategy();
 
 			// warn if using gradient descent
@@ -155,6 +202,21 @@ namespace cppoptlib
 
 	// =======================================================================
 
+	template <typename ProblemType>
+	bool SparseNewtonDescentSolver<ProblemType>::is_analyzed_pattern(const polyfem::StiffnessMatrix &hessian) const
+	{
+		if (!has_analyzed_pattern || !hessian.isCompressed()
+			|| hessian.rows() != analyzed_rows || hessian.cols() != analyzed_cols
+			|| analyzed_outer.size() != size_t(hessian.outerSize() + 1)
+			|| analyzed_inner.size() != size_t(hessian.nonZeros()))
+			return false;
+
+		return std::equal(analyzed_outer.begin(), analyzed_outer.end(), hessian.outerIndexPtr())
+			   && std::equal(analyzed_inner.begin(), analyzed_inner.end(), hessian.innerIndexPtr());
+	}
+
+	// =======================================================================
+
 	template <typename ProblemType>
 	bool SparseNewtonDescentSolver<ProblemType>::check_direction(
 		const polyfem::StiffnessMatrix &hessian, const TVector &grad, const TVector &direction)
@@ -197,6 +259,12 @@ namespace cppoptlib
 	{
 		Superclass::update_solver_info(energy);
 		this->solver_info["internal_solver"] = internal_solver_info;
+		this->solver_info["symbolic_factorization"] = {
+			{"analyzed", n_analyze_pattern},
+			{"reused", n_reused_pattern},
+			{"total_analyzed", total_analyze_pattern},
+			{"total_reused", total_reused_pattern},
+		};
 	}
 
 	// =======================================================================
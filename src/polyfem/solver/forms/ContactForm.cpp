@@ -47,6 +47,7 @@ namespace polyfem::solver
 
 	void ContactForm::init(const Eigen::VectorXd &x)
 	{
+		// the persistent candidates are kept from the previous solve, they are rebuilt only if x moved out of their skin
 		update_constraint_set(compute_displaced_surface(x));
 	}
 
@@ -80,10 +81,12 @@ namespace polyfem::solver
 		// The adative stiffness is designed for the non-convergent formulation,
 		// so we need to compute the gradient of the non-convergent barrier.
 		// After we can map it to a good value for the convergent formulation.
+		update_candidates(displaced_surface);
+
 		ipc::CollisionConstraints nonconvergent_constraints;
 		nonconvergent_constraints.set_use_convergent_formulation(false);
 		nonconvergent_constraints.build(
-			collision_mesh_, displaced_surface, dhat_, dmin_, broad_phase_method_);
+			candidates_, collision_mesh_, displaced_surface, dhat_);
 		Eigen::VectorXd grad_barrier = nonconvergent_constraints.compute_potential_gradient(
 			collision_mesh_, displaced_surface, dhat_);
 		grad_barrier = collision_mesh_.to_full_dof(grad_barrier);
@@ -130,13 +133,44 @@ namespace polyfem::solver
 
 		if (use_cached_candidates_)
 			constraint_set_.build(
-				candidates_, collision_mesh_, displaced_surface, dhat_);
+				line_search_candidates(), collision_mesh_, displaced_surface, dhat_);
 		else
+		{
+			update_candidates(displaced_surface);
 			constraint_set_.build(
-				collision_mesh_, displaced_surface, dhat_, dmin_, broad_phase_method_);
+				candidates_, collision_mesh_, displaced_surface, dhat_);
+		}
 		cached_displaced_surface = displaced_surface;
 	}
 
+	bool ContactForm::are_candidates_valid(const Eigen::MatrixXd &displaced_surface) const
+	{
+		if (candidates_positions_.rows() != displaced_surface.rows() || candidates_positions_.cols() != displaced_surface.cols())
+			return false;
+
+		// Two primitives get closer by at most twice the maximum vertex motion
+		const double max_motion = (displaced_surface - candidates_positions_).rowwise().norm().maxCoeff();
+		return max_motion <= candidates_skin_ * dhat_;
+	}
+
+	void ContactForm::update_candidates(const Eigen::MatrixXd &displaced_surface)
+	{
+		if (are_candidates_valid(displaced_surface))
+			return;
+
+		POLYFEM_SCOPED_TIMER("contact candidates");
+
+		// Same inflation as the constraint set broad phase, plus the skin
+		candidates_.build(
+			collision_mesh_, displaced_surface,
+			/*inflation_radius=*/(dhat_ + dmin_) / 2 + candidates_skin_ * dhat_,
+			broad_phase_method_);
+		candidates_positions_ = displaced_surface;
+		++n_candidates_builds_;
+
+		logger().trace("rebuilt {} contact candidates", candidates_.size());
+	}
+
 	double ContactForm::value_unweighted(const Eigen::VectorXd &x) const
 	{
 		return constraint_set_.compute_potential(collision_mesh_, compute_displaced_surface(x), dhat_);
@@ -226,6 +260,9 @@ namespace polyfem::solver
 
 		double max_step;
 		if (use_cached_candidates_ && broad_phase_method_ != ipc::BroadPhaseMethod::SWEEP_AND_TINIEST_QUEUE_GPU)
+			max_step = line_search_candidates().compute_collision_free_stepsize(
+				collision_mesh_, V0, V1, dmin_, ccd_tolerance_, ccd_max_iterations_);
+		else if (broad_phase_method_ != ipc::BroadPhaseMethod::SWEEP_AND_TINIEST_QUEUE_GPU && are_candidates_valid(V0) && are_candidates_valid(V1))
 			max_step = candidates_.compute_collision_free_stepsize(
 				collision_mesh_, V0, V1, dmin_, ccd_tolerance_, ccd_max_iterations_);
 		else
@@ -259,19 +296,25 @@ namespace polyfem::solver
 
 	void ContactForm::line_search_begin(const Eigen::VectorXd &x0, const Eigen::VectorXd &x1)
 	{
-		candidates_.build(
-			collision_mesh_,
-			compute_displaced_surface(x0),
-			compute_displaced_surface(x1),
-			/*inflation_radius=*/dhat_ / 2,
-			broad_phase_method_);
+		const Eigen::MatrixXd V0 = compute_displaced_surface(x0);
+		const Eigen::MatrixXd V1 = compute_displaced_surface(x1);
+
+		// The motion from the persistent positions is convex along the step,
+		// so if both ends are within the skin the whole step is.
+		use_swept_candidates_ = !are_candidates_valid(V0) || !are_candidates_valid(V1);
+		if (use_swept_candidates_)
+			swept_candidates_.build(
+				collision_mesh_, V0, V1,
+				/*inflation_radius=*/dhat_ / 2,
+				broad_phase_method_);
 
 		use_cached_candidates_ = true;
 	}
 
 	void ContactForm::line_search_end()
 	{
-		candidates_.clear();
+		swept_candidates_.clear();
+		use_swept_candidates_ = false;
 		use_cached_candidates_ = false;
 	}
 
@@ -322,6 +365,10 @@ namespace polyfem::solver
 
 		bool is_valid;
 		if (use_cached_candidates_)
+			is_valid = line_search_candidates().is_step_collision_free(
+				collision_mesh_, displaced0, displaced1, dmin_,
+				ccd_tolerance_, ccd_max_iterations_);
+		else if (are_candidates_valid(displaced0) && are_candidates_valid(displaced1))
 			is_valid = candidates_.is_step_collision_free(
 				collision_mesh_, displaced0, displaced1, dmin_,
 				ccd_tolerance_, ccd_max_iterations_);
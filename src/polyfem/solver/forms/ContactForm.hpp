@@ -139,12 +139,25 @@ namespace polyfem::solver
 
 		double dhat() const { return dhat_; }
 		ipc::CollisionConstraints get_constraint_set() const { return constraint_set_; }
+		/// @brief Number of times the persistent candidates were built with the broad phase
+		int n_candidates_builds() const { return n_candidates_builds_; }
 
 	protected:
 		/// @brief Update the cached candidate set for the current solution
 		/// @param displaced_surface Vertex positions displaced by the current solution
 		void update_constraint_set(const Eigen::MatrixXd &displaced_surface);
 
+		/// @brief Check if the persistent candidates contain every pair that can be closer than dhat at the given positions
+		/// @param displaced_surface Vertex positions displaced by the solution
+		bool are_candidates_valid(const Eigen::MatrixXd &displaced_surface) const;
+
+		/// @brief Rebuild the persistent candidates around the given positions if they are not valid anymore
+		/// @param displaced_surface Vertex positions displaced by the current solution
+		void update_candidates(const Eigen::MatrixXd &displaced_surface);
+
+		/// @brief Candidates used during the line search
+		const ipc::Candidates &line_search_candidates() const { return use_swept_candidates_ ? swept_candidates_ : candidates_; }
+
 		/// @brief Collision mesh
 		const ipc::CollisionMesh &collision_mesh_;
 
@@ -184,7 +197,19 @@ namespace polyfem::solver
 		bool use_cached_candidates_ = false;
 		/// @brief Cached constraint set for the current solution
 		ipc::CollisionConstraints constraint_set_;
-		/// @brief Cached candidate set for the current solution
+
+		/// @brief Persistent candidate set, valid as long as no vertex moves more than candidates_skin_ from candidates_positions_
 		ipc::Candidates candidates_;
+		/// @brief Vertex positions the persistent candidates were built at (empty if not built)
+		Eigen::MatrixXd candidates_positions_;
+		/// @brief Extra inflation of the persistent candidates, in units of dhat
+		double candidates_skin_ = 1;
+		/// @brief Number of broad phase builds of the persistent candidates
+		int n_candidates_builds_ = 0;
+
+		/// @brief If true, the line search uses the swept candidates instead of the persistent ones
+		bool use_swept_candidates_ = false;
+		/// @brief Candidates of the line search step, when it moves the vertices out of the persistent candidates skin
+		ipc::Candidates swept_candidates_;
 	};
 } // namespace polyfem::solver
@@ -52,10 +52,51 @@ namespace polyfem::solver
 		mat_cache_ = std::make_unique<utils::SparseMatrixCache>();
 	}
 
+	void ElasticForm::update_cache(const Eigen::VectorXd &x, bool want_energy, bool want_grad, bool want_hess) const
+	{
+		AssemblyCache &c = assembly_cache_;
+
+		if (c.x.size() != x.size() || c.x != x)
+		{
+			c.x = x;
+			c.has_energy = c.has_grad = c.has_hess = false;
+
+			// Newton uses the energy and the gradient at the point where the hessian is computed
+			if (want_hess)
+				want_energy = want_grad = true;
+		}
+		if (c.has_hess && c.project_to_psd != project_to_psd_)
+			c.has_hess = false;
+
+		want_energy = want_energy && !c.has_energy;
+		want_grad = want_grad && !c.has_grad;
+		want_hess = want_hess && !c.has_hess;
+
+		if (!want_energy && !want_grad && !want_hess)
+			return;
+
+		++n_assembly_passes_;
+
+		// NOTE: mat_cache_ is marked as mutable so we can modify it here
+		assembler_.assemble_all(
+			is_volume_, n_bases_, project_to_psd_, bases_, geom_bases_,
+			ass_vals_cache_, dt_, x, x_prev_,
+			want_energy, want_grad, want_hess,
+			*mat_cache_, c.energy, c.grad, c.hess);
+
+		c.has_energy |= want_energy;
+		c.has_grad |= want_grad;
+		if (want_hess)
+		{
+			c.has_hess = true;
+			c.project_to_psd = project_to_psd_;
+		}
+	}
+
 	double ElasticForm::value_unweighted(const Eigen::VectorXd &x) const
 	{
-		return assembler_.assemble_energy(
-			is_volume_, bases_, geom_bases_, ass_vals_cache_, dt_, x, x_prev_);
+		update_cache(x, true, false, false);
+		return assembly_cache_.energy;
 	}
 
 	Eigen::VectorXd ElasticForm::value_per_element_unweighted(const Eigen::VectorXd &x) const
@@ -68,10 +109,9 @@ namespace polyfem::solver
 
 	void ElasticForm::first_derivative_unweighted(const Eigen::VectorXd &x, Eigen::VectorXd &gradv) const
 	{
-		Eigen::MatrixXd grad;
-		assembler_.assemble_gradient(is_volume_, n_bases_, bases_, geom_bases_,
-									 ass_vals_cache_, dt_, x, x_prev_, grad);
-		gradv = grad;
+		// the energy comes for free with the gradient, and so does the gradient with the hessian
+		update_cache(x, true, true, hessian_expected_ && !assembler_.is_linear());
+		gradv = assembly_cache_.grad;
 	}
 
 	void ElasticForm::second_derivative_unweighted(const Eigen::VectorXd &x, StiffnessMatrix &hessian) const
@@ -87,15 +127,18 @@ namespace polyfem::solver
 		}
 		else
 		{
-			// NOTE: mat_cache_ is marked as mutable so we can modify it here
-			assembler_.assemble_hessian(
-				is_volume_, n_bases_, project_to_psd_, bases_,
-				geom_bases_, ass_vals_cache_, dt_, x, x_prev_, *mat_cache_, hessian);
+			update_cache(x, false, false, true);
+			hessian = assembly_cache_.hess;
 		}
 	}
 
 	bool ElasticForm::is_step_valid(const Eigen::VectorXd &, const Eigen::VectorXd &x1) const
 	{
+		// the line search evaluates the energy first, no need to assemble the derivatives of an invalid step
+		const AssemblyCache &c = assembly_cache_;
+		if (c.has_energy && c.x.size() == x1.size() && c.x == x1 && !std::isfinite(c.energy))
+			return false;
+
 		Eigen::VectorXd grad;
 		first_derivative(x1, grad);
 
@@ -26,6 +26,10 @@ namespace polyfem::solver
 
 		std::string name() const override { return "elastic"; }
 
+		/// @brief Initialize the form
+		/// @param x Current solution
+		void init(const Eigen::VectorXd &x) override { clear_cache(); }
+
 	protected:
 		/// @brief Compute the elastic potential value
 		/// @param x Current solution
@@ -57,7 +61,17 @@ namespace polyfem::solver
 		/// @brief Update time-dependent fields
 		/// @param t Current time
 		/// @param x Current solution at time t
-		void update_quantities(const double t, const Eigen::VectorXd &x) override { x_prev_ = x; }
+		void update_quantities(const double t, const Eigen::VectorXd &x) override
+		{
+			x_prev_ = x;
+			clear_cache();
+		}
+
+		/// @brief Drop the cached energy, gradient, and hessian (e.g., after changing the material parameters)
+		void clear_cache() const { assembly_cache_ = AssemblyCache(); }
+
+		/// @brief Number of passes over the elements done to fill the cache
+		int n_assembly_passes() const { return n_assembly_passes_; }
 
 		/// @brief Compute the derivative of the force wrt lame/damping parameters, then multiply the resulting matrix with adjoint_sol.
 		/// @param[in] x Current solution
@@ -88,6 +102,28 @@ namespace polyfem::solver
 		/// @brief Compute the stiffness matrix (cached)
 		void compute_cached_stiffness();
 
+		/// @brief Energy, gradient, and hessian at the last evaluated solution
+		struct AssemblyCache
+		{
+			Eigen::VectorXd x;
+			bool has_energy = false;
+			bool has_grad = false;
+			bool has_hess = false;
+			bool project_to_psd = false; ///< Projection used for the cached hessian
+			double energy = 0;
+			Eigen::MatrixXd grad;
+			StiffnessMatrix hess;
+		};
+		mutable AssemblyCache assembly_cache_;
+		mutable int n_assembly_passes_ = 0;
+
+		/// @brief Assemble the requested quantities at x in a single pass over the elements, and store them in the cache
+		/// @param x Current solution
+		/// @param want_energy Compute the energy if not cached
+		/// @param want_grad Compute the gradient if not cached
+		/// @param want_hess Compute the hessian if not cached
+		void update_cache(const Eigen::VectorXd &x, bool want_energy, bool want_grad, bool want_hess) const;
+
 		Eigen::VectorXd x_prev_;
 	};
 } // namespace polyfem::solver
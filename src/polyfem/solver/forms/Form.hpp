@@ -109,6 +109,10 @@ namespace polyfem::solver
 		/// @brief Get if the form's second derivative is projected to psd
 		bool is_project_to_psd() const { return project_to_psd_; }
 
+		/// @brief Set by second order solvers when the second derivative will be requested where the next first derivative is
+		/// @param val If true, the form can compute both derivatives together
+		void set_hessian_expected(bool val) { hessian_expected_ = val; }
+
 		/// @brief Enable the form
 		void enable() { enabled_ = true; }
 		/// @brief Disable the form
@@ -143,6 +147,8 @@ namespace polyfem::solver
 	protected:
 		bool project_to_psd_ = false; ///< If true, the form's second derivative is projected to be positive semidefinite
 
+		bool hessian_expected_ = false; ///< If true, the second derivative will be requested at the point of the next first derivative
+
 		double weight_ = 1; ///< weight of the form (e.g., AL penalty weight or Δt²)
 
 		bool enabled_ = true; ///< If true, the form is enabled
@@ -86,6 +86,7 @@ namespace polyfem::solver
 		double mu() const { return mu_; }
 		double epsv() const { return epsv_; }
 		ipc::FrictionConstraints get_friction_constraint_set() const { return friction_constraint_set_; }
+		void set_friction_constraint_set(const ipc::FrictionConstraints &friction_constraint_set) { friction_constraint_set_ = friction_constraint_set; }
 
 	private:
 		/// Reference to the collision mesh
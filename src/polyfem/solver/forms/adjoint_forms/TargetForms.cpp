@@ -248,7 +248,7 @@ namespace polyfem::solver
 			Eigen::VectorXd disp = state_.diff_cached.u(time_step);
 			for (int v : active_nodes)
 			{
-				RowVectorNd cur_pos = state_.mesh_nodes->node_position(v) + disp.segment(v * dim, dim).transpose();
+				RowVectorNd cur_pos = state_.node_position(v) + disp.segment(v * dim, dim).transpose();
 
 				rhs.segment(v * dim, dim) = 2 * (cur_pos - target_vertex_positions.row(i++));
 			}
@@ -265,7 +265,7 @@ namespace polyfem::solver
 		Eigen::VectorXd disp = state_.diff_cached.u(time_step);
 		for (int v : active_nodes)
 		{
-			RowVectorNd cur_pos = state_.mesh_nodes->node_position(v) + disp.segment(v * dim, dim).transpose();
+			RowVectorNd cur_pos = state_.node_position(v) + disp.segment(v * dim, dim).transpose();
 			val += (cur_pos - target_vertex_positions.row(i++)).squaredNorm();
 		}
 		return val;
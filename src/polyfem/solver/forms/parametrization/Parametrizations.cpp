@@ -1,10 +1,15 @@
 #include "Parametrizations.hpp"
 #include <polyfem/mesh/Mesh.hpp>
+#include <polyfem/mesh/mesh3D/Mesh3D.hpp>
 #include <polyfem/basis/ElementBases.hpp>
 #include <polyfem/utils/Logger.hpp>
+#include <polyfem/utils/MaybeParallelFor.hpp>
 #include <polyfem/Common.hpp>
 #include <polyfem/utils/ElasticityUtils.hpp>
 
+#include <array>
+#include <numeric>
+
 namespace polyfem::solver
 {
 	std::vector<std::shared_ptr<Parametrization>> ParametrizationFactory::build(const json &params, const int full_size)
@@ -411,41 +416,126 @@ namespace polyfem::solver
 		return reduced_grad;
 	}
 
-	LinearFilter::LinearFilter(const mesh::Mesh &mesh, const double radius)
+	namespace
 	{
-		std::vector<Eigen::Triplet<double>> tt_adjacency_list;
+		void element_barycenters(const mesh::Mesh &mesh, Eigen::MatrixXd &barycenters)
+		{
+			if (mesh.is_volume())
+				mesh.cell_barycenters(barycenters);
+			else
+				mesh.face_barycenters(barycenters);
+		}
+	} // namespace
 
+	LinearFilter::LinearFilter(const mesh::Mesh &mesh, const double radius)
+	{
 		Eigen::MatrixXd barycenters;
-		if (mesh.is_volume())
-			mesh.cell_barycenters(barycenters);
-		else
-			mesh.face_barycenters(barycenters);
+		element_barycenters(mesh, barycenters);
+
+		const int n_elements = barycenters.rows();
+		const int dim = barycenters.cols();
+
+		// uniform grid with cells not smaller than the radius, so the neighbours of an element are in the adjacent cells,
+		// and with at most about one cell per element along each axis
+		const RowVectorNd min = barycenters.colwise().minCoeff();
+		const RowVectorNd extent = barycenters.colwise().maxCoeff() - min;
+		const double max_cells_per_axis = std::max(1., std::ceil(std::pow(double(n_elements), 1. / dim)));
+		const double cell_size = std::max(radius, extent.maxCoeff() / max_cells_per_axis);
+
+		Eigen::Vector3i grid_size = Eigen::Vector3i::Ones();
+		for (int d = 0; d < dim; ++d)
+			grid_size(d) = int(extent(d) / cell_size) + 1;
+
+		const auto cell_coord = [&](const int i) {
+			Eigen::Vector3i c = Eigen::Vector3i::Zero();
+			for (int d = 0; d < dim; ++d)
+				c(d) = std::min(int((barycenters(i, d) - min(d)) / cell_size), grid_size(d) - 1);
+			return c;
+		};
+		const auto cell_index = [&](const Eigen::Vector3i &c) {
+			return c(0) + grid_size(0) * (c(1) + grid_size(1) * c(2));
+		};
+
+		// elements sorted by cell, the elements of cell c are cell_elements[cell_start[c]..cell_start[c+1])
+		const int n_cells = grid_size.prod();
+		std::vector<int> cell_start(n_cells + 1, 0);
+		std::vector<int> element_cell(n_elements);
+		for (int i = 0; i < n_elements; ++i)
+		{
+			element_cell[i] = cell_index(cell_coord(i));
+			++cell_start[element_cell[i] + 1];
+		}
+		std::partial_sum(cell_start.begin(), cell_start.end(), cell_start.begin());
 
-		RowVectorNd min, max;
-		mesh.bounding_box(min, max);
-		// TODO: more efficient way
-		for (int i = 0; i < barycenters.rows(); i++)
+		std::vector<int> cell_elements(n_elements);
 		{
-			auto center_i = barycenters.row(i);
-			for (int j = 0; j <= i; j++)
+			std::vector<int> cell_fill(cell_start.begin(), cell_start.end() - 1);
+			for (int i = 0; i < n_elements; ++i)
+				cell_elements[cell_fill[element_cell[i]]++] = i;
+		}
+
+		// calls f(j, radius - dist) for every element j closer than radius to element i
+		const auto for_each_neighbour = [&](const int i, const auto &f) {
+			const Eigen::Vector3i c = cell_coord(i);
+			const int dz_max = dim == 3 ? 1 : 0;
+			for (int dz = -dz_max; dz <= dz_max; ++dz)
 			{
-				auto center_j = barycenters.row(j);
-				double dist = 0;
-				dist = (center_i - center_j).norm();
-				if (dist < radius)
+				for (int dy = -1; dy <= 1; ++dy)
 				{
-					tt_adjacency_list.emplace_back(i, j, radius - dist);
-					if (i != j)
-						tt_adjacency_list.emplace_back(j, i, radius - dist);
+					for (int dx = -1; dx <= 1; ++dx)
+					{
+						const Eigen::Vector3i nc = c + Eigen::Vector3i(dx, dy, dz);
+						if ((nc.array() < 0).any() || (nc.array() >= grid_size.array()).any())
+							continue;
+
+						const int cell = cell_index(nc);
+						for (int k = cell_start[cell]; k < cell_start[cell + 1]; ++k)
+						{
+							const int j = cell_elements[k];
+							const double dist = (barycenters.row(i) - barycenters.row(j)).norm();
+							if (dist < radius)
+								f(j, radius - dist);
+						}
+					}
 				}
 			}
-		}
-		tt_radius_adjacency.resize(barycenters.rows(), barycenters.rows());
-		tt_radius_adjacency.setFromTriplets(tt_adjacency_list.begin(), tt_adjacency_list.end());
+		};
 
-		tt_radius_adjacency_row_sum.setZero(tt_radius_adjacency.rows());
-		for (int i = 0; i < tt_radius_adjacency.rows(); i++)
-			tt_radius_adjacency_row_sum(i) = tt_radius_adjacency.row(i).sum();
+		// the adjacency is symmetric, its rows are emitted directly as the columns of the compressed matrix:
+		// first count the neighbours of every element, then fill the rows in parallel
+		std::vector<int> outer(n_elements + 1, 0);
+		utils::maybe_parallel_for(n_elements, [&](int start, int end, int thread_id) {
+			for (int i = start; i < end; ++i)
+			{
+				int count = 0;
+				for_each_neighbour(i, [&](const int, const double) { ++count; });
+				outer[i + 1] = count;
+			}
+		});
+		std::partial_sum(outer.begin(), outer.end(), outer.begin());
+
+		std::vector<int> inner(outer[n_elements]);
+		std::vector<double> values(outer[n_elements]);
+		tt_radius_adjacency_row_sum.setZero(n_elements);
+		utils::maybe_parallel_for(n_elements, [&](int start, int end, int thread_id) {
+			std::vector<std::pair<int, double>> row;
+			for (int i = start; i < end; ++i)
+			{
+				row.clear();
+				for_each_neighbour(i, [&](const int j, const double w) { row.emplace_back(j, w); });
+				std::sort(row.begin(), row.end());
+
+				assert(int(row.size()) == outer[i + 1] - outer[i]);
+				for (int k = 0; k < row.size(); ++k)
+				{
+					inner[outer[i] + k] = row[k].first;
+					values[outer[i] + k] = row[k].second;
+					tt_radius_adjacency_row_sum(i) += row[k].second;
+				}
+			}
+		});
+
+		tt_radius_adjacency = Eigen::Map<const Eigen::SparseMatrix<double>>(n_elements, n_elements, outer[n_elements], outer.data(), inner.data(), values.data());
 	}
 
 	Eigen::VectorXd LinearFilter::eval(const Eigen::VectorXd &x) const
@@ -460,6 +550,128 @@ namespace polyfem::solver
 		return (tt_radius_adjacency * grad).array() / tt_radius_adjacency_row_sum.array();
 	}
 
+	HelmholtzFilter::HelmholtzFilter(const mesh::Mesh &mesh, const double radius)
+	{
+		Eigen::MatrixXd barycenters;
+		element_barycenters(mesh, barycenters);
+		const int n_elements = barycenters.rows();
+
+		// facets identified by their global face id in 3D and by their sorted vertices in 2D
+		std::vector<std::array<int, 3>> facets;
+		if (mesh.is_volume())
+		{
+			const mesh::Mesh3D &mesh3d = dynamic_cast<const mesh::Mesh3D &>(mesh);
+			for (int c = 0; c < n_elements; ++c)
+				for (int lf = 0; lf < mesh3d.n_cell_faces(c); ++lf)
+					facets.push_back({{mesh3d.cell_face(c, lf), -1, c}});
+		}
+		else
+		{
+			for (int f = 0; f < n_elements; ++f)
+			{
+				const int n_vertices = mesh.n_face_vertices(f);
+				for (int lv = 0; lv < n_vertices; ++lv)
+				{
+					const int v0 = mesh.face_vertex(f, lv);
+					const int v1 = mesh.face_vertex(f, (lv + 1) % n_vertices);
+					facets.push_back({{std::min(v0, v1), std::max(v0, v1), f}});
+				}
+			}
+		}
+		std::sort(facets.begin(), facets.end());
+
+		std::vector<std::vector<int>> neighbours(n_elements);
+		for (size_t k = 1; k < facets.size(); ++k)
+		{
+			if (facets[k][0] == facets[k - 1][0] && facets[k][1] == facets[k - 1][1])
+			{
+				neighbours[facets[k][2]].push_back(facets[k - 1][2]);
+				neighbours[facets[k - 1][2]].push_back(facets[k][2]);
+			}
+		}
+
+		// length scale of the Helmholtz equation equivalent to a linear filter of the given radius
+		const double r2 = radius * radius / 12.;
+
+		adjacency_start.assign(n_elements + 1, 0);
+		for (int i = 0; i < n_elements; ++i)
+			adjacency_start[i + 1] = adjacency_start[i] + neighbours[i].size();
+
+		adjacency.resize(adjacency_start.back());
+		weights.resize(adjacency_start.back());
+		diagonal.setOnes(n_elements);
+		for (int i = 0; i < n_elements; ++i)
+		{
+			for (int k = 0; k < neighbours[i].size(); ++k)
+			{
+				const int j = neighbours[i][k];
+				const double w = r2 / (barycenters.row(i) - barycenters.row(j)).squaredNorm();
+				adjacency[adjacency_start[i] + k] = j;
+				weights[adjacency_start[i] + k] = w;
+				diagonal(i) += w;
+			}
+		}
+	}
+
+	void HelmholtzFilter::apply_operator(const Eigen::VectorXd &y, Eigen::VectorXd &res) const
+	{
+		res.resize(y.size());
+		utils::maybe_parallel_for(y.size(), [&](int start, int end, int thread_id) {
+			for (int i = start; i < end; ++i)
+			{
+				double val = diagonal(i) * y(i);
+				for (int k = adjacency_start[i]; k < adjacency_start[i + 1]; ++k)
+					val -= weights[k] * y(adjacency[k]);
+				res(i) = val;
+			}
+		});
+	}
+
+	Eigen::VectorXd HelmholtzFilter::solve(const Eigen::VectorXd &b) const
+	{
+		assert(b.size() == diagonal.size());
+
+		// Jacobi preconditioned conjugate gradient, the operator is symmetric positive definite
+		constexpr double tolerance = 1e-10;
+		const double b_norm = b.norm();
+
+		Eigen::VectorXd x = b.cwiseQuotient(diagonal);
+		Eigen::VectorXd r, Ap;
+		apply_operator(x, Ap);
+		r = b - Ap;
+		Eigen::VectorXd z = r.cwiseQuotient(diagonal);
+		Eigen::VectorXd p = z;
+		double rz = r.dot(z);
+
+		int it = 0;
+		for (; it < b.size() && r.norm() > tolerance * b_norm; ++it)
+		{
+			apply_operator(p, Ap);
+			const double alpha = rz / p.dot(Ap);
+			x += alpha * p;
+			r -= alpha * Ap;
+
+			z = r.cwiseQuotient(diagonal);
+			const double rz_new = r.dot(z);
+			p = z + (rz_new / rz) * p;
+			rz = rz_new;
+		}
+		logger().trace("Helmholtz filter converged in {} iterations, residual {}", it, r.norm());
+
+		return x;
+	}
+
+	Eigen::VectorXd HelmholtzFilter::eval(const Eigen::VectorXd &x) const
+	{
+		return solve(x);
+	}
+
+	Eigen::VectorXd HelmholtzFilter::apply_jacobian(const Eigen::VectorXd &grad, const Eigen::VectorXd &x) const
+	{
+		// the operator is symmetric
+		return solve(grad);
+	}
+
 	CustomSymmetric::CustomSymmetric(const json &args)
 	{
 		for (const auto &entry : args["fixed_entries"])
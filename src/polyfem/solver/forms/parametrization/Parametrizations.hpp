@@ -168,6 +168,29 @@ namespace polyfem::solver
 		Eigen::VectorXd tt_radius_adjacency_row_sum;
 	};
 
+	/// Density filter solving the Helmholtz equation (-r² Δ + I) y = x per element, with r = radius / (2√3).
+	/// The Laplacian is the two-point stencil between the barycenters of elements sharing a facet, applied matrix-free,
+	/// so the cost does not grow with the radius as for LinearFilter.
+	class HelmholtzFilter : public Parametrization
+	{
+	public:
+		HelmholtzFilter(const mesh::Mesh &mesh, const double radius);
+
+		int size(const int x_size) const override { return x_size; }
+		Eigen::VectorXd eval(const Eigen::VectorXd &x) const override;
+		Eigen::VectorXd apply_jacobian(const Eigen::VectorXd &grad, const Eigen::VectorXd &x) const override;
+
+	private:
+		Eigen::VectorXd solve(const Eigen::VectorXd &b) const;
+		void apply_operator(const Eigen::VectorXd &y, Eigen::VectorXd &res) const;
+
+		// elements sharing a facet in compressed rows, with the stencil weights r² / |c_i - c_j|²
+		std::vector<int> adjacency_start;
+		std::vector<int> adjacency;
+		std::vector<double> weights;
+		Eigen::VectorXd diagonal;
+	};
+
 	class CustomSymmetric : public Parametrization
 	{
 	public:
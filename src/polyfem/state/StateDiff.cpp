@@ -11,6 +11,7 @@
 #include <polyfem/io/Evaluator.hpp>
 
 #include <polyfem/solver/NLProblem.hpp>
+#include <polyfem/solver/SparseNewtonDescentSolver.hpp>
 
 #include <polyfem/solver/forms/BodyForm.hpp>
 #include <polyfem/solver/forms/ContactForm.hpp>
@@ -38,6 +39,52 @@ namespace polyfem
 {
 	namespace
 	{
+		// solves A x = b with the factorization of a matrix close to A (e.g., the last Newton Hessian) using iterative refinement
+		// the residuals of all the columns of b are updated with one sparse product, returns false if the refinement does not converge
+		bool solve_with_refinement(polysolve::LinearSolver &solver, const StiffnessMatrix &A, const Eigen::MatrixXd &b, Eigen::MatrixXd &x)
+		{
+			constexpr int max_iterations = 10;
+			constexpr double tolerance = 1e-8;
+
+			const Eigen::VectorXd b_norms = b.colwise().norm().transpose();
+
+			x.setZero(b.rows(), b.cols());
+			Eigen::MatrixXd residual = b;
+			Eigen::VectorXd dx(b.rows());
+			double prev_residual_norm = std::numeric_limits<double>::infinity();
+			for (int it = 0; it <= max_iterations; ++it)
+			{
+				std::vector<int> active;
+				for (int i = 0; i < b.cols(); ++i)
+				{
+					if (residual.col(i).norm() > tolerance * b_norms(i))
+						active.push_back(i);
+				}
+
+				if (active.empty())
+				{
+					logger().debug("Adjoint solve reused the forward factorization with {} refinement steps", std::max(it - 1, 0));
+					return true;
+				}
+
+				const double residual_norm = residual.norm();
+				if (it == max_iterations || residual_norm >= prev_residual_norm)
+					break;
+				prev_residual_norm = residual_norm;
+
+				for (const int i : active)
+				{
+					dx.setZero();
+					solver.solve(residual.col(i), dx);
+					x.col(i) += dx;
+				}
+
+				residual.noalias() = b - A * x;
+			}
+
+			return false;
+		}
+
 		void replace_rows_by_identity(StiffnessMatrix &reduced_mat, const StiffnessMatrix &mat, const std::vector<int> &rows)
 		{
 			reduced_mat.resize(mat.rows(), mat.cols());
@@ -99,11 +146,18 @@ namespace polyfem
 	{
 		StiffnessMatrix gradu_h(sol.size(), sol.size());
 		if (current_step == 0)
+		{
 			diff_cached.init(ndof(), problem->is_time_dependent() ? args["time"]["time_steps"].get<int>() : 0);
-		if (!problem->is_time_dependent() || current_step > 0)
+			diff_cached.set_recompute_callback([this](const int step, StiffnessMatrix *gradu_h, ipc::CollisionConstraints *contact_set) {
+				recompute_transient_adjoint_quantities(step, gradu_h, contact_set);
+			});
+		}
+		// with checkpointing, the quantities of the other steps are recomputed during the adjoint solve
+		const bool needs_quantities = diff_cached.needs_quantities(current_step);
+		if (needs_quantities && (!problem->is_time_dependent() || current_step > 0))
 			compute_force_jacobian(sol, disp_grad, gradu_h);
 
-		auto cur_contact_set = solve_data.contact_form ? solve_data.contact_form->get_constraint_set() : ipc::CollisionConstraints();
+		auto cur_contact_set = solve_data.contact_form && needs_quantities ? solve_data.contact_form->get_constraint_set() : ipc::CollisionConstraints();
 		auto cur_friction_set = solve_data.friction_form ? solve_data.friction_form->get_friction_constraint_set() : ipc::FrictionConstraints();
 
 		if (problem->is_time_dependent())
@@ -132,12 +186,22 @@ namespace polyfem
 				acc = solve_data.time_integrator->compute_acceleration(vel);
 			}
 
-			diff_cached.cache_quantities_transient(current_step, solve_data.time_integrator->steps(), sol, vel, acc, gradu_h, cur_contact_set, cur_friction_set);
+			const double barrier_stiffness = solve_data.contact_form ? solve_data.contact_form->barrier_stiffness() : 0;
+			diff_cached.cache_quantities_transient(current_step, solve_data.time_integrator->steps(), sol, vel, acc, gradu_h, cur_contact_set, cur_friction_set, barrier_stiffness);
 		}
 		else
 		{
 			diff_cached.cache_quantities_static(sol, gradu_h, cur_contact_set, cur_friction_set);
 			diff_cached.cache_disp_grad(disp_grad);
+
+			// the nonlinear adjoint solve starts from the factorization of the last Newton iteration
+			const json &linear_args = args["solver"]["linear"];
+			if (!lin_solver_cached && linear_args["adjoint_solver"] == linear_args["solver"])
+			{
+				const auto newton = std::dynamic_pointer_cast<cppoptlib::SparseNewtonDescentSolver<solver::NLProblem>>(solve_data.nl_solver);
+				if (newton)
+					diff_cached.cache_adjoint_solver(newton->last_factorization(gradu_h.rows()), false);
+			}
 		}
 	}
 
@@ -175,6 +239,82 @@ namespace polyfem
 		}
 	}
 
+	void State::recompute_transient_adjoint_quantities(const int step, StiffnessMatrix *gradu_h, ipc::CollisionConstraints *contact_set)
+	{
+		assert(problem->is_time_dependent());
+		assert(step > 0 && step < diff_cached.size());
+
+		const int last_step = diff_cached.size() - 1;
+
+		if (gradu_h == nullptr)
+		{
+			// the contact set only depends on the solution of the step
+			if (contact_set == nullptr)
+				return;
+
+			if (solve_data.contact_form)
+			{
+				solve_data.contact_form->solution_changed(diff_cached.u(step));
+				*contact_set = solve_data.contact_form->get_constraint_set();
+				solve_data.contact_form->solution_changed(diff_cached.u(last_step));
+			}
+			else
+				*contact_set = ipc::CollisionConstraints();
+			return;
+		}
+
+		const double t0 = args["time"]["t0"];
+		const double dt = args["time"]["dt"];
+
+		const auto history_to_matrix = [](const std::deque<Eigen::VectorXd> &history) {
+			Eigen::MatrixXd mat(history.front().size(), history.size());
+			for (int i = 0; i < history.size(); ++i)
+				mat.col(i) = history[i];
+			return mat;
+		};
+
+		// state after the forward solve
+		const Eigen::MatrixXd x_prevs = history_to_matrix(solve_data.time_integrator->x_prevs());
+		const Eigen::MatrixXd v_prevs = history_to_matrix(solve_data.time_integrator->v_prevs());
+		const Eigen::MatrixXd a_prevs = history_to_matrix(solve_data.time_integrator->a_prevs());
+		const double barrier_stiffness = solve_data.contact_form ? solve_data.contact_form->barrier_stiffness() : 0;
+		const ipc::FrictionConstraints friction_set = solve_data.friction_form ? solve_data.friction_form->get_friction_constraint_set() : ipc::FrictionConstraints();
+
+		// state in which the step was solved
+		{
+			const int n_prevs = diff_cached.bdf_order(step);
+			Eigen::MatrixXd step_x_prevs(ndof(), n_prevs), step_v_prevs(ndof(), n_prevs), step_a_prevs(ndof(), n_prevs);
+			for (int i = 0; i < n_prevs; ++i)
+			{
+				step_x_prevs.col(i) = diff_cached.u(step - 1 - i);
+				step_v_prevs.col(i) = diff_cached.v(step - 1 - i);
+				step_a_prevs.col(i) = diff_cached.acc(step - 1 - i);
+			}
+
+			solve_data.time_integrator->init(step_x_prevs, step_v_prevs, step_a_prevs, dt);
+			solve_data.update_dt();
+			solve_data.nl_problem->update_quantities(t0 + step * dt, diff_cached.u(step - 1));
+			if (solve_data.contact_form)
+				solve_data.contact_form->set_barrier_stiffness(diff_cached.barrier_stiffness(step));
+			if (solve_data.friction_form)
+				solve_data.friction_form->set_friction_constraint_set(diff_cached.friction_constraint_set(step));
+		}
+
+		*gradu_h = StiffnessMatrix(ndof(), ndof());
+		compute_force_jacobian(diff_cached.u(step), Eigen::MatrixXd::Zero(mesh->dimension(), mesh->dimension()), *gradu_h);
+		if (contact_set)
+			*contact_set = solve_data.contact_form ? solve_data.contact_form->get_constraint_set() : ipc::CollisionConstraints();
+
+		// back to the state after the forward solve
+		solve_data.time_integrator->init(x_prevs, v_prevs, a_prevs, dt);
+		solve_data.update_dt();
+		solve_data.nl_problem->update_quantities(t0 + (last_step + 1) * dt, diff_cached.u(last_step));
+		if (solve_data.contact_form)
+			solve_data.contact_form->set_barrier_stiffness(barrier_stiffness);
+		if (solve_data.friction_form)
+			solve_data.friction_form->set_friction_constraint_set(friction_set);
+	}
+
 	void State::compute_force_jacobian_prev(const int force_step, const int sol_step, StiffnessMatrix &hessian_prev) const
 	{
 		assert(force_step > 0);
@@ -331,43 +471,40 @@ namespace polyfem
 		}
 		else
 		{
-			auto solver = polysolve::LinearSolver::create(args["solver"]["linear"]["adjoint_solver"], args["solver"]["linear"]["precond"]);
-			solver->setParameters(args["solver"]["linear"]);
-
-			StiffnessMatrix A = diff_cached.gradu_h(0);
-			solver->analyzePattern(A, A.rows());
-			solver->factorize(A);
+			const StiffnessMatrix A = diff_cached.gradu_h(0);
 
-			if (true) // (disp_grad_.size() == 0)
+			Eigen::MatrixXd x;
+			std::shared_ptr<polysolve::LinearSolver> solver = diff_cached.adjoint_solver();
+			if (solver && !diff_cached.is_adjoint_solver_exact() && !solve_with_refinement(*solver, A, b, x))
 			{
-				for (int i = 0; i < b.cols(); i++)
-				{
-					Eigen::MatrixXd tmp = b.col(i);
-
-					Eigen::VectorXd x;
-					x.setZero(tmp.size());
-					solver->solve(tmp, x);
+				logger().debug("Forward factorization is too far from the adjoint matrix, refactorizing");
+				solver = nullptr;
+			}
 
-					adjoint.col(i) = solve_data.nl_problem->reduced_to_full(x);
-				}
-				// NLProblem sets dirichlet values to forward BC values, but we want zero in adjoint
-				adjoint(boundary_nodes, Eigen::all).setZero();
+			if (!solver)
+			{
+				solver = polysolve::LinearSolver::create(args["solver"]["linear"]["adjoint_solver"], args["solver"]["linear"]["precond"]);
+				solver->setParameters(args["solver"]["linear"]);
+				solver->analyzePattern(A, A.rows());
+				solver->factorize(A);
+				diff_cached.cache_adjoint_solver(solver, true);
 			}
-			else
+
+			if (diff_cached.is_adjoint_solver_exact())
 			{
-				adjoint.setZero(adjoint_rhs.rows(), adjoint_rhs.cols());
+				x.setZero(b.rows(), b.cols());
 				for (int i = 0; i < b.cols(); i++)
 				{
-					Eigen::MatrixXd tmp = b.col(i);
-
-					Eigen::VectorXd x;
-					x.setZero(tmp.size());
-					solver->solve(tmp, x);
-					x.conservativeResize(adjoint.rows());
-
-					adjoint.col(i) = x;
+					Eigen::VectorXd xi = x.col(i);
+					solver->solve(b.col(i), xi);
+					x.col(i) = xi;
 				}
 			}
+
+			for (int i = 0; i < b.cols(); i++)
+				adjoint.col(i) = solve_data.nl_problem->reduced_to_full(x.col(i));
+			// NLProblem sets dirichlet values to forward BC values, but we want zero in adjoint
+			adjoint(boundary_nodes, Eigen::all).setZero();
 		}
 
 		return adjoint;
@@ -432,10 +569,13 @@ namespace polyfem
 			{
 				double beta_dt = time_integrator::BDF::betas(diff_cached.bdf_order(i) - 1) * dt;
 
-				rhs_ += (1. / beta_dt) * (diff_cached.gradu_h(i) - reduced_mass).transpose() * sum_alpha_p;
+				// fetched once, it may be read back from disk or recomputed
+				const StiffnessMatrix gradu_h = diff_cached.gradu_h(i);
+
+				rhs_ += (1. / beta_dt) * (gradu_h - reduced_mass).transpose() * sum_alpha_p;
 
 				{
-					StiffnessMatrix A = diff_cached.gradu_h(i).transpose();
+					StiffnessMatrix A = gradu_h.transpose();
 					Eigen::VectorXd b_ = rhs_;
 					b_(boundary_nodes).setZero();
 
@@ -454,7 +594,7 @@ namespace polyfem
 				if (i + 2 < cols_per_adjoint)
 					tmp += (1. / beta_dt) * adjoints(boundary_nodes, i + 2);
 
-				tmp -= (diff_cached.gradu_h(i).transpose() * adjoints.col(i + cols_per_adjoint))(boundary_nodes);
+				tmp -= (gradu_h.transpose() * adjoints.col(i + cols_per_adjoint))(boundary_nodes);
 				adjoints(boundary_nodes, i + cols_per_adjoint) = tmp;
 				adjoints.col(i) = beta_dt * adjoints.col(i + cols_per_adjoint) - sum_alpha_p;
 			}
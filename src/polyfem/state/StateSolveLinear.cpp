@@ -70,7 +70,8 @@ namespace polyfem
 		StiffnessMatrix &A,
 		Eigen::VectorXd &b,
 		const bool compute_spectrum,
-		Eigen::MatrixXd &sol, Eigen::MatrixXd &pressure)
+		Eigen::MatrixXd &sol, Eigen::MatrixXd &pressure,
+		const bool is_prefactorized)
 	{
 		assert(assembler->is_linear() && !is_contact_enabled());
 		assert(solve_data.rhs_assembler != nullptr);
@@ -79,7 +80,11 @@ namespace polyfem
 		const int precond_num = problem_dim * n_bases;
 
 		Eigen::VectorXd x;
-		if (optimization_enabled)
+		if (is_prefactorized)
+		{
+			dirichlet_solve_prefactorized(*solver, A, b, boundary_nodes, x);
+		}
+		else if (optimization_enabled)
 		{
 			auto A_tmp = A;
 			prefactorize(*solver, A, boundary_nodes, precond_num, args["output"]["data"]["stiffness_mat"]);
@@ -248,11 +253,21 @@ namespace polyfem
 
 		// --------------------------------------------------------------------
 
+		// The system matrix only depends on the time integrator coefficient (dt and the BDF order), so its
+		// factorization is reused until the coefficient changes (e.g., during the BDF startup).
+		// Mixed problems go through the full dirichlet_solve, which handles the pressure constraints.
+		const bool reuse_factorization = mixed_assembler == nullptr;
+		const int precond_num = (problem->is_scalar() ? 1 : mesh->dimension()) * n_bases;
+		StiffnessMatrix A;
+		double factorized_coeff = std::numeric_limits<double>::quiet_NaN();
+		stats.n_factorizations = 0;
+		stats.n_reused_factorizations = 0;
+
 		for (int t = 1; t <= time_steps; ++t)
 		{
 			const double time = t0 + t * dt;
 
-			StiffnessMatrix A;
+			double coeff;
 			Eigen::VectorXd b;
 			bool compute_spectrum = args["output"]["advanced"]["spectrum"];
 
@@ -277,7 +292,7 @@ namespace polyfem
 				}
 
 				std::shared_ptr<BDF> bdf = std::dynamic_pointer_cast<BDF>(time_integrator);
-				A = mass / bdf->beta_dt() + stiffness;
+				coeff = bdf->beta_dt();
 				b = (mass * bdf->weighted_sum_x_prevs()) / bdf->beta_dt();
 				for (int i : boundary_nodes)
 					b[i] = 0;
@@ -300,13 +315,39 @@ namespace polyfem
 				solve_data.rhs_assembler->set_bc(
 					local_boundary, boundary_nodes, n_b_samples, std::vector<LocalBoundary>(), current_rhs, sol, time);
 
-				A = stiffness * time_integrator->acceleration_scaling() + mass;
+				coeff = time_integrator->acceleration_scaling();
 				b = current_rhs;
 
 				compute_spectrum &= t == 1;
 			}
 
-			solve_linear(solver, A, b, compute_spectrum, sol, pressure);
+			const bool prefactorize_system = reuse_factorization && !compute_spectrum;
+			if (prefactorize_system && coeff == factorized_coeff)
+			{
+				++stats.n_reused_factorizations;
+			}
+			else
+			{
+				if (is_scalar_or_mixed)
+					A = mass / coeff + stiffness;
+				else
+					A = stiffness * coeff + mass;
+
+				if (prefactorize_system)
+				{
+					StiffnessMatrix A_tmp = A;
+					prefactorize(*solver, A_tmp, boundary_nodes, precond_num, args["output"]["data"]["stiffness_mat"]);
+					factorized_coeff = coeff;
+				}
+				else
+				{
+					// the full solve modifies A and refactorizes the solver
+					factorized_coeff = std::numeric_limits<double>::quiet_NaN();
+				}
+				++stats.n_factorizations;
+			}
+
+			solve_linear(solver, A, b, compute_spectrum, sol, pressure, prefactorize_system);
 
 			if (optimization_enabled)
 			{
@@ -320,6 +361,8 @@ namespace polyfem
 			logger().info("{}/{}  t={}", t, time_steps, time);
 		}
 
+		logger().debug("Transient linear solve: {} factorizations, {} reused", stats.n_factorizations, stats.n_reused_factorizations);
+
 		time_integrator->save_state(resolve_output_path(args["output"]["data"]["state"]));
 	}
 } // namespace polyfem
@@ -280,6 +280,7 @@ namespace polyfem
 		solve_data.nl_problem = std::make_shared<NLProblem>(
 			ndof, boundary_nodes, local_boundary, n_boundary_samples(),
 			*solve_data.rhs_assembler, t, forms);
+		solve_data.nl_solver = nullptr;
 
 		// --------------------------------------------------------------------
 
@@ -311,7 +312,10 @@ namespace polyfem
 
 		// ---------------------------------------------------------------------
 
-		std::shared_ptr<cppoptlib::NonlinearSolver<NLProblem>> nl_solver = make_nl_solver<NLProblem>();
+		// keep the solver across time steps, a new one is created in init_nonlinear_tensor_solve
+		if (solve_data.nl_solver == nullptr)
+			solve_data.nl_solver = make_nl_solver<NLProblem>();
+		std::shared_ptr<cppoptlib::NonlinearSolver<NLProblem>> nl_solver = solve_data.nl_solver;
 
 		ALSolver al_solver(
 			nl_solver, solve_data.al_lagr_form, solve_data.al_pen_form,
@@ -135,6 +135,89 @@ namespace polyfem
 		def_grad = def_grad * jac_it;
 	}
 
+	// energy, gradient, and hessian of an element from a hyperelastic energy density given in terms of the deformation gradient F
+	// stress_fun(p, F, W, P, dP_dF) computes at the quadrature point p the energy density W, the first Piola-Kirchhoff stress P = ∂W/∂F,
+	// and, if dP_dF is not null, the stress derivative ∂P_ij/∂F_kl stored at (i + j * dim, k + l * dim)
+	// the element quantities are obtained with the chain rule from the gradients of the bases, so the cost per
+	// quadrature point does not depend on the number of local dofs as with autodiff on the local displacement
+	template <int dim, typename StressFun>
+	void compute_elastic_quantities_from_stress(
+		const assembler::NonLinearAssemblerData &data,
+		const bool want_energy,
+		const bool want_grad,
+		const bool want_hess,
+		const StressFun &stress_fun,
+		double &energy,
+		Eigen::VectorXd &grad,
+		Eigen::MatrixXd &hess)
+	{
+		typedef Eigen::Matrix<double, dim, dim> DimMat;
+		typedef Eigen::Matrix<double, dim * dim, dim * dim> StressGradMat;
+
+		assert(data.x.cols() == 1);
+
+		const int n_loc_bases = int(data.vals.basis_values.size());
+		const int n_dofs = n_loc_bases * dim;
+
+		Eigen::Matrix<double, dim, Eigen::Dynamic> local_disp(dim, n_loc_bases);
+		local_disp.setZero();
+		for (int i = 0; i < n_loc_bases; ++i)
+		{
+			const auto &bs = data.vals.basis_values[i];
+			for (size_t ii = 0; ii < bs.global.size(); ++ii)
+			{
+				for (int d = 0; d < dim; ++d)
+					local_disp(d, i) += bs.global[ii].val * data.x(bs.global[ii].index * dim + d);
+			}
+		}
+
+		if (want_energy)
+			energy = 0;
+		if (want_grad)
+			grad.setZero(n_dofs);
+		if (want_hess)
+			hess.setZero(n_dofs, n_dofs);
+
+		// gradients of the bases in physical space
+		Eigen::Matrix<double, Eigen::Dynamic, dim> grad_phi(n_loc_bases, dim);
+		// ∂F/∂u, the entry (i + j * dim, b * dim + i) is the derivative of F_ij wrt the i-th component of the b-th local basis
+		Eigen::Matrix<double, dim * dim, Eigen::Dynamic> dF_du;
+		if (want_hess)
+			dF_du.setZero(dim * dim, n_dofs);
+
+		DimMat def_grad, stress;
+		StressGradMat stress_grad;
+		double val;
+
+		const int n_pts = data.da.size();
+		for (long p = 0; p < n_pts; ++p)
+		{
+			const DimMat jac_it = data.vals.jac_it[p];
+			for (int i = 0; i < n_loc_bases; ++i)
+				grad_phi.row(i) = data.vals.basis_values[i].grad.row(p) * jac_it;
+
+			def_grad = DimMat::Identity() + local_disp * grad_phi;
+
+			stress_fun(p, def_grad, val, stress, want_hess ? &stress_grad : nullptr);
+
+			if (want_energy)
+				energy += val * data.da(p);
+
+			if (want_grad)
+				Eigen::Map<Eigen::Matrix<double, dim, Eigen::Dynamic>>(grad.data(), dim, n_loc_bases) += data.da(p) * stress * grad_phi.transpose();
+
+			if (want_hess)
+			{
+				for (int b = 0; b < n_loc_bases; ++b)
+					for (int i = 0; i < dim; ++i)
+						for (int j = 0; j < dim; ++j)
+							dF_du(i + j * dim, b * dim + i) = grad_phi(b, j);
+
+				hess.noalias() += data.da(p) * dF_du.transpose() * (stress_grad * dF_du);
+			}
+		}
+	}
+
 	// https://en.wikipedia.org/wiki/Invariants_of_tensors
 	template <typename AutoDiffGradMat>
 	typename AutoDiffGradMat::Scalar first_invariant(const AutoDiffGradMat &B)
@@ -42,6 +42,38 @@ namespace polyfem
 			return (0 < x) - (x < 0);
 		}
 
+		namespace
+		{
+			// The compiled expressions are shared between threads, the
+			// variables x, y, z, and t are read from thread-local slots
+			// through non-pure functions so tinyexpr does not fold them.
+			struct ExpressionVariables
+			{
+				double x = 0, y = 0, z = 0, t = 0;
+			};
+			thread_local ExpressionVariables te_slots;
+
+			double te_slot_x() { return te_slots.x; }
+			double te_slot_y() { return te_slots.y; }
+			double te_slot_z() { return te_slots.z; }
+			double te_slot_t() { return te_slots.t; }
+
+			const std::vector<te_variable> te_vars = {
+				{"x", (const void *)te_slot_x, TE_FUNCTION0},
+				{"y", (const void *)te_slot_y, TE_FUNCTION0},
+				{"z", (const void *)te_slot_z, TE_FUNCTION0},
+				{"t", (const void *)te_slot_t, TE_FUNCTION0},
+				{"min", (const void *)min, TE_FUNCTION2},
+				{"max", (const void *)max, TE_FUNCTION2},
+				{"deg2rad", (const void *)deg2rad, TE_FUNCTION1},
+				{"rotate_2D_x", (const void *)rotate_2D_x, TE_FUNCTION3},
+				{"rotate_2D_y", (const void *)rotate_2D_y, TE_FUNCTION3},
+				{"if", (const void *)iflargerthanzerothenelse, TE_FUNCTION3},
+				{"smooth_abs", (const void *)smooth_abs, TE_FUNCTION2},
+				{"sign", (const void *)sign, TE_FUNCTION1},
+			};
+		} // namespace
+
 		ExpressionValue::ExpressionValue()
 		{
 			clear();
@@ -50,6 +82,7 @@ namespace polyfem
 		void ExpressionValue::clear()
 		{
 			expr_ = "";
+			compiled_expr_ = nullptr;
 			mat_.resize(0, 0);
 			sfunc_ = nullptr;
 			tfunc_ = nullptr;
@@ -89,32 +122,16 @@ namespace polyfem
 
 			expr_ = expr;
 
-			double x = 0, y = 0, z = 0, t = 0;
-
-			std::vector<te_variable> vars = {
-				{"x", &x, TE_VARIABLE},
-				{"y", &y, TE_VARIABLE},
-				{"z", &z, TE_VARIABLE},
-				{"t", &t, TE_VARIABLE},
-				{"min", (const void *)min, TE_FUNCTION2},
-				{"max", (const void *)max, TE_FUNCTION2},
-				{"deg2rad", (const void *)deg2rad, TE_FUNCTION1},
-				{"rotate_2D_x", (const void *)rotate_2D_x, TE_FUNCTION3},
-				{"rotate_2D_y", (const void *)rotate_2D_y, TE_FUNCTION3},
-				{"if", (const void *)iflargerthanzerothenelse, TE_FUNCTION3},
-				{"smooth_abs", (const void *)smooth_abs, TE_FUNCTION2},
-				{"sign", (const void *)sign, TE_FUNCTION1},
-			};
-
 			int err;
-			te_expr *tmp = te_compile(expr.c_str(), vars.data(), vars.size(), &err);
+			te_expr *tmp = te_compile(expr.c_str(), te_vars.data(), te_vars.size(), &err);
 			if (!tmp)
 			{
 				logger().error("Unable to parse: {}", expr);
 				logger().error("Error near here: {0: >{1}}", "^", err - 1);
 				assert(false);
+				return;
 			}
-			te_free(tmp);
+			compiled_expr_ = std::shared_ptr<te_expr>(tmp, te_free);
 		}
 
 		void ExpressionValue::init(const json &vals)
@@ -138,6 +155,7 @@ namespace polyfem
 			{
 
 				unit_ = units::unit_from_string(vals["unit"].get<std::string>());
+				update_unit_conversion();
 				init(vals["value"]);
 			}
 			else
@@ -181,6 +199,27 @@ namespace polyfem
 			tfunc_coo_ = coo;
 		}
 
+		void ExpressionValue::update_unit_conversion()
+		{
+			if (unit_.base_units().empty())
+				unit_conversion_ = UnitConversion::NONE;
+			else if (unit_.is_convertible(unit_type_))
+				unit_conversion_ = UnitConversion::CONVERT;
+			else
+				unit_conversion_ = UnitConversion::INVALID;
+		}
+
+		double ExpressionValue::convert_unit(const double val) const
+		{
+			if (unit_conversion_ == UnitConversion::NONE)
+				return val;
+
+			if (unit_conversion_ == UnitConversion::INVALID)
+				log_and_throw_error(fmt::format("Cannot convert {} to {}", units::to_string(unit_), units::to_string(unit_type_)));
+
+			return units::convert(val, unit_, unit_type_);
+		}
+
 		double ExpressionValue::operator()(double x, double y, double z, double t, int index) const
 		{
 			assert(unit_type_set_);
@@ -199,38 +238,58 @@ namespace polyfem
 			}
 			else
 			{
-
-				std::vector<te_variable> vars = {
-					{"x", &x, TE_VARIABLE},
-					{"y", &y, TE_VARIABLE},
-					{"z", &z, TE_VARIABLE},
-					{"t", &t, TE_VARIABLE},
-					{"min", (const void *)min, TE_FUNCTION2},
-					{"max", (const void *)max, TE_FUNCTION2},
-					{"deg2rad", (const void *)deg2rad, TE_FUNCTION1},
-					{"rotate_2D_x", (const void *)rotate_2D_x, TE_FUNCTION3},
-					{"rotate_2D_y", (const void *)rotate_2D_y, TE_FUNCTION3},
-					{"if", (const void *)iflargerthanzerothenelse, TE_FUNCTION3},
-					{"smooth_abs", (const void *)smooth_abs, TE_FUNCTION2},
-					{"sign", (const void *)sign, TE_FUNCTION1},
-				};
-
-				int err;
-				te_expr *tmp = te_compile(expr_.c_str(), vars.data(), vars.size(), &err);
-				assert(tmp != nullptr);
-				result = te_eval(tmp);
-				te_free(tmp);
+				assert(compiled_expr_ != nullptr);
+				te_slots.x = x;
+				te_slots.y = y;
+				te_slots.z = z;
+				te_slots.t = t;
+				result = te_eval(compiled_expr_.get());
 			}
 
-			if (!unit_.base_units().empty())
-			{
-				if (!unit_.is_convertible(unit_type_))
-					log_and_throw_error(fmt::format("Cannot convert {} to {}", units::to_string(unit_), units::to_string(unit_type_)));
+			return convert_unit(result);
+		}
 
-				result = units::convert(result, unit_, unit_type_);
+		void ExpressionValue::evaluate(const Eigen::MatrixXd &pts, double t, Eigen::VectorXd &out, int index) const
+		{
+			assert(unit_type_set_);
+			assert(pts.cols() == 2 || pts.cols() == 3);
+
+			const bool planar = pts.cols() == 2;
+			out.resize(pts.rows());
+
+			if (!expr_.empty())
+			{
+				assert(compiled_expr_ != nullptr);
+				const te_expr *expr = compiled_expr_.get();
+				te_slots.t = t;
+				for (int i = 0; i < pts.rows(); ++i)
+				{
+					te_slots.x = pts(i, 0);
+					te_slots.y = pts(i, 1);
+					te_slots.z = planar ? 0 : pts(i, 2);
+					out(i) = te_eval(expr);
+				}
+			}
+			else if (mat_.size() > 0)
+				out.setConstant(mat_(index));
+			else if (sfunc_)
+			{
+				for (int i = 0; i < pts.rows(); ++i)
+					out(i) = sfunc_(pts(i, 0), pts(i, 1), planar ? 0 : pts(i, 2), t, index);
+			}
+			else if (tfunc_)
+			{
+				for (int i = 0; i < pts.rows(); ++i)
+					out(i) = tfunc_(pts(i, 0), pts(i, 1), planar ? 0 : pts(i, 2), t)(tfunc_coo_);
 			}
+			else
+				out.setConstant(value_);
 
-			return result;
+			if (unit_conversion_ != UnitConversion::NONE)
+			{
+				for (int i = 0; i < out.size(); ++i)
+					out(i) = convert_unit(out(i));
+			}
 		}
 	} // namespace utils
 } // namespace polyfem
@@ -4,6 +4,10 @@
 
 #include <units/units.hpp>
 
+#include <memory>
+
+struct te_expr;
+
 namespace polyfem
 {
 	namespace utils
@@ -17,6 +21,7 @@ namespace polyfem
 			{
 				unit_type_ = units::unit_from_string(unit_type);
 				unit_type_set_ = true;
+				update_unit_conversion();
 			}
 
 			void init(const json &vals);
@@ -33,22 +38,42 @@ namespace polyfem
 
 			double operator()(double x, double y, double z = 0, double t = 0, int index = -1) const;
 
+			/// @brief Evaluates the expression at all the points at once
+			/// @param[in] pts Points, one per row (2 or 3 columns)
+			/// @param[in] t Time
+			/// @param[out] out Values, one per point
+			/// @param[in] index Index passed to the underlying function or matrix
+			void evaluate(const Eigen::MatrixXd &pts, double t, Eigen::VectorXd &out, int index = -1) const;
+
 			void clear();
 
 			bool is_zero() const { return expr_.empty() && fabs(value_) < 1e-10; }
 
 		private:
+			enum class UnitConversion
+			{
+				NONE,
+				CONVERT,
+				INVALID
+			};
+
+			void update_unit_conversion();
+			double convert_unit(const double val) const;
+
 			std::function<double(double x, double y, double z, double t, int index)> sfunc_;
 			std::function<Eigen::MatrixXd(double x, double y, double z, double t)> tfunc_;
 			int tfunc_coo_;
 
 			std::string expr_;
+			// compiled once in init, shared between copies
+			std::shared_ptr<te_expr> compiled_expr_;
 			double value_;
 			Eigen::MatrixXd mat_;
 
 			units::precise_unit unit_type_;
 			units::precise_unit unit_;
 			bool unit_type_set_ = false;
+			UnitConversion unit_conversion_ = UnitConversion::NONE;
 		};
 	} // namespace utils
 } // namespace polyfem
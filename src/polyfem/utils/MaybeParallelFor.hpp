@@ -10,6 +10,11 @@
 // Not using parallel for
 #endif
 
+#include <array>
+#include <cassert>
+#include <functional>
+#include <vector>
+
 namespace polyfem
 {
 	namespace utils
@@ -20,6 +25,18 @@ namespace polyfem
 		inline void maybe_parallel_for(int size, const std::function<void(int, int, int)> &partial_for);
 		inline void maybe_parallel_for(int size, const std::function<void(int)> &body);
 
+		// Perform a parallel (maybe) reduction over [0, size).
+		// `partial_reduce(start, end, init)` accumulates a range into init and returns it,
+		// `reduce(a, b)` combines two partial results, and `identity` is the neutral element.
+		// The range is split in fixed blocks whose results are combined in order, so `reduce`
+		// only needs to be associative and the result does not change between runs.
+		template <typename T>
+		inline T maybe_parallel_reduce(
+			int size,
+			const T &identity,
+			const std::function<T(int, int, const T &)> &partial_reduce,
+			const std::function<T(const T &, const T &)> &reduce);
+
 		// Returns thread specific storage for further use in `maybe_parallel_for()`.
 		// The return type depends on the threading library used.
 		//     TBB         ⟹ `std::vector<LocalStorage>`
@@ -1,8 +1,10 @@
 #include <polyfem/utils/MaybeParallelFor.hpp>
 
+#include <algorithm>
+#include <vector>
+
 #if defined(POLYFEM_WITH_TBB)
 #include <tbb/parallel_for.h>
-#include <tbb/parallel_reduce.h>
 #include <tbb/enumerable_thread_specific.h>
 #elif defined(POLYFEM_WITH_CPP_THREADS)
 #include <polyfem/utils/par_for.hpp>
@@ -31,8 +33,10 @@ namespace polyfem
 		inline void maybe_parallel_for(int size, const std::function<void(int)> &body)
 		{
 #if defined(POLYFEM_WITH_CPP_THREADS)
-			for (int i = 0; i < size; ++i)
-				body(i);
+			par_for(size, [&](int start, int end, int thread_id) {
+				for (int i = start; i < end; ++i)
+					body(i);
+			});
 #elif defined(POLYFEM_WITH_TBB)
 			tbb::parallel_for(0, size, body);
 #else
@@ -41,6 +45,33 @@ namespace polyfem
 #endif
 		}
 
+		template <typename T>
+		inline T maybe_parallel_reduce(
+			int size,
+			const T &identity,
+			const std::function<T(int, int, const T &)> &partial_reduce,
+			const std::function<T(const T &, const T &)> &reduce)
+		{
+#if defined(POLYFEM_WITH_CPP_THREADS) || defined(POLYFEM_WITH_TBB)
+			// the blocks do not depend on the scheduling nor on the number of threads and their
+			// partial results are combined in block order, so the result is the same for every run
+			if (size <= 0)
+				return identity;
+			const int n_blocks = std::min(size, 256);
+			std::vector<T> partials(n_blocks, identity);
+			maybe_parallel_for(n_blocks, [&](int start, int end, int thread_id) {
+				for (int b = start; b < end; ++b)
+					partials[b] = partial_reduce(int(long(b) * size / n_blocks), int(long(b + 1) * size / n_blocks), identity);
+			});
+			T result = identity;
+			for (const T &p : partials)
+				result = reduce(result, p);
+			return result;
+#else
+			return partial_reduce(0, size, identity);
+#endif
+		}
+
 		template <typename LocalStorage>
 		inline auto create_thread_storage(const LocalStorage &initial_local_storage)
 		{
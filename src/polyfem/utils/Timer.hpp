@@ -5,6 +5,8 @@
 #include <polyfem/utils/Logger.hpp>
 // clang-format on
 
+#include <polyfem/utils/Tracer.hpp>
+
 #include <igl/Timer.h>
 
 #define POLYFEM_SCOPED_TIMER(...) polyfem::utils::Timer __polyfem_timer(__VA_ARGS__)
@@ -36,7 +38,7 @@ namespace polyfem
 			}
 
 			Timer(const std::string &name)
-				: m_name(name)
+				: m_name(name), m_trace_id(Tracer::is_enabled() ? Tracer::scope_id(name) : -1)
 			{
 				start();
 			}
@@ -54,13 +56,13 @@ namespace polyfem
 			}
 
 			Timer(const std::string &name, double &total_time)
-				: m_name(name), m_total_time(&total_time)
+				: m_name(name), m_total_time(&total_time), m_trace_id(Tracer::is_enabled() ? Tracer::scope_id(name) : -1)
 			{
 				start();
 			}
 
 			Timer(const std::string &name, Timing &timing)
-				: m_name(name), m_total_time(&timing.time), m_count(&timing.count)
+				: m_name(name), m_total_time(&timing.time), m_count(&timing.count), m_trace_id(Tracer::is_enabled() ? Tracer::scope_id(name) : -1)
 			{
 				start();
 			}
@@ -73,6 +75,8 @@ namespace polyfem
 			inline void start()
 			{
 				is_running = true;
+				if (m_trace_id >= 0)
+					m_trace_start = Tracer::begin();
 				m_timer.start();
 			}
 
@@ -82,6 +86,8 @@ namespace polyfem
 					return;
 				m_timer.stop();
 				is_running = false;
+				if (m_trace_id >= 0)
+					Tracer::end(m_trace_id, m_trace_start);
 				log_msg();
 				if (m_total_time)
 					*m_total_time += getElapsedTimeInSec();
@@ -116,6 +122,9 @@ namespace polyfem
 			double *m_total_time = nullptr;
 			size_t *m_count = nullptr;
 			bool is_running = false;
+			// id of the name in the tracer, -1 if the timer is not traced
+			int m_trace_id = -1;
+			int64_t m_trace_start = 0;
 		};
 	} // namespace utils
 } // namespace polyfem
@@ -0,0 +1,298 @@
+#include "Tracer.hpp"
+
+#include <polyfem/utils/Logger.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace polyfem
+{
+	namespace utils
+	{
+		std::atomic<bool> Tracer::enabled_(false);
+		std::chrono::steady_clock::time_point Tracer::epoch_ = std::chrono::steady_clock::now();
+
+		namespace
+		{
+			struct TraceEvent
+			{
+				int id;
+				// number of scopes open on the thread when this one was opened
+				int depth;
+				int64_t start;
+				int64_t end;
+			};
+
+			// ring buffer of the scopes closed on a thread, only written by its thread
+			struct ThreadBuffer
+			{
+				int thread_index;
+				std::vector<TraceEvent> events;
+				size_t n_recorded = 0;
+
+				void push(const TraceEvent &event)
+				{
+					if (events.empty())
+						return;
+					events[n_recorded % events.size()] = event;
+					++n_recorded;
+				}
+
+				// the events still in the buffer, oldest first
+				std::vector<TraceEvent> ordered() const
+				{
+					if (n_recorded <= events.size())
+						return std::vector<TraceEvent>(events.begin(), events.begin() + n_recorded);
+
+					const size_t first = n_recorded % events.size();
+					std::vector<TraceEvent> res(events.begin() + first, events.end());
+					res.insert(res.end(), events.begin(), events.begin() + first);
+					return res;
+				}
+			};
+
+			struct Registry
+			{
+				std::mutex mutex;
+				std::vector<std::string> names;
+				std::unordered_map<std::string, int> name_ids;
+				std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+				size_t buffer_size = 1 << 16;
+			};
+
+			Registry &registry()
+			{
+				static Registry instance;
+				return instance;
+			}
+
+			thread_local int depth = 0;
+			thread_local std::shared_ptr<ThreadBuffer> local_buffer;
+			// the interned names never change, the cache avoids taking the lock for every scope
+			thread_local std::unordered_map<std::string, int> local_name_ids;
+
+			ThreadBuffer &thread_buffer()
+			{
+				if (!local_buffer)
+				{
+					Registry &r = registry();
+					std::lock_guard<std::mutex> lock(r.mutex);
+					local_buffer = std::make_shared<ThreadBuffer>();
+					local_buffer->thread_index = r.buffers.size();
+					local_buffer->events.resize(r.buffer_size);
+					r.buffers.push_back(local_buffer);
+				}
+				return *local_buffer;
+			}
+
+			std::string escape_json(const std::string &str)
+			{
+				std::string res;
+				res.reserve(str.size());
+				for (const char c : str)
+				{
+					if (c == '"' || c == '\\')
+					{
+						res += '\\';
+						res += c;
+					}
+					else if (static_cast<unsigned char>(c) < 0x20)
+						res += fmt::format("\\u{:04x}", int(c));
+					else
+						res += c;
+				}
+				return res;
+			}
+		} // namespace
+
+		void Tracer::enable(const size_t buffer_size)
+		{
+			{
+				Registry &r = registry();
+				std::lock_guard<std::mutex> lock(r.mutex);
+				if (buffer_size != r.buffer_size)
+				{
+					r.buffer_size = buffer_size;
+					for (auto &b : r.buffers)
+					{
+						b->events.assign(buffer_size, TraceEvent());
+						b->n_recorded = 0;
+					}
+				}
+			}
+			enabled_.store(true, std::memory_order_relaxed);
+		}
+
+		void Tracer::disable()
+		{
+			enabled_.store(false, std::memory_order_relaxed);
+		}
+
+		void Tracer::clear()
+		{
+			Registry &r = registry();
+			std::lock_guard<std::mutex> lock(r.mutex);
+			for (auto &b : r.buffers)
+				b->n_recorded = 0;
+		}
+
+		int Tracer::scope_id(const std::string &name)
+		{
+			const auto it = local_name_ids.find(name);
+			if (it != local_name_ids.end())
+				return it->second;
+
+			Registry &r = registry();
+			int id;
+			{
+				std::lock_guard<std::mutex> lock(r.mutex);
+				const auto res = r.name_ids.emplace(name, int(r.names.size()));
+				if (res.second)
+					r.names.push_back(name);
+				id = res.first->second;
+			}
+			local_name_ids.emplace(name, id);
+			return id;
+		}
+
+		int64_t Tracer::begin()
+		{
+			++depth;
+			return now();
+		}
+
+		void Tracer::end(const int id, const int64_t start)
+		{
+			const int64_t end = now();
+			--depth;
+			thread_buffer().push({id, depth, start, end});
+		}
+
+		void Tracer::write_chrome_trace(std::ostream &out)
+		{
+			Registry &r = registry();
+			std::lock_guard<std::mutex> lock(r.mutex);
+
+			out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+			bool first = true;
+			for (const auto &b : r.buffers)
+			{
+				out << (first ? "\n" : ",\n");
+				first = false;
+				out << fmt::format(
+					"{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":{},\"args\":{{\"name\":\"thread {}\"}}}}",
+					b->thread_index, b->thread_index);
+
+				for (const TraceEvent &e : b->ordered())
+				{
+					// the times are in us
+					out << fmt::format(
+						",\n{{\"name\":\"{}\",\"cat\":\"polyfem\",\"ph\":\"X\",\"pid\":0,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+						escape_json(r.names[e.id]), b->thread_index, e.start * 1e-3, (e.end - e.start) * 1e-3);
+				}
+			}
+			out << "\n]}\n";
+		}
+
+		bool Tracer::write_chrome_trace(const std::string &path)
+		{
+			std::ofstream out(path);
+			if (!out.good())
+			{
+				logger().error("Unable to write the trace to {}", path);
+				return false;
+			}
+
+			write_chrome_trace(out);
+			logger().info("Saved the trace to {}", path);
+			if (n_dropped() > 0)
+				logger().warn("{} scopes were dropped from the trace, increase the buffer size", n_dropped());
+
+			return out.good();
+		}
+
+		void Tracer::write_summary(std::ostream &out)
+		{
+			struct PathStats
+			{
+				size_t calls = 0;
+				int64_t total = 0;
+				int64_t self = 0;
+				int64_t max = 0;
+			};
+
+			// the call paths are sequences of scope ids, parents come before their children
+			std::map<std::vector<int>, PathStats> stats;
+
+			Registry &r = registry();
+			std::lock_guard<std::mutex> lock(r.mutex);
+
+			for (const auto &b : r.buffers)
+			{
+				std::vector<TraceEvent> events = b->ordered();
+				std::sort(events.begin(), events.end(), [](const TraceEvent &lhs, const TraceEvent &rhs) {
+					return lhs.start < rhs.start || (lhs.start == rhs.start && lhs.depth < rhs.depth);
+				});
+
+				struct OpenScope
+				{
+					const TraceEvent *event;
+					std::vector<int> path;
+					int64_t children_time;
+				};
+				std::vector<OpenScope> stack;
+
+				const auto close = [&]() {
+					const OpenScope &s = stack.back();
+					const int64_t duration = s.event->end - s.event->start;
+
+					PathStats &p = stats[s.path];
+					++p.calls;
+					p.total += duration;
+					p.self += duration - s.children_time;
+					p.max = std::max(p.max, duration);
+
+					stack.pop_back();
+					if (!stack.empty())
+						stack.back().children_time += duration;
+				};
+
+				for (const TraceEvent &e : events)
+				{
+					// the parents of the oldest scopes may have been dropped, hence the check on the times
+					while (!stack.empty() && (stack.size() > size_t(e.depth) || stack.back().event->end < e.start))
+						close();
+
+					std::vector<int> path = stack.empty() ? std::vector<int>() : stack.back().path;
+					path.push_back(e.id);
+					stack.push_back({&e, std::move(path), 0});
+				}
+				while (!stack.empty())
+					close();
+			}
+
+			out << fmt::format("{:<60} {:>10} {:>12} {:>12} {:>12}\n", "scope", "calls", "total [s]", "self [s]", "max [s]");
+			for (const auto &[path, p] : stats)
+			{
+				const std::string name = std::string(2 * (path.size() - 1), ' ') + r.names[path.back()];
+				out << fmt::format("{:<60} {:>10} {:>12.6f} {:>12.6f} {:>12.6f}\n", name, p.calls, p.total * 1e-9, p.self * 1e-9, p.max * 1e-9);
+			}
+		}
+
+		size_t Tracer::n_dropped()
+		{
+			Registry &r = registry();
+			std::lock_guard<std::mutex> lock(r.mutex);
+
+			size_t n = 0;
+			for (const auto &b : r.buffers)
+				n += b->n_recorded - std::min(b->n_recorded, b->events.size());
+			return n;
+		}
+	} // namespace utils
+} // namespace polyfem
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// records the scope in the trace, name is only evaluated when tracing is enabled
+#define POLYFEM_TRACE_SCOPE(name) polyfem::utils::TraceScope __polyfem_trace_scope(polyfem::utils::Tracer::is_enabled() ? polyfem::utils::Tracer::scope_id(name) : -1)
+
+namespace polyfem
+{
+	namespace utils
+	{
+		/// Records nested timed scopes (the named POLYFEM_SCOPED_TIMER and POLYFEM_TRACE_SCOPE)
+		/// in a fixed size ring buffer per thread. When disabled recording a scope costs a relaxed atomic load.
+		///
+		/// The exports read the buffers of all threads, they must be called when no traced code is running.
+		class Tracer
+		{
+		public:
+			/// starts recording, every thread keeps its last buffer_size scopes
+			static void enable(const size_t buffer_size = 1 << 16);
+			/// stops recording, the recorded scopes are kept until clear
+			static void disable();
+			/// drops all the recorded scopes
+			static void clear();
+
+			static bool is_enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+			/// id of the scope name, the names are interned once per thread
+			static int scope_id(const std::string &name);
+
+			/// opens a scope on the calling thread, returns its start time
+			static int64_t begin();
+			/// closes the last scope opened with begin on the calling thread
+			static void end(const int id, const int64_t start);
+
+			/// writes the recorded scopes in the Chrome trace event format (chrome://tracing, ui.perfetto.dev)
+			static void write_chrome_trace(std::ostream &out);
+			static bool write_chrome_trace(const std::string &path);
+
+			/// writes the number of calls, total, self, and max time of every call path
+			static void write_summary(std::ostream &out);
+
+			/// number of scopes overwritten because a ring buffer was full
+			static size_t n_dropped();
+
+			/// current time in ns since the start of the program
+			static int64_t now()
+			{
+				return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch_).count();
+			}
+
+		private:
+			static std::atomic<bool> enabled_;
+			static std::chrono::steady_clock::time_point epoch_;
+		};
+
+		/// RAII scope of the tracer, does nothing if id is negative
+		class TraceScope
+		{
+		public:
+			explicit TraceScope(const int id)
+				: id_(id)
+			{
+				if (id_ >= 0)
+					start_ = Tracer::begin();
+			}
+
+			~TraceScope()
+			{
+				if (id_ >= 0)
+					Tracer::end(id_, start_);
+			}
+
+			TraceScope(const TraceScope &) = delete;
+			TraceScope &operator=(const TraceScope &) = delete;
+
+		private:
+			int id_;
+			int64_t start_ = 0;
+		};
+	} // namespace utils
+} // namespace polyfem
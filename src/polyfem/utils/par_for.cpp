@@ -3,25 +3,214 @@
 #include <vector>
 #include <algorithm>
 
+#ifdef POLYFEM_WITH_CPP_THREADS
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#endif
+
 namespace polyfem
 {
 	namespace utils
 	{
+#ifdef POLYFEM_WITH_CPP_THREADS
+		namespace
+		{
+			// true on the threads running a loop of the pool, nested loops run serially on them
+			thread_local bool in_parallel_region = false;
+
+			// persistent pool of get_n_threads() - 1 workers, the thread calling run is the worker 0
+			// the loop is split in chunks, every worker starts with a contiguous range of chunks
+			// and steals from the back of the others when it is done with its own
+			class ThreadPool
+			{
+			public:
+				static ThreadPool &instance()
+				{
+					static ThreadPool pool;
+					return pool;
+				}
+
+				~ThreadPool()
+				{
+					resize(0);
+				}
+
+				// returns false if the pool is already running a loop for another thread
+				bool run(const int size, const std::function<void(int, int, int)> &func)
+				{
+					std::unique_lock<std::mutex> run_lock(run_mutex_, std::try_to_lock);
+					if (!run_lock.owns_lock())
+						return false;
+
+					const int n_threads = std::max<int>(1, get_n_threads());
+					if (workers_.size() + 1 != n_threads)
+						resize(n_threads - 1);
+
+					// about 8 chunks per thread, enough to balance elements of different costs
+					func_ = &func;
+					size_ = size;
+					grain_ = std::max(1, size / (8 * n_threads));
+					const int n_chunks = (size + grain_ - 1) / grain_;
+					for (int t = 0; t < n_threads; ++t)
+					{
+						queues_[t].begin = int(long(t) * n_chunks / n_threads);
+						queues_[t].end = int(long(t + 1) * n_chunks / n_threads);
+					}
+					exception_ = nullptr;
+
+					{
+						std::lock_guard<std::mutex> lock(mutex_);
+						n_running_ = workers_.size();
+						++generation_;
+					}
+					cv_.notify_all();
+
+					in_parallel_region = true;
+					work(0);
+					in_parallel_region = false;
+
+					{
+						std::unique_lock<std::mutex> lock(mutex_);
+						done_cv_.wait(lock, [&]() { return n_running_ == 0; });
+					}
+
+					func_ = nullptr;
+					if (exception_)
+						std::rethrow_exception(exception_);
+
+					return true;
+				}
+
+			private:
+				ThreadPool() = default;
+
+				struct ChunkQueue
+				{
+					std::mutex mutex;
+					int begin = 0;
+					int end = 0;
+				};
+
+				void resize(const int n_workers)
+				{
+					{
+						std::lock_guard<std::mutex> lock(mutex_);
+						stop_ = true;
+					}
+					cv_.notify_all();
+					for (std::thread &w : workers_)
+						w.join();
+					workers_.clear();
+
+					stop_ = false;
+					queues_ = std::make_unique<ChunkQueue[]>(n_workers + 1);
+					workers_.reserve(n_workers);
+					// the workers wait for the loops submitted after their creation
+					for (int t = 1; t <= n_workers; ++t)
+						workers_.emplace_back([this, t, generation = generation_]() { worker_loop(t, generation); });
+				}
+
+				void worker_loop(const int thread_id, size_t seen_generation)
+				{
+					in_parallel_region = true;
+					while (true)
+					{
+						{
+							std::unique_lock<std::mutex> lock(mutex_);
+							cv_.wait(lock, [&]() { return stop_ || generation_ != seen_generation; });
+							if (stop_)
+								return;
+							seen_generation = generation_;
+						}
+
+						work(thread_id);
+
+						{
+							std::lock_guard<std::mutex> lock(mutex_);
+							if (--n_running_ == 0)
+								done_cv_.notify_one();
+						}
+					}
+				}
+
+				bool pop(const int thread_id, int &chunk)
+				{
+					ChunkQueue &q = queues_[thread_id];
+					std::lock_guard<std::mutex> lock(q.mutex);
+					if (q.begin >= q.end)
+						return false;
+					chunk = q.begin++;
+					return true;
+				}
+
+				bool steal(const int thread_id, int &chunk)
+				{
+					const int n_threads = workers_.size() + 1;
+					for (int k = 1; k < n_threads; ++k)
+					{
+						ChunkQueue &q = queues_[(thread_id + k) % n_threads];
+						std::lock_guard<std::mutex> lock(q.mutex);
+						if (q.begin < q.end)
+						{
+							chunk = --q.end;
+							return true;
+						}
+					}
+					return false;
+				}
+
+				void work(const int thread_id)
+				{
+					int chunk;
+					while (pop(thread_id, chunk) || steal(thread_id, chunk))
+					{
+						const int start = chunk * grain_;
+						const int end = std::min(size_, start + grain_);
+						try
+						{
+							(*func_)(start, end, thread_id);
+						}
+						catch (...)
+						{
+							std::lock_guard<std::mutex> lock(mutex_);
+							if (!exception_)
+								exception_ = std::current_exception();
+						}
+					}
+				}
+
+				std::vector<std::thread> workers_;
+				std::unique_ptr<ChunkQueue[]> queues_;
+
+				// serializes the loops submitted from different threads
+				std::mutex run_mutex_;
+
+				std::mutex mutex_;
+				std::condition_variable cv_;
+				std::condition_variable done_cv_;
+				size_t generation_ = 0;
+				size_t n_running_ = 0;
+				bool stop_ = false;
+
+				const std::function<void(int, int, int)> *func_ = nullptr;
+				int size_ = 0;
+				int grain_ = 1;
+				std::exception_ptr exception_;
+			};
+		} // namespace
+#endif
+
 		void par_for(const int size, const std::function<void(int, int, int)> &func)
 		{
 #ifdef POLYFEM_WITH_CPP_THREADS
-			const size_t n_threads = get_n_threads();
-			std::vector<std::thread> threads(n_threads);
+			if (size <= 0)
+				return;
 
-			for (int t = 0; t < n_threads; t++)
-			{
-				threads[t] = std::thread(std::bind(
-					func,
-					t * size / n_threads,
-					(t + 1) == n_threads ? size : (t + 1) * size / n_threads,
-					t));
-			}
-			std::for_each(threads.begin(), threads.end(), [](std::thread &x) { x.join(); });
+			// nested loops, loops submitted while the pool is busy, and tiny loops run on the calling thread
+			if (in_parallel_region || size == 1 || get_n_threads() <= 1 || !ThreadPool::instance().run(size, func))
+				func(0, size, 0);
 #endif
 		}
 	} // namespace utils
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <functional>
 #include <thread>
 
@@ -18,9 +19,11 @@ namespace polyfem
 			}
 
 		private:
-			NThread() {}
+			NThread() : num_threads(std::max(1u, std::thread::hardware_concurrency())) {}
 		};
 
+		// runs func(start, end, thread_id) on chunks of [0, size) with a persistent pool of get_n_threads() threads
+		// the chunks are scheduled dynamically, a thread can get several chunks but never two at the same time
 		void par_for(const int size, const std::function<void(int, int, int)> &func);
 		inline size_t get_n_threads() { return NThread::get().num_threads; }
 	} // namespace utils
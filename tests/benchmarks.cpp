@@ -0,0 +1,387 @@
+////////////////////////////////////////////////////////////////////////////////
+#include <polyfem/State.hpp>
+#include <polyfem/Common.hpp>
+#include <polyfem/assembler/AssemblyValsCache.hpp>
+#include <polyfem/assembler/RhsAssembler.hpp>
+#include <polyfem/solver/forms/ContactForm.hpp>
+#include <polyfem/utils/Logger.hpp>
+#include <polyfem/utils/MatrixCache.hpp>
+#include <polyfem/utils/par_for.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/generators/catch_generators_range.hpp>
+#include <catch2/reporters/catch_reporter_event_listener.hpp>
+#include <catch2/reporters/catch_reporter_registrars.hpp>
+
+#include <array>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+////////////////////////////////////////////////////////////////////////////////
+
+using namespace polyfem;
+using namespace polyfem::assembler;
+using namespace polyfem::solver;
+using namespace polyfem::utils;
+
+namespace
+{
+	// unit cube split in n^3 hexes or 6 n^3 tets, discretized with bases of the given order
+	struct CubeConfig
+	{
+		bool is_hex;
+		int n;
+		int order;
+
+		std::string name() const
+		{
+			return fmt::format("{} n={} {}{}", is_hex ? "hex" : "tet", n, is_hex ? "Q" : "P", order);
+		}
+	};
+
+	// P1-P4 tets and Q1-Q3 hexes at several resolutions, skipping the ones with more than max_nodes_per_side^3 nodes
+	std::vector<CubeConfig> cube_configs(const int max_nodes_per_side = 32)
+	{
+		std::vector<CubeConfig> configs;
+		for (const bool is_hex : {false, true})
+		{
+			for (int order = 1; order <= (is_hex ? 3 : 4); ++order)
+			{
+				for (const int n : {4, 8, 16})
+				{
+					if (n * order <= max_nodes_per_side)
+						configs.push_back({is_hex, n, order});
+				}
+			}
+		}
+		return configs;
+	}
+
+	// every nonlinear assembler of AssemblerUtils on a displacement field, the mixed, fluid, scalar,
+	// and multi-model formulations need other unknowns or a per-element model
+	const std::vector<std::string> materials = {
+		"LinearElasticity", "HookeLinearElasticity", "SaintVenant", "NeoHookean",
+		"MooneyRivlin", "MooneyRivlin3Param", "UnconstrainedOgden", "IncompressibleOgden", "AMIPS"};
+
+	void regular_cube(const int n, const bool is_hex, Eigen::MatrixXd &V, Eigen::MatrixXi &F)
+	{
+		const auto vid = [n](const int i, const int j, const int k) { return i + (n + 1) * (j + (n + 1) * k); };
+
+		// corners of a hex in the order of the hex bases
+		static const std::array<std::array<int, 3>, 8> corners = {{{{0, 0, 0}}, {{1, 0, 0}}, {{1, 1, 0}}, {{0, 1, 0}}, {{0, 0, 1}}, {{1, 0, 1}}, {{1, 1, 1}}, {{0, 1, 1}}}};
+		// Kuhn split around the diagonal 0-6, it is conforming since all the hexes have the same orientation
+		static const std::array<std::array<int, 4>, 6> kuhn = {{{{0, 1, 2, 6}}, {{0, 2, 3, 6}}, {{0, 3, 7, 6}}, {{0, 7, 4, 6}}, {{0, 4, 5, 6}}, {{0, 5, 1, 6}}}};
+
+		V.resize((n + 1) * (n + 1) * (n + 1), 3);
+		for (int k = 0; k <= n; ++k)
+			for (int j = 0; j <= n; ++j)
+				for (int i = 0; i <= n; ++i)
+					V.row(vid(i, j, k)) << i / double(n), j / double(n), k / double(n);
+
+		F.resize(n * n * n * (is_hex ? 1 : 6), is_hex ? 8 : 4);
+		int index = 0;
+		for (int k = 0; k < n; ++k)
+		{
+			for (int j = 0; j < n; ++j)
+			{
+				for (int i = 0; i < n; ++i)
+				{
+					std::array<int, 8> hex;
+					for (int c = 0; c < 8; ++c)
+						hex[c] = vid(i + corners[c][0], j + corners[c][1], k + corners[c][2]);
+
+					if (is_hex)
+					{
+						for (int c = 0; c < 8; ++c)
+							F(index, c) = hex[c];
+						++index;
+						continue;
+					}
+
+					for (const auto &tet : kuhn)
+					{
+						for (int c = 0; c < 4; ++c)
+							F(index, c) = hex[tet[c]];
+
+						const Eigen::Vector3d e0 = V.row(F(index, 1)) - V.row(F(index, 0));
+						const Eigen::Vector3d e1 = V.row(F(index, 2)) - V.row(F(index, 0));
+						const Eigen::Vector3d e2 = V.row(F(index, 3)) - V.row(F(index, 0));
+						if (e0.cross(e1).dot(e2) < 0)
+							std::swap(F(index, 2), F(index, 3));
+						++index;
+					}
+				}
+			}
+		}
+		assert(index == F.rows());
+	}
+
+	json material_params(const std::string &material)
+	{
+		if (material == "MooneyRivlin")
+			return {{"type", material}, {"c1", 1e3}, {"c2", 1e3}, {"k", 1e4}};
+		if (material == "MooneyRivlin3Param")
+			return {{"type", material}, {"c1", 1e3}, {"c2", 1e3}, {"c3", 1e3}, {"d1", 1e4}};
+		if (material == "UnconstrainedOgden")
+			return {{"type", material}, {"alphas", {2}}, {"mus", {1e4}}, {"Ds", {1e-4}}};
+		if (material == "IncompressibleOgden")
+			return {{"type", material}, {"c", {1e4}}, {"m", {2}}, {"k", 1e5}};
+		if (material == "AMIPS")
+			return {{"type", material}};
+		return {{"type", material}, {"E", 1e5}, {"nu", 0.3}};
+	}
+
+	// the cube is clamped at x = 0 and pulled at x = 1
+	std::shared_ptr<State> make_state(const CubeConfig &config, const std::string &material)
+	{
+		json args = R"({
+			"boundary_conditions": {
+				"dirichlet_boundary": [
+					{"id": 1, "value": [0, 0, 0]},
+					{"id": 2, "value": [0.1, 0, 0]}
+				],
+				"rhs": [0, 0, 0]
+			},
+			"solver": {
+				"linear": {"solver": "Eigen::SimplicialLDLT"},
+				"nonlinear": {"max_iterations": 1, "allow_out_of_iterations": true}
+			}
+		})"_json;
+		// the spec requires a geometry, the mesh is replaced by the generated one
+		args["geometry"] = {{"mesh", std::string(POLYFEM_DATA_DIR) + "/contact/meshes/3D/simple/bar/bar-6.msh"}};
+		args["materials"] = material_params(material);
+		args["space"]["discr_order"] = config.order;
+
+		auto state = std::make_shared<State>();
+		state->init_logger("", spdlog::level::err, spdlog::level::off, false);
+		state->init(args, true);
+
+		Eigen::MatrixXd V;
+		Eigen::MatrixXi F;
+		regular_cube(config.n, config.is_hex, V, F);
+		state->load_mesh(V, F);
+		state->set_boundary_side_set([](const RowVectorNd &p) {
+			if (p(0) < 1e-7)
+				return 1;
+			if (p(0) > 1 - 1e-7)
+				return 2;
+			return 3;
+		});
+
+		state->build_basis();
+		state->assemble_rhs();
+		state->assemble_mass_mat();
+
+		return state;
+	}
+
+	// same displacement at every run
+	Eigen::VectorXd random_displacement(const State &state, const double scale)
+	{
+		std::mt19937 gen(42);
+		std::uniform_real_distribution<double> dist(-scale, scale);
+
+		Eigen::VectorXd disp(state.n_bases * state.mesh->dimension());
+		for (int i = 0; i < disp.size(); ++i)
+			disp(i) = dist(gen);
+		return disp;
+	}
+
+	// writes the results of all the benchmarks of the run to POLYFEM_BENCHMARK_JSON (default polyfem_benchmarks.json)
+	// Catch2 has no json reporter, the results are collected by a listener next to the console reporter
+	class JSONBenchmarkListener : public Catch::EventListenerBase
+	{
+	public:
+		using Catch::EventListenerBase::EventListenerBase;
+
+		void testCaseStarting(const Catch::TestCaseInfo &info) override
+		{
+			test_case_ = info.name;
+		}
+
+		void benchmarkEnded(const Catch::BenchmarkStats<> &stats) override
+		{
+			json entry;
+			entry["test_case"] = test_case_;
+			entry["name"] = stats.info.name;
+			entry["samples"] = stats.info.samples;
+			entry["iterations"] = stats.info.iterations;
+			entry["mean_ns"] = stats.mean.point.count();
+			entry["mean_lower_bound_ns"] = stats.mean.lower_bound.count();
+			entry["mean_upper_bound_ns"] = stats.mean.upper_bound.count();
+			entry["std_dev_ns"] = stats.standardDeviation.point.count();
+			entry["outlier_variance"] = stats.outlierVariance;
+			results_.push_back(entry);
+		}
+
+		void testRunEnded(const Catch::TestRunStats &) override
+		{
+			if (results_.empty())
+				return;
+
+			const char *env_path = std::getenv("POLYFEM_BENCHMARK_JSON");
+			const std::string path = env_path == nullptr ? "polyfem_benchmarks.json" : env_path;
+
+			json out;
+#ifdef NDEBUG
+			out["build"] = "release";
+#else
+			out["build"] = "debug";
+#endif
+			out["n_threads"] = get_n_threads();
+			out["benchmarks"] = results_;
+
+			std::ofstream file(path);
+			if (!file.good())
+			{
+				logger().error("Unable to write the benchmark results to {}", path);
+				return;
+			}
+			file << out.dump(1, '\t') << std::endl;
+			logger().info("Benchmark results written to {}", path);
+		}
+
+	private:
+		std::string test_case_;
+		json results_ = json::array();
+	};
+} // namespace
+
+CATCH_REGISTER_LISTENER(JSONBenchmarkListener)
+
+TEST_CASE("State::build_basis", "[benchmark][basis]")
+{
+	const CubeConfig config = GENERATE(from_range(cube_configs()));
+	const auto state = make_state(config, "LinearElasticity");
+
+	// bases, node ids, boundary nodes and the assembly caches of the mesh
+	BENCHMARK(config.name())
+	{
+		state->build_basis();
+		return state->n_bases;
+	};
+}
+
+TEST_CASE("LinearAssembler::assemble", "[benchmark][assembler]")
+{
+	const CubeConfig config = GENERATE(from_range(cube_configs()));
+	const auto state = make_state(config, "LinearElasticity");
+
+	BENCHMARK(config.name())
+	{
+		StiffnessMatrix stiffness;
+		state->assembler->assemble(true, state->n_bases, state->bases, state->geom_bases(), state->ass_vals_cache, stiffness);
+		return stiffness.nonZeros();
+	};
+}
+
+TEST_CASE("NLAssembler::assemble_hessian", "[benchmark][assembler]")
+{
+	const CubeConfig config = GENERATE(from_range(cube_configs()));
+	const std::string material = GENERATE(from_range(materials));
+	const auto state = make_state(config, material);
+
+	const Eigen::MatrixXd disp = random_displacement(*state, 1e-3 / config.n);
+	// the cache keeps the sparsity pattern between the calls, as in the Newton iterations
+	SparseMatrixCache mat_cache;
+
+	BENCHMARK(fmt::format("{} {}", material, config.name()))
+	{
+		StiffnessMatrix hessian;
+		state->assembler->assemble_hessian(true, state->n_bases, false, state->bases, state->geom_bases(), state->ass_vals_cache, 0, disp, Eigen::MatrixXd(), mat_cache, hessian);
+		return hessian.nonZeros();
+	};
+}
+
+TEST_CASE("AssemblyValsCache::init", "[benchmark][assembler]")
+{
+	const CubeConfig config = GENERATE(from_range(cube_configs()));
+	const auto state = make_state(config, "LinearElasticity");
+
+	BENCHMARK(config.name())
+	{
+		AssemblyValsCache cache;
+		cache.init(true, state->bases, state->geom_bases());
+		return cache.memory_usage();
+	};
+}
+
+TEST_CASE("RhsAssembler::set_bc", "[benchmark][assembler]")
+{
+	const CubeConfig config = GENERATE(from_range(cube_configs()));
+	const auto state = make_state(config, "LinearElasticity");
+
+	Eigen::MatrixXd rhs = state->rhs;
+
+	BENCHMARK(config.name())
+	{
+		state->solve_data.rhs_assembler->set_bc(
+			state->local_boundary, state->boundary_nodes, state->n_boundary_samples(), state->local_neumann_boundary, rhs);
+		return rhs.sum();
+	};
+}
+
+TEST_CASE("ContactForm", "[benchmark][contact]")
+{
+	const CubeConfig config = GENERATE(from_range(cube_configs()));
+	const auto state = make_state(config, "LinearElasticity");
+
+	ContactForm form(
+		state->collision_mesh, /*dhat=*/0.5 / config.n, state->avg_mass,
+		/*use_convergent_formulation=*/false, /*use_adaptive_barrier_stiffness=*/false,
+		/*is_time_dependent=*/false, /*enable_shape_derivatives=*/false,
+		ipc::BroadPhaseMethod::HASH_GRID, /*ccd_tolerance=*/1e-6, /*ccd_max_iterations=*/1000000);
+	form.set_barrier_stiffness(1);
+
+	const Eigen::VectorXd x0 = Eigen::VectorXd::Zero(state->n_bases * 3);
+	const Eigen::VectorXd x1 = random_displacement(*state, 0.1 / config.n);
+	form.init(x0);
+
+	BENCHMARK(fmt::format("update {}", config.name()))
+	{
+		form.solution_changed(x1);
+		return form.value(x1);
+	};
+
+	BENCHMARK(fmt::format("CCD {}", config.name()))
+	{
+		return form.max_step_size(x0, x1);
+	};
+}
+
+TEST_CASE("OutGeometryData::save_vtu", "[benchmark][output]")
+{
+	const CubeConfig config = GENERATE(from_range(cube_configs()));
+	const auto state = make_state(config, "LinearElasticity");
+
+	const Eigen::MatrixXd sol = random_displacement(*state, 1e-3 / config.n);
+	const Eigen::MatrixXd pressure;
+	const std::string path = (std::filesystem::temp_directory_path() / "polyfem_benchmark.vtu").string();
+	const io::OutGeometryData::ExportOptions opts(state->args, state->mesh->is_linear(), state->problem->is_scalar(), state->solve_export_to_file);
+
+	BENCHMARK(config.name())
+	{
+		std::vector<io::SolutionFrame> solution_frames;
+		state->out_geom.save_vtu(path, *state, sol, pressure, 0, 1, opts, state->is_contact_enabled(), solution_frames);
+		return solution_frames.size();
+	};
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("Newton step", "[benchmark][solver]")
+{
+	const CubeConfig config = GENERATE(from_range(cube_configs(16)));
+	const auto state = make_state(config, "NeoHookean");
+
+	// a single iteration including the setup of the forms and the linear solver
+	BENCHMARK(config.name())
+	{
+		Eigen::MatrixXd sol, pressure;
+		state->solve_problem(sol, pressure);
+		return sol.norm();
+	};
+}
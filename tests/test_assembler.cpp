@@ -1,11 +1,20 @@
 #include <polyfem/State.hpp>
+#include <polyfem/basis/NodeOrdering.hpp>
 
+#include <polyfem/assembler/Laplacian.hpp>
+#include <polyfem/assembler/MooneyRivlinElasticity.hpp>
 #include <polyfem/assembler/NeoHookeanElasticity.hpp>
 #include <polyfem/assembler/NeoHookeanElasticityAutodiff.hpp>
+#include <polyfem/assembler/SaintVenantElasticity.hpp>
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
+#include <catch2/generators/catch_generators.hpp>
 
+#include <finitediff.hpp>
+
+#include <algorithm>
+#include <filesystem>
 #include <iostream>
 
 using namespace polyfem;
@@ -284,3 +293,468 @@ TEST_CASE("generic_elastic_assembler", "[assembler]")
 		}
 	}
 }
+
+TEST_CASE("closed_form_elastic_stress", "[assembler]")
+{
+	const int dim = GENERATE(2, 3);
+	const std::string material = GENERATE("SaintVenant", "MooneyRivlin");
+
+	const std::string path = POLYFEM_DATA_DIR;
+	json in_args = json({});
+	in_args["geometry"] = {};
+	in_args["geometry"]["mesh"] = path + (dim == 2 ? "/plane_hole.obj" : "/contact/meshes/3D/simple/cube.msh");
+
+	in_args["materials"] = {};
+	in_args["materials"]["type"] = material;
+	if (material == "MooneyRivlin")
+	{
+		in_args["materials"]["c1"] = 1e3;
+		in_args["materials"]["c2"] = 1e3;
+		in_args["materials"]["k"] = 1e4;
+	}
+	else
+	{
+		in_args["materials"]["E"] = 1e5;
+		in_args["materials"]["nu"] = 0.3;
+	}
+
+	in_args["space"] = {};
+	in_args["space"]["discr_order"] = 2;
+
+	State state;
+	state.init_logger("", spdlog::level::err, spdlog::level::off, false);
+	state.init(in_args, true);
+	state.load_mesh();
+	state.build_basis();
+
+	SaintVenantElasticity saint_venant;
+	MooneyRivlinElasticity mooney_rivlin;
+	// the per element kernels are only public in the materials
+	const auto check = [&](auto &assembler) {
+		assembler.set_size(dim);
+		assembler.add_multimaterial(0, in_args["materials"], state.units);
+
+		const int el_id = 0;
+		const auto &bs = state.bases[el_id];
+		ElementAssemblyValues vals;
+		vals.compute(el_id, dim == 3, bs, state.geom_bases()[el_id]);
+		const Eigen::MatrixXd da = vals.det.array() * vals.quadrature.weights.array();
+
+		// the energy of the element only depends on its local dofs
+		Eigen::MatrixXd displacement = Eigen::MatrixXd::Zero(state.n_bases * dim, 1);
+		const auto set_local = [&](const Eigen::VectorXd &x) {
+			for (size_t i = 0; i < bs.bases.size(); ++i)
+				for (int d = 0; d < dim; ++d)
+					displacement(bs.bases[i].global()[0].index * dim + d) = x(i * dim + d);
+		};
+
+		const auto energy = [&](const Eigen::VectorXd &x) {
+			set_local(x);
+			return assembler.compute_energy(NonLinearAssemblerData(vals, 0, displacement, displacement, da));
+		};
+		const auto gradient = [&](const Eigen::VectorXd &x) -> Eigen::VectorXd {
+			set_local(x);
+			return assembler.assemble_gradient(NonLinearAssemblerData(vals, 0, displacement, displacement, da));
+		};
+
+		for (int rand = 0; rand < 5; ++rand)
+		{
+			const Eigen::VectorXd x = Eigen::VectorXd::Random(bs.bases.size() * dim) * 1e-2;
+
+			// energy of the stress kernel and of the energy density
+			{
+				set_local(x);
+				double e = 0;
+				Eigen::VectorXd grad;
+				Eigen::MatrixXd hess;
+				assembler.assemble_all(NonLinearAssemblerData(vals, 0, displacement, displacement, da), true, true, false, e, grad, hess);
+				REQUIRE(e == Catch::Approx(energy(x)).margin(1e-10));
+			}
+
+			// gradient
+			{
+				Eigen::VectorXd fgrad;
+				fd::finite_gradient(x, energy, fgrad);
+				CHECK(fd::compare_gradient(gradient(x), fgrad));
+			}
+
+			// hessian
+			{
+				set_local(x);
+				const Eigen::MatrixXd hess = assembler.assemble_hessian(NonLinearAssemblerData(vals, 0, displacement, displacement, da));
+
+				Eigen::MatrixXd fhess;
+				fd::finite_jacobian(x, gradient, fhess);
+				CHECK(fd::compare_hessian(hess, fhess));
+			}
+		}
+	};
+
+	if (material == "MooneyRivlin")
+		check(mooney_rivlin);
+	else
+		check(saint_venant);
+
+	// pointwise closed form of MooneyRivlin against the autodiff of the energy density
+	if (material == "MooneyRivlin")
+	{
+		const auto compare = [&](auto def_grad) {
+			constexpr int d = decltype(def_grad)::RowsAtCompileTime;
+			typedef Eigen::Matrix<double, d, d> DimMat;
+			typedef Eigen::Matrix<double, d * d, d * d> GradMat;
+
+			const RowVectorNd p = RowVectorNd::Zero(d);
+			double e, ea;
+			DimMat stress, stressa;
+			GradMat stress_grad, stress_grada;
+			mooney_rivlin.elastic_stress<d>(p, 0, def_grad, e, stress, &stress_grad);
+			mooney_rivlin.GenericElastic<MooneyRivlinElasticity>::elastic_stress<d>(p, 0, def_grad, ea, stressa, &stress_grada);
+
+			REQUIRE(e == Catch::Approx(ea).margin(1e-10));
+			REQUIRE((stress - stressa).norm() <= 1e-10 * (1 + stressa.norm()));
+			REQUIRE((stress_grad - stress_grada).norm() <= 1e-10 * (1 + stress_grada.norm()));
+		};
+
+		for (int rand = 0; rand < 5; ++rand)
+		{
+			if (dim == 2)
+				compare(Eigen::Matrix2d(Eigen::Matrix2d::Identity() + 0.1 * Eigen::Matrix2d::Random()));
+			else
+				compare(Eigen::Matrix3d(Eigen::Matrix3d::Identity() + 0.1 * Eigen::Matrix3d::Random()));
+		}
+	}
+}
+
+TEST_CASE("assemble_all", "[assembler]")
+{
+	const std::string path = POLYFEM_DATA_DIR;
+	json in_args = json({});
+	in_args["geometry"] = {};
+	in_args["geometry"]["mesh"] = path + "/plane_hole.obj";
+	in_args["geometry"]["surface_selection"] = 7;
+
+	in_args["preset_problem"] = {};
+	in_args["preset_problem"]["type"] = "ElasticExact";
+
+	in_args["materials"] = {};
+	in_args["materials"]["type"] = "LinearElasticity";
+	in_args["materials"]["E"] = 1e5;
+	in_args["materials"]["nu"] = 0.3;
+
+	State state;
+	state.init_logger("", spdlog::level::err, spdlog::level::off, false);
+	state.init(in_args, true);
+	state.load_mesh();
+	state.build_basis();
+
+	NeoHookeanAutodiff autodiff;
+	NeoHookeanElasticity real;
+
+	autodiff.set_size(2);
+	real.set_size(2);
+
+	autodiff.add_multimaterial(0, in_args["materials"], state.units);
+	real.add_multimaterial(0, in_args["materials"], state.units);
+
+	Eigen::MatrixXd displacement(state.n_bases * 2, 1);
+	displacement.setRandom();
+	displacement *= 1e-2;
+
+	for (const NLAssembler *assembler : std::vector<const NLAssembler *>{&autodiff, &real})
+	{
+		const double energy = assembler->assemble_energy(false, state.bases, state.bases, state.ass_vals_cache, 0, displacement, displacement);
+
+		Eigen::MatrixXd grad;
+		assembler->assemble_gradient(false, state.n_bases, state.bases, state.bases, state.ass_vals_cache, 0, displacement, displacement, grad);
+
+		SparseMatrixCache mat_cache;
+		StiffnessMatrix hessian;
+		assembler->assemble_hessian(false, state.n_bases, false, state.bases, state.bases, state.ass_vals_cache, 0, displacement, displacement, mat_cache, hessian);
+
+		double energy_all = 0;
+		Eigen::MatrixXd grad_all;
+		StiffnessMatrix hessian_all;
+		SparseMatrixCache mat_cache_all;
+		assembler->assemble_all(false, state.n_bases, false, state.bases, state.bases, state.ass_vals_cache, 0, displacement, displacement,
+								true, true, true, mat_cache_all, energy_all, grad_all, hessian_all);
+
+		REQUIRE(energy_all == Catch::Approx(energy).margin(1e-10));
+		REQUIRE((grad_all - grad).norm() == Catch::Approx(0).margin(1e-8));
+		REQUIRE((hessian_all - hessian).norm() == Catch::Approx(0).margin(1e-8));
+
+		// only the gradient
+		Eigen::MatrixXd grad_only;
+		assembler->assemble_all(false, state.n_bases, false, state.bases, state.bases, state.ass_vals_cache, 0, displacement, displacement,
+								false, true, false, mat_cache_all, energy_all, grad_only, hessian_all);
+		REQUIRE((grad_only - grad).norm() == Catch::Approx(0).margin(1e-8));
+	}
+}
+
+TEST_CASE("assembly_vals_cache", "[assembler]")
+{
+	const std::string path = POLYFEM_DATA_DIR;
+	json in_args = json({});
+	in_args["geometry"] = {};
+	in_args["geometry"]["mesh"] = path + "/plane_hole.obj";
+	in_args["geometry"]["surface_selection"] = 7;
+
+	in_args["preset_problem"] = {};
+	in_args["preset_problem"]["type"] = "ElasticExact";
+
+	in_args["materials"] = {};
+	in_args["materials"]["type"] = "LinearElasticity";
+	in_args["materials"]["E"] = 1e5;
+	in_args["materials"]["nu"] = 0.3;
+
+	State state;
+	state.init_logger("", spdlog::level::err, spdlog::level::off, false);
+	state.init(in_args, true);
+	state.load_mesh();
+	state.build_basis();
+
+	const std::string cache_path = (std::filesystem::temp_directory_path() / "polyfem_test_assembly_vals_cache.bin").string();
+	REQUIRE(state.ass_vals_cache.save(cache_path));
+
+	for (const bool is_mass : {false, true})
+	{
+		AssemblyValsCache cache;
+		if (is_mass)
+			cache.init(false, state.bases, state.bases, true);
+		else
+			REQUIRE(cache.load(cache_path, false, state.bases, state.bases));
+		REQUIRE(cache.is_initialized());
+		REQUIRE(cache.memory_usage() > 0);
+
+		AssemblyValsCache direct;
+		direct.init(false, state.bases, state.bases, is_mass);
+		direct.clear();
+
+		ElementAssemblyValues cached_vals, direct_vals;
+		for (int e = 0; e < state.bases.size(); ++e)
+		{
+			cache.compute(e, false, state.bases[e], state.bases[e], cached_vals);
+			direct.compute(e, false, state.bases[e], state.bases[e], direct_vals);
+
+			REQUIRE(cached_vals.element_id == e);
+			REQUIRE((cached_vals.quadrature.weights - direct_vals.quadrature.weights).norm() == Catch::Approx(0).margin(1e-14));
+			REQUIRE((cached_vals.det - direct_vals.det).norm() == Catch::Approx(0).margin(1e-14));
+			REQUIRE((cached_vals.val - direct_vals.val).norm() == Catch::Approx(0).margin(1e-14));
+			REQUIRE(cached_vals.basis_values.size() == direct_vals.basis_values.size());
+			for (int j = 0; j < cached_vals.basis_values.size(); ++j)
+			{
+				REQUIRE(cached_vals.basis_values[j].global.size() == direct_vals.basis_values[j].global.size());
+				REQUIRE((cached_vals.basis_values[j].val - direct_vals.basis_values[j].val).norm() == Catch::Approx(0).margin(1e-14));
+				REQUIRE((cached_vals.basis_values[j].grad_t_m - direct_vals.basis_values[j].grad_t_m).norm() == Catch::Approx(0).margin(1e-14));
+			}
+		}
+	}
+
+	// a cache saved for the stiffness quadrature is rejected for the mass one
+	AssemblyValsCache mass_cache;
+	REQUIRE(!mass_cache.load(cache_path, false, state.bases, state.bases, true));
+	REQUIRE(!mass_cache.is_initialized());
+
+	std::filesystem::remove(cache_path);
+}
+
+TEST_CASE("element_kernels", "[assembler]")
+{
+	const std::string path = POLYFEM_DATA_DIR;
+
+	for (const int discr_order : {1, 2})
+	{
+		json in_args = json({});
+		in_args["geometry"] = {};
+		in_args["geometry"]["mesh"] = path + "/plane_hole.obj";
+		in_args["geometry"]["surface_selection"] = 7;
+
+		in_args["space"] = {};
+		in_args["space"]["discr_order"] = discr_order;
+
+		in_args["preset_problem"] = {};
+		in_args["preset_problem"]["type"] = "ElasticExact";
+
+		in_args["materials"] = {};
+		in_args["materials"]["type"] = "LinearElasticity";
+		in_args["materials"]["E"] = 1e5;
+		in_args["materials"]["nu"] = 0.3;
+
+		State state;
+		state.init_logger("", spdlog::level::err, spdlog::level::off, false);
+		state.init(in_args, true);
+		state.load_mesh();
+		state.build_basis();
+
+		const auto elasticity = std::dynamic_pointer_cast<LinearAssembler>(state.assembler);
+		REQUIRE(elasticity != nullptr);
+
+		Laplacian laplacian;
+		laplacian.set_size(1);
+
+		const std::vector<const LinearAssembler *> assemblers = {&laplacian, elasticity.get()};
+
+		ElementAssemblyValues vals;
+		QuadratureVector da;
+		Eigen::MatrixXd local;
+		for (int e = 0; e < state.bases.size(); ++e)
+		{
+			state.ass_vals_cache.compute(e, false, state.bases[e], state.bases[e], vals);
+			da = vals.det.array() * vals.quadrature.weights.array();
+			const int n_loc_bases = vals.basis_values.size();
+
+			for (const LinearAssembler *assembler : assemblers)
+			{
+				const int size = assembler->size();
+				REQUIRE(assembler->assemble_element(vals, da, local));
+				REQUIRE(local.rows() == n_loc_bases * size);
+				REQUIRE(local.cols() == n_loc_bases * size);
+
+				for (int i = 0; i < n_loc_bases; ++i)
+				{
+					for (int j = 0; j <= i; ++j)
+					{
+						const auto expected = assembler->assemble(LinearAssemblerData(vals, i, j, da));
+						for (int n = 0; n < size; ++n)
+							for (int m = 0; m < size; ++m)
+								REQUIRE(local(i * size + m, j * size + n) == Catch::Approx(expected(n * size + m)).margin(1e-8));
+					}
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("node_ordering", "[assembler]")
+{
+	const std::string path = POLYFEM_DATA_DIR;
+	json in_args = json({});
+	in_args["geometry"] = {};
+	in_args["geometry"]["mesh"] = path + "/plane_hole.obj";
+	in_args["geometry"]["surface_selection"] = 7;
+
+	in_args["preset_problem"] = {};
+	in_args["preset_problem"]["type"] = "ElasticExact";
+
+	in_args["materials"] = {};
+	in_args["materials"]["type"] = "LinearElasticity";
+	in_args["materials"]["E"] = 1e5;
+	in_args["materials"]["nu"] = 0.3;
+
+	// p4 has no input to node mapping, the tags of the input nodes are dropped
+	const int discr_order = GENERATE(2, 4);
+	in_args["space"] = {};
+	in_args["space"]["discr_order"] = discr_order;
+
+	const auto build = [&](const std::string &ordering, StiffnessMatrix &stiffness) {
+		json args = in_args;
+		args["space"]["advanced"]["node_ordering"] = ordering;
+
+		auto state = std::make_shared<State>();
+		state->init_logger("", spdlog::level::err, spdlog::level::off, false);
+		state->init(args, true);
+		state->load_mesh();
+		state->build_basis();
+		state->build_stiffness_mat(stiffness);
+		return state;
+	};
+
+	StiffnessMatrix ref_stiffness;
+	const auto ref = build("none", ref_stiffness);
+	REQUIRE(ref->node_permutation.size() == 0);
+	REQUIRE((ref->in_node_to_node.size() > 0) == (discr_order < 4));
+
+	for (const std::string ordering : {"rcm", "morton"})
+	{
+		StiffnessMatrix stiffness;
+		const auto state = build(ordering, stiffness);
+		const Eigen::VectorXi &perm = state->node_permutation;
+
+		REQUIRE(perm.size() == ref->n_bases);
+		Eigen::VectorXi sorted = perm;
+		std::sort(sorted.data(), sorted.data() + sorted.size());
+		REQUIRE(sorted == Eigen::VectorXi::LinSpaced(perm.size(), 0, perm.size() - 1));
+
+		if (ordering == "rcm")
+			CHECK(basis::nodes_bandwidth(state->bases) <= basis::nodes_bandwidth(ref->bases));
+
+		const auto dof = [&](const int i) { return perm[i / 2] * 2 + i % 2; };
+
+		// same operator, up to the renumbering
+		REQUIRE(stiffness.nonZeros() == ref_stiffness.nonZeros());
+		for (int k = 0; k < ref_stiffness.outerSize(); ++k)
+			for (StiffnessMatrix::InnerIterator it(ref_stiffness, k); it; ++it)
+				REQUIRE(stiffness.coeff(dof(it.row()), dof(it.col())) == Catch::Approx(it.value()).margin(1e-8));
+
+		std::vector<int> boundary_nodes;
+		for (const int i : ref->boundary_nodes)
+			boundary_nodes.push_back(dof(i));
+		std::sort(boundary_nodes.begin(), boundary_nodes.end());
+		REQUIRE(boundary_nodes == state->boundary_nodes);
+
+		for (int i = 0; i < ref->n_bases; ++i)
+			REQUIRE((state->node_position(perm[i]) - ref->node_position(i)).norm() == Catch::Approx(0).margin(1e-14));
+
+		// the input order is recovered through the input to node map
+		REQUIRE(state->in_node_to_node.size() == ref->in_node_to_node.size());
+		for (int i = 0; i < ref->in_node_to_node.size(); ++i)
+			REQUIRE(state->in_node_to_node[i] == perm[ref->in_node_to_node[i]]);
+	}
+}
+
+TEST_CASE("lsq_bc_cache", "[assembler]")
+{
+	const std::string path = POLYFEM_DATA_DIR;
+	json in_args = json({});
+	in_args["geometry"] = {};
+	in_args["geometry"]["mesh"] = path + "/plane_hole.obj";
+	in_args["geometry"]["surface_selection"] = 7;
+
+	in_args["preset_problem"] = {};
+	in_args["preset_problem"]["type"] = "ElasticExact";
+
+	in_args["materials"] = {};
+	in_args["materials"]["type"] = "LinearElasticity";
+	in_args["materials"]["E"] = 1e5;
+	in_args["materials"]["nu"] = 0.3;
+
+	in_args["space"] = {};
+	in_args["space"]["discr_order"] = 2;
+	in_args["space"]["advanced"]["bc_method"] = "lsq";
+
+	State state;
+	state.init_logger("", spdlog::level::err, spdlog::level::off, false);
+	state.init(in_args, true);
+	state.load_mesh();
+	state.build_basis();
+	state.assemble_rhs();
+
+	const RhsAssembler &rhs_assembler = *state.solve_data.rhs_assembler;
+	REQUIRE(state.boundary_nodes.size() > 0);
+
+	const auto set_bc = [&](const std::vector<mesh::LocalBoundary> &local_boundary, const int resolution) {
+		Eigen::MatrixXd rhs = state.rhs;
+		rhs_assembler.set_bc(local_boundary, state.boundary_nodes, resolution, state.local_neumann_boundary, rhs);
+		return rhs;
+	};
+
+	rhs_assembler.clear_cache();
+	const int n_builds = rhs_assembler.n_lsq_bc_cache_builds();
+	const Eigen::MatrixXd ref = set_bc(state.local_boundary, state.n_boundary_samples());
+	CHECK(rhs_assembler.n_lsq_bc_cache_builds() == n_builds + 1);
+
+	// same boundary, also from a copy at another address
+	CHECK(set_bc(state.local_boundary, state.n_boundary_samples()) == ref);
+	const std::vector<mesh::LocalBoundary> copy = state.local_boundary;
+	CHECK(set_bc(copy, state.n_boundary_samples()) == ref);
+	CHECK(rhs_assembler.n_lsq_bc_cache_builds() == n_builds + 1);
+
+	// the same elements in another order are a different boundary
+	const std::vector<mesh::LocalBoundary> reversed(state.local_boundary.rbegin(), state.local_boundary.rend());
+	const Eigen::MatrixXd rhs_reversed = set_bc(reversed, state.n_boundary_samples());
+	CHECK(rhs_assembler.n_lsq_bc_cache_builds() == n_builds + 2);
+	CHECK((rhs_reversed - ref).norm() <= 1e-8 * std::max(1.0, ref.norm()));
+
+	// so is another resolution
+	set_bc(state.local_boundary, state.n_boundary_samples() + 1);
+	CHECK(rhs_assembler.n_lsq_bc_cache_builds() == n_builds + 3);
+}
@@ -7,6 +7,7 @@
 #include <polyfem/quadrature/HexQuadrature.hpp>
 
 #include <polyfem/basis/LagrangeBasis3d.hpp>
+#include <polyfem/basis/ReferenceTabulation.hpp>
 #include <polyfem/autogen/auto_p_bases.hpp>
 #include <polyfem/autogen/auto_q_bases.hpp>
 
@@ -1178,3 +1179,58 @@ TEST_CASE("WS_2d", "[bases]")
 		}
 	}
 }
+
+TEST_CASE("reference_tabulation", "[bases]")
+{
+	TetQuadrature rule;
+	Quadrature quad;
+	rule.get_quadrature(4, quad);
+
+	const int order = 2;
+	ElementBases b0, b1;
+	for (ElementBases *b : {&b0, &b1})
+	{
+		b->bases.resize(10);
+		for (int j = 0; j < 10; ++j)
+		{
+			b->bases[j].set_basis([j](const Eigen::MatrixXd &uv, Eigen::MatrixXd &val) { polyfem::autogen::p_basis_value_3d(order, j, uv, val); });
+			b->bases[j].set_grad([j](const Eigen::MatrixXd &uv, Eigen::MatrixXd &val) { polyfem::autogen::p_grad_basis_value_3d(order, j, uv, val); });
+		}
+	}
+
+	const auto tabulation = std::make_shared<ReferenceTabulation>();
+	b0.set_tabulation(tabulation);
+	b1.set_tabulation(tabulation);
+	tabulation->add_points(b0, quad.points);
+	tabulation->add_points(b1, quad.points);
+	REQUIRE(tabulation->size() == 1);
+
+	std::vector<AssemblyValues> vals0, vals1;
+	REQUIRE(tabulation->evaluate(b0, quad.points, /*grads=*/false, vals0));
+	b0.evaluate_bases(quad.points, vals0);
+	b0.evaluate_grads(quad.points, vals0);
+	b1.evaluate_bases(quad.points, vals1);
+	b1.evaluate_grads(quad.points, vals1);
+
+	Eigen::MatrixXd expected;
+	for (int j = 0; j < 10; ++j)
+	{
+		polyfem::autogen::p_basis_value_3d(order, j, quad.points, expected);
+		REQUIRE((vals0[j].val - expected).norm() == Catch::Approx(0).margin(1e-14));
+		REQUIRE((vals1[j].val - expected).norm() == Catch::Approx(0).margin(1e-14));
+
+		polyfem::autogen::p_grad_basis_value_3d(order, j, quad.points, expected);
+		REQUIRE((vals0[j].grad - expected).norm() == Catch::Approx(0).margin(1e-14));
+		REQUIRE((vals1[j].grad - expected).norm() == Catch::Approx(0).margin(1e-14));
+	}
+
+	// other points are not tabulated, they are evaluated directly
+	REQUIRE(!tabulation->evaluate(b1, quad.points.topRows(1), /*grads=*/false, vals1));
+	b1.evaluate_bases(quad.points.topRows(1), vals1);
+	REQUIRE(tabulation->size() == 1);
+	for (int j = 0; j < 10; ++j)
+	{
+		polyfem::autogen::p_basis_value_3d(order, j, quad.points.topRows(1), expected);
+		REQUIRE((vals1[j].val - expected).norm() == Catch::Approx(0).margin(1e-14));
+	}
+}
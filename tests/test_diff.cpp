@@ -977,6 +977,31 @@ TEST_CASE("shape-transient-friction", "[test_adjoint]")
 	verify_adjoint(variable_to_simulations, *obj, state, x, velocity_discrete, 1e-6, 1e-5);
 }
 
+TEST_CASE("transient-adjoint-checkpointing", "[test_adjoint]")
+{
+	const std::string path = POLYFEM_DATA_DIR + std::string("/differentiable/input/");
+	json in_args;
+	load_json(path + "shape-transient-friction.json", in_args);
+	auto state_ptr = create_state_and_solve(in_args);
+	State &state = *state_ptr;
+
+	Eigen::MatrixXd adjoint_rhs;
+	adjoint_rhs.setRandom(state.ndof(), state.diff_cached.size());
+
+	const Eigen::MatrixXd adjoint = state.solve_adjoint(adjoint_rhs);
+	const ipc::CollisionConstraints contact_set = state.diff_cached.contact_set(1);
+
+	for (const auto mode : {DiffCache::StorageMode::RECOMPUTE, DiffCache::StorageMode::DISK})
+	{
+		state.diff_cached.set_storage(mode, 1);
+		AdjointOptUtils::solve_pde(state);
+
+		const Eigen::MatrixXd adjoint_checkpointed = state.solve_adjoint(adjoint_rhs);
+		REQUIRE((adjoint_checkpointed - adjoint).norm() <= 1e-8 * adjoint.norm());
+		REQUIRE(state.diff_cached.contact_set(1).size() == contact_set.size());
+	}
+}
+
 // TEST_CASE("shape-transient-friction-sdf", "[test_adjoint]")
 // {
 // 	const std::string path = POLYFEM_DATA_DIR + std::string("/differentiable/input/");
@@ -15,6 +15,9 @@
 #include <polyfem/solver/forms/LaggedRegForm.hpp>
 #include <polyfem/solver/forms/RayleighDampingForm.hpp>
 
+#include <polyfem/solver/FullNLProblem.hpp>
+#include <polyfem/solver/SparseNewtonDescentSolver.hpp>
+
 #include <polyfem/time_integrator/ImplicitEuler.hpp>
 
 #include <finitediff.hpp>
@@ -264,6 +267,35 @@ TEST_CASE("contact form derivatives", "[form][form_derivatives][contact_form]")
 	test_form(form, *state_ptr);
 }
 
+TEST_CASE("contact form persistent candidates", "[form][contact_form]")
+{
+	const auto state_ptr = get_state(2);
+	const int ndof = state_ptr->n_bases * state_ptr->mesh->dimension();
+
+	const double dhat = 1e-3;
+	ContactForm form(
+		state_ptr->collision_mesh, dhat, state_ptr->avg_mass,
+		/*use_convergent_formulation=*/false, /*use_adaptive_barrier_stiffness=*/false,
+		/*is_time_dependent=*/true, false, ipc::BroadPhaseMethod::HASH_GRID,
+		/*ccd_tolerance=*/1e-6, /*ccd_max_iterations=*/static_cast<int>(1e6));
+
+	// first time step
+	const Eigen::VectorXd x0 = Eigen::VectorXd::Random(ndof) * (dhat / 10);
+	form.init(x0);
+	CHECK(form.n_candidates_builds() == 1);
+
+	// second time step, every vertex moves by less than the skin
+	const Eigen::VectorXd x1 = x0 + Eigen::VectorXd::Random(ndof) * (dhat / 10);
+	form.update_quantities(/*t=*/1e-3, x1);
+	form.init(x1);
+	CHECK(form.n_candidates_builds() == 1);
+
+	// moving further than the skin rebuilds them
+	const Eigen::VectorXd x2 = x1 + Eigen::VectorXd::Constant(ndof, 10 * dhat);
+	form.init(x2);
+	CHECK(form.n_candidates_builds() == 2);
+}
+
 TEST_CASE("elastic form derivatives", "[form][form_derivatives][elastic_form]")
 {
 	const int dim = GENERATE(2, 3);
@@ -279,6 +311,193 @@ TEST_CASE("elastic form derivatives", "[form][form_derivatives][elastic_form]")
 	test_form(form, *state_ptr);
 }
 
+TEST_CASE("elastic form assembly passes", "[form][elastic_form]")
+{
+	const auto state_ptr = get_state(2);
+	const int ndof = state_ptr->n_bases * state_ptr->mesh->dimension();
+
+	auto elastic_form = std::make_shared<ElasticForm>(
+		state_ptr->n_bases,
+		state_ptr->bases,
+		state_ptr->geom_bases(),
+		*state_ptr->assembler,
+		state_ptr->ass_vals_cache,
+		state_ptr->args["time"]["dt"],
+		state_ptr->mesh->is_volume());
+	// pins the solution to zero
+	auto reg_form = std::make_shared<LaggedRegForm>(/*n_lagging_iters=*/-1);
+	reg_form->set_weight(1e3);
+
+	FullNLProblem problem({elastic_form, reg_form});
+	problem.init(Eigen::VectorXd::Zero(ndof));
+	problem.init_lagging(Eigen::VectorXd::Zero(ndof));
+
+	cppoptlib::SparseNewtonDescentSolver<FullNLProblem> solver(
+		state_ptr->args["solver"]["nonlinear"], state_ptr->args["solver"]["linear"], 1, 1);
+
+	Eigen::VectorXd x = Eigen::VectorXd::Random(ndof) / 20;
+	solver.minimize(problem, x);
+
+	const int n_iterations = solver.get_info()["iterations"];
+	REQUIRE(n_iterations > 0);
+	CHECK(x.norm() < 1e-6);
+
+	// the energy and the gradient of the accepted trial point, then its hessian
+	// plus the first gradient and hessian at the initial point in one pass
+	CHECK(elastic_form->n_assembly_passes() <= 3 * n_iterations + 2);
+}
+
+namespace
+{
+	// springs between pairs of DOFs, the pairs change like the contacts of a contact form
+	class SpringsForm : public Form
+	{
+	public:
+		std::string name() const override { return "springs"; }
+
+		std::vector<std::pair<int, int>> pairs;
+
+	protected:
+		double value_unweighted(const Eigen::VectorXd &x) const override
+		{
+			double val = 0;
+			for (const auto &[i, j] : pairs)
+				val += 0.5 * (x(i) - x(j)) * (x(i) - x(j));
+			return val;
+		}
+
+		void first_derivative_unweighted(const Eigen::VectorXd &x, Eigen::VectorXd &gradv) const override
+		{
+			gradv.setZero(x.size());
+			for (const auto &[i, j] : pairs)
+			{
+				gradv(i) += x(i) - x(j);
+				gradv(j) -= x(i) - x(j);
+			}
+		}
+
+		void second_derivative_unweighted(const Eigen::VectorXd &x, StiffnessMatrix &hessian) const override
+		{
+			std::vector<Eigen::Triplet<double>> entries;
+			for (const auto &[i, j] : pairs)
+			{
+				entries.emplace_back(i, i, 1);
+				entries.emplace_back(j, j, 1);
+				entries.emplace_back(i, j, -1);
+				entries.emplace_back(j, i, -1);
+			}
+			hessian.resize(x.size(), x.size());
+			hessian.setFromTriplets(entries.begin(), entries.end());
+		}
+	};
+} // namespace
+
+TEST_CASE("full problem hessian", "[form][solver]")
+{
+	const auto state_ptr = get_state(2);
+	const int ndof = state_ptr->n_bases * state_ptr->mesh->dimension();
+
+	auto elastic_form = std::make_shared<ElasticForm>(
+		state_ptr->n_bases,
+		state_ptr->bases,
+		state_ptr->geom_bases(),
+		*state_ptr->assembler,
+		state_ptr->ass_vals_cache,
+		state_ptr->args["time"]["dt"],
+		state_ptr->mesh->is_volume());
+	auto springs_form = std::make_shared<SpringsForm>();
+	springs_form->set_weight(10);
+
+	FullNLProblem problem({elastic_form, springs_form});
+	const Eigen::VectorXd x = Eigen::VectorXd::Random(ndof) / 100;
+	problem.init(x);
+
+	const auto check = [&]() {
+		StiffnessMatrix hessian, tmp;
+		problem.hessian(x, hessian);
+
+		elastic_form->second_derivative(x, tmp);
+		StiffnessMatrix expected = tmp;
+		if (springs_form->enabled())
+		{
+			springs_form->second_derivative(x, tmp);
+			expected += tmp;
+		}
+
+		REQUIRE(hessian.rows() == ndof);
+		REQUIRE(hessian.cols() == ndof);
+		CHECK((Eigen::MatrixXd(hessian) - Eigen::MatrixXd(expected)).norm() <= 1e-12 * expected.norm());
+	};
+
+	// builds the union pattern
+	springs_form->pairs = {{0, ndof - 1}, {1, ndof / 2}, {2, ndof - 3}};
+	check();
+	// same pattern
+	check();
+	// a subset of the union
+	springs_form->pairs = {{1, ndof / 2}};
+	check();
+	// entries out of the union
+	springs_form->pairs = {{0, ndof - 2}, {3, ndof / 2 + 1}, {1, ndof / 2}};
+	check();
+	check();
+	// no entries
+	springs_form->disable();
+	check();
+}
+
+TEST_CASE("newton symbolic factorization reuse", "[form][solver]")
+{
+	const auto state_ptr = get_state(2);
+	const int ndof = state_ptr->n_bases * state_ptr->mesh->dimension();
+
+	auto elastic_form = std::make_shared<ElasticForm>(
+		state_ptr->n_bases,
+		state_ptr->bases,
+		state_ptr->geom_bases(),
+		*state_ptr->assembler,
+		state_ptr->ass_vals_cache,
+		state_ptr->args["time"]["dt"],
+		state_ptr->mesh->is_volume());
+	// pins the solution to zero
+	auto reg_form = std::make_shared<LaggedRegForm>(/*n_lagging_iters=*/-1);
+	reg_form->set_weight(1e3);
+	auto springs_form = std::make_shared<SpringsForm>();
+	springs_form->pairs = {{0, ndof - 1}, {1, ndof / 2}};
+
+	FullNLProblem problem({elastic_form, reg_form});
+	FullNLProblem springs_problem({elastic_form, reg_form, springs_form});
+	for (FullNLProblem *p : {&problem, &springs_problem})
+	{
+		p->init(Eigen::VectorXd::Zero(ndof));
+		p->init_lagging(Eigen::VectorXd::Zero(ndof));
+	}
+
+	cppoptlib::SparseNewtonDescentSolver<FullNLProblem> solver(
+		state_ptr->args["solver"]["nonlinear"], state_ptr->args["solver"]["linear"], 1, 1);
+
+	const auto minimize = [&](FullNLProblem &p) {
+		Eigen::VectorXd x = Eigen::VectorXd::Random(ndof) / 20;
+		solver.minimize(p, x);
+		return solver.get_info()["symbolic_factorization"];
+	};
+
+	// the pattern is analyzed once and reused by the following iterations
+	json info = minimize(problem);
+	CHECK(info["analyzed"] == 1);
+	CHECK(info["reused"] >= 1);
+
+	// and across solves
+	info = minimize(problem);
+	CHECK(info["analyzed"] == 0);
+	CHECK(info["reused"] >= 1);
+
+	// a different pattern of the same size is analyzed again
+	info = minimize(springs_problem);
+	CHECK(info["analyzed"] == 1);
+	CHECK(info["total_analyzed"] == 2);
+}
+
 TEST_CASE("friction form derivatives", "[form][form_derivatives][friction_form]")
 {
 	const int dim = GENERATE(2, 3);
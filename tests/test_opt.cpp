@@ -284,6 +284,54 @@ TEST_CASE("topology-opt", "[optimization]")
 	// REQUIRE(energies[energies.size() - 1] == Catch::Approx(0.726565).epsilon(1e-4));
 }
 
+TEST_CASE("density-filters", "[optimization]")
+{
+	const std::string path = POLYFEM_DATA_DIR;
+	json in_args = json({});
+	in_args["geometry"] = {};
+	in_args["geometry"]["mesh"] = path + "/plane_hole.obj";
+
+	State state;
+	state.init_logger("", spdlog::level::err, spdlog::level::off, false);
+	state.init(in_args, true);
+	state.load_mesh();
+
+	Eigen::MatrixXd barycenters;
+	state.mesh->face_barycenters(barycenters);
+	const int n = barycenters.rows();
+
+	const double radius = 0.1;
+	const Eigen::VectorXd x = Eigen::VectorXd::Random(n);
+
+	// the grid search finds the same neighbours as the brute force one
+	Eigen::VectorXd expected(n);
+	for (int i = 0; i < n; ++i)
+	{
+		double sum = 0, weight = 0;
+		for (int j = 0; j < n; ++j)
+		{
+			const double dist = (barycenters.row(i) - barycenters.row(j)).norm();
+			if (dist < radius)
+			{
+				sum += (radius - dist) * x(j);
+				weight += radius - dist;
+			}
+		}
+		expected(i) = sum / weight;
+	}
+
+	LinearFilter linear_filter(*state.mesh, radius);
+	REQUIRE((linear_filter.eval(x) - expected).norm() == Catch::Approx(0).margin(1e-12));
+
+	// the Helmholtz filter preserves constants and is self-adjoint
+	HelmholtzFilter helmholtz_filter(*state.mesh, radius);
+	const Eigen::VectorXd ones = Eigen::VectorXd::Ones(n);
+	REQUIRE((helmholtz_filter.eval(ones) - ones).norm() == Catch::Approx(0).margin(1e-8));
+
+	const Eigen::VectorXd y = Eigen::VectorXd::Random(n);
+	REQUIRE(y.dot(helmholtz_filter.eval(x)) == Catch::Approx(x.dot(helmholtz_filter.apply_jacobian(y, x))).margin(1e-8));
+}
+
 TEST_CASE("AMIPS-debug", "[optimization]")
 {
 	const std::string root_folder = POLYFEM_DATA_DIR + std::string("/differentiable/optimizations/") + "AMIPS-debug" + "/";
@@ -1,8 +1,10 @@
 ////////////////////////////////////////////////////////////////////////////////
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
 #include <catch2/generators/catch_generators.hpp>
 
 #include <polyfem/State.hpp>
+#include <polyfem/io/Evaluator.hpp>
 #include <polyfem/Common.hpp>
 #include <polyfem/utils/JSONUtils.hpp>
 
@@ -82,3 +84,62 @@ TEST_CASE("full sim", "[.][full_sim]")
 
 	std::filesystem::remove_all(outdir);
 }
+
+TEST_CASE("boundary interpolation", "[output]")
+{
+	json args = R"(
+	{
+		"geometry": {
+			"surface_selection": 1
+		},
+		"materials": {
+			"type": "LinearElasticity",
+			"E": 1e5,
+			"nu": 0.3
+		}
+	}
+	)"_json;
+	args["geometry"]["mesh"] = std::string(POLYFEM_DATA_DIR) + "/contact/meshes/3D/simple/cube.msh";
+
+	State state;
+	state.init_logger("", spdlog::level::err, spdlog::level::off, false);
+	state.init(args, true);
+	state.load_mesh();
+	state.build_basis();
+
+	const mesh::Mesh &mesh = *state.mesh;
+	const bool is_scalar = state.problem->is_scalar();
+
+	Eigen::MatrixXd pts, sidesets;
+	Eigen::MatrixXi faces;
+	io::Evaluator::get_sidesets(mesh, pts, faces, sidesets);
+	REQUIRE(faces.rows() > 0);
+
+	const Eigen::MatrixXd fun = Eigen::MatrixXd::Random(state.n_bases * 3, 1);
+
+	// values on faces no element touches are NaN in both results
+	const auto same = [](const Eigen::MatrixXd &a, const Eigen::MatrixXd &b) {
+		return a.rows() == b.rows() && a.cols() == b.cols()
+			   && (a.array() == b.array() || (a.array().isNaN() && b.array().isNaN())).all();
+	};
+
+	// every face and vertex is written by the same element as in a serial loop
+	Eigen::MatrixXd ref, ref_vertices, ref_traction, ref_stresses, ref_mises;
+	state.set_max_threads(1);
+	io::Evaluator::interpolate_boundary_function(mesh, is_scalar, state.bases, state.geom_bases(), pts, faces, fun, false, ref);
+	io::Evaluator::interpolate_boundary_function_at_vertices(mesh, is_scalar, state.bases, state.geom_bases(), pts, faces, fun, ref_vertices);
+	io::Evaluator::interpolate_boundary_tensor_function(mesh, is_scalar, state.bases, state.geom_bases(), *state.assembler, pts, faces, fun, false, ref_traction, ref_stresses, ref_mises);
+	REQUIRE(ref.array().isFinite().any());
+
+	Eigen::MatrixXd result, vertices, traction, stresses, mises;
+	state.set_max_threads();
+	io::Evaluator::interpolate_boundary_function(mesh, is_scalar, state.bases, state.geom_bases(), pts, faces, fun, false, result);
+	io::Evaluator::interpolate_boundary_function_at_vertices(mesh, is_scalar, state.bases, state.geom_bases(), pts, faces, fun, vertices);
+	io::Evaluator::interpolate_boundary_tensor_function(mesh, is_scalar, state.bases, state.geom_bases(), *state.assembler, pts, faces, fun, false, traction, stresses, mises);
+
+	CHECK(same(result, ref));
+	CHECK(same(vertices, ref_vertices));
+	CHECK(same(traction, ref_traction));
+	CHECK(same(stresses, ref_stresses));
+	CHECK(same(mises, ref_mises));
+}
@@ -1,6 +1,9 @@
 ////////////////////////////////////////////////////////////////////////////////
 #include <polyfem/io/MatrixIO.hpp>
 #include <polyfem/utils/RBFInterpolation.hpp>
+#include <polyfem/basis/function/RBFWithQuadratic.hpp>
+#include <polyfem/assembler/Laplacian.hpp>
+#include <polyfem/quadrature/HexQuadrature.hpp>
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
@@ -11,6 +14,8 @@
 using namespace polyfem;
 using namespace polyfem::io;
 using namespace polyfem::utils;
+using namespace polyfem::basis;
+using namespace polyfem::quadrature;
 
 TEST_CASE("interpolation", "[rbf_test]")
 {
@@ -31,3 +36,56 @@ TEST_CASE("interpolation", "[rbf_test]")
 		}
 	}
 }
+
+TEST_CASE("harmonic_fit_translation", "[rbf_test]")
+{
+	// unit cube, with kernels around it and collocation points on its faces
+	Quadrature quadr;
+	HexQuadrature().get_quadrature(4, quadr);
+
+	const int n_samples = 150;
+	Eigen::MatrixXd samples = (Eigen::MatrixXd::Random(n_samples, 3).array() + 1) / 2;
+	for (int i = 0; i < n_samples; ++i)
+		samples(i, i % 3) = (i / 3) % 2;
+
+	Eigen::MatrixXd centers = Eigen::MatrixXd::Random(40, 3).rowwise().normalized() * 1.5;
+	centers.array() += 0.5;
+
+	const int n_bases = 4;
+	const Eigen::MatrixXd rhs = Eigen::MatrixXd::Random(n_samples, n_bases);
+	const Eigen::MatrixXd integrals = Eigen::MatrixXd::Random(n_bases, 9);
+
+	// the same polyhedron somewhere else, fitted directly
+	const Eigen::RowVector3d origin(3, -2, 5);
+	Quadrature moved_quadr = quadr;
+	moved_quadr.points.rowwise() += origin;
+	Eigen::MatrixXd moved_rhs = rhs;
+	const assembler::Laplacian laplacian;
+	const RBFWithQuadratic moved(laplacian, centers.rowwise() + origin, samples.rowwise() + origin, integrals, moved_quadr, moved_rhs);
+
+	// fitted relative to origin, and reused for a second set of constraints
+	Eigen::MatrixXd local_integrals = integrals;
+	RBFWithQuadratic::translate_integral_constraints_3d(origin, local_integrals);
+	std::shared_ptr<const RBFWithQuadratic::ConstrainedFit> fit;
+	const RBFWithQuadratic local(centers, samples, local_integrals, quadr, rhs, fit);
+	REQUIRE(fit);
+
+	Eigen::MatrixXd val, local_val;
+	moved.bases_values(quadr.points.rowwise() + origin, val);
+	local.bases_values(quadr.points, local_val);
+	CHECK((val - local_val).cwiseAbs().maxCoeff() < 1e-5 * val.cwiseAbs().maxCoeff());
+
+	const Eigen::MatrixXd other_integrals = Eigen::MatrixXd::Random(n_bases, 9);
+	Eigen::MatrixXd other_rhs = Eigen::MatrixXd::Random(n_samples, n_bases);
+	const RBFWithQuadratic other(laplacian, centers, samples, other_integrals, quadr, other_rhs);
+	std::shared_ptr<const RBFWithQuadratic::ConstrainedFit> shared_fit = fit;
+	const RBFWithQuadratic reused(centers, samples, other_integrals, quadr, other_rhs, shared_fit);
+	CHECK(shared_fit == fit);
+
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		other.bases_grads(axis, quadr.points, val);
+		reused.bases_grads(axis, quadr.points, local_val);
+		CHECK((val - local_val).cwiseAbs().maxCoeff() < 1e-8 * val.cwiseAbs().maxCoeff());
+	}
+}
@@ -2,8 +2,11 @@
 
 #include <polyfem/quadrature/TriQuadrature.hpp>
 #include <polyfem/basis/LagrangeBasis2d.hpp>
+#include <polyfem/solver/OperatorSplittingSolver.hpp>
+#include <polyfem/State.hpp>
 
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
 #include <iostream>
 #include <cppoptlib/meta.h>
 #include <cppoptlib/problem.h>
@@ -43,3 +46,107 @@ TEST_CASE("solver", "[solver]")
 	std::cout << "f in argmin " << f(x) << std::endl;
 	REQUIRE(f(x) < 1e-10);
 }
+
+TEST_CASE("operator splitting point location", "[solver]")
+{
+	const std::string path = POLYFEM_DATA_DIR;
+	const std::string mesh_path = GENERATE(std::string("/plane_hole.obj"), std::string("/contact/meshes/3D/simple/cube.msh"));
+
+	json in_args = json({});
+	in_args["geometry"] = {};
+	in_args["geometry"]["mesh"] = path + mesh_path;
+	in_args["materials"] = {};
+	in_args["materials"]["type"] = "LinearElasticity";
+	in_args["materials"]["E"] = 1e5;
+	in_args["materials"]["nu"] = 0.3;
+
+	State state;
+	state.init_logger("", spdlog::level::err, spdlog::level::off, false);
+	state.init(in_args, true);
+	state.load_mesh();
+	state.build_basis();
+
+	const Mesh &mesh = *state.mesh;
+	const auto &gbases = state.geom_bases();
+	const int dim = mesh.dimension();
+	const int n_el = mesh.n_elements();
+	REQUIRE(mesh.is_simplicial());
+
+	solver::OperatorSplittingSolver ss(mesh, dim + 1, n_el, state.local_boundary, state.boundary_nodes);
+
+	// barycentric coordinates in every element, the points inside no element are outside the mesh
+	const auto brute_force = [&](const RowVectorNd &p, std::vector<Eigen::MatrixXd> &local) {
+		std::vector<int> elements;
+		local.clear();
+		for (int e = 0; e < n_el; ++e)
+		{
+			const RowVectorNd p0 = gbases[e].bases[0].global()[0].node;
+			Eigen::MatrixXd A(dim, dim);
+			for (int j = 0; j < dim; ++j)
+				A.col(j) = (gbases[e].bases[j + 1].global()[0].node - p0).transpose();
+			const Eigen::MatrixXd uv = (A.inverse() * (p - p0).transpose()).transpose();
+			if (uv.minCoeff() >= -1e-10 && uv.sum() <= 1 + 1e-10)
+			{
+				elements.push_back(e);
+				local.push_back(uv);
+			}
+		}
+		return elements;
+	};
+
+	RowVectorNd min, max;
+	mesh.bounding_box(min, max);
+	const RowVectorNd margin = 0.2 * (max - min);
+
+	const int n_points = 200;
+	std::vector<Eigen::Matrix<double, 1, Eigen::Dynamic, Eigen::RowMajor, 1, 3>> points(n_points);
+	std::vector<int> cells(n_points);
+	for (int i = 0; i < n_points; ++i)
+	{
+		const RowVectorNd r = (RowVectorNd::Random(dim).array() + 1) / 2;
+		points[i] = min - margin + r.cwiseProduct(max - min + 2 * margin);
+		// half of the points start from a random hint
+		cells[i] = i % 2 == 0 ? -1 : (i * 7919) % n_el;
+	}
+	const std::vector<int> hints = cells;
+
+	std::vector<Eigen::MatrixXd> local_pts;
+	ss.locate_points(gbases, points, cells, local_pts);
+
+	int n_outside = 0;
+	for (int i = 0; i < n_points; ++i)
+	{
+		std::vector<Eigen::MatrixXd> expected_local;
+		const std::vector<int> expected = brute_force(points[i], expected_local);
+
+		Eigen::MatrixXd local;
+		const long found = ss.search_cell(gbases, points[i], local, hints[i]);
+
+		if (expected.empty())
+		{
+			++n_outside;
+			CHECK(cells[i] == -1);
+			CHECK(found == -1);
+			continue;
+		}
+
+		const auto check_local = [&](const long e, const Eigen::MatrixXd &uv) {
+			const auto it = std::find(expected.begin(), expected.end(), int(e));
+			REQUIRE(it != expected.end());
+			CHECK((uv - expected_local[it - expected.begin()]).norm() < 1e-10);
+		};
+		check_local(cells[i], local_pts[i]);
+		check_local(found, local);
+
+		for (size_t k = 0; k < expected.size(); ++k)
+		{
+			Eigen::MatrixXd uv;
+			ss.calculate_local_pts(gbases[expected[k]], expected[k], points[i], uv);
+			CHECK((uv - expected_local[k]).norm() < 1e-10);
+		}
+	}
+
+	// the points cover both cases
+	CHECK(n_outside > 0);
+	CHECK(n_outside < n_points);
+}
@@ -6,6 +6,8 @@
 #include <polyfem/io/MshReader.hpp>
 #include <polyfem/mesh/Mesh.hpp>
 #include <polyfem/utils/MatrixUtils.hpp>
+#include <polyfem/utils/MaybeParallelFor.hpp>
+#include <polyfem/utils/Tracer.hpp>
 
 #ifdef POLYFEM_WITH_REMESHING
 #include <wmtk/TriMesh.h>
@@ -13,6 +15,8 @@
 
 #include <Eigen/Dense>
 
+#include <sstream>
+
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
 ////////////////////////////////////////////////////////////////////////////////
@@ -107,6 +111,27 @@ TEST_CASE("expression", "[utils]")
 	REQUIRE(expr(2, 3, 4) == Catch::Approx(2. * 2. + sqrt(2. * 3.) + sin(4.) * 2.).margin(1e-10));
 	REQUIRE(expr2d(2, 3) == Catch::Approx(2. * 2. + sqrt(2. * 3.)).margin(1e-10));
 	REQUIRE(val(2, 3, 4) == Catch::Approx(1).margin(1e-16));
+
+	Eigen::MatrixXd pts(3, 3);
+	pts << 2, 3, 4,
+		1, 1, 0,
+		0.5, 2, 1;
+	Eigen::VectorXd res;
+	expr.evaluate(pts, 0, res);
+	REQUIRE(res.size() == pts.rows());
+	for (int i = 0; i < pts.rows(); ++i)
+		REQUIRE(res(i) == Catch::Approx(expr(pts(i, 0), pts(i, 1), pts(i, 2))).margin(1e-10));
+
+	expr2d.evaluate(pts.leftCols(2), 0, res);
+	for (int i = 0; i < pts.rows(); ++i)
+		REQUIRE(res(i) == Catch::Approx(expr2d(pts(i, 0), pts(i, 1))).margin(1e-10));
+
+	val.evaluate(pts, 0, res);
+	REQUIRE(res.isOnes());
+
+	// copies share the compiled expression
+	utils::ExpressionValue expr_copy = expr;
+	REQUIRE(expr_copy(2, 3, 4) == Catch::Approx(expr(2, 3, 4)).margin(1e-16));
 }
 
 TEST_CASE("mshreader", "[utils]")
@@ -132,6 +157,79 @@ TEST_CASE("inverse", "[utils]")
 	REQUIRE(((utils::inverse(mat3) - mat3_inv)).norm() == Catch::Approx(0).margin(1e-12));
 }
 
+TEST_CASE("maybe_parallel_for", "[utils]")
+{
+	const int size = 10007;
+
+	// every index is visited exactly once by both overloads
+	std::vector<int> visits(size, 0);
+	maybe_parallel_for(size, [&](int start, int end, int thread_id) {
+		for (int i = start; i < end; ++i)
+			++visits[i];
+	});
+	maybe_parallel_for(size, [&](int i) { ++visits[i]; });
+	for (int i = 0; i < size; ++i)
+		REQUIRE(visits[i] == 2);
+
+	// nested loops run on the calling thread
+	auto storage = create_thread_storage<long>(0);
+	maybe_parallel_for(size, [&](int start, int end, int thread_id) {
+		long &sum = get_local_thread_storage(storage, thread_id);
+		maybe_parallel_for(end - start, [&](int s, int e, int) {
+			for (int i = s; i < e; ++i)
+				sum += start + i;
+		});
+	});
+	long sum = 0;
+	for (const long s : storage)
+		sum += s;
+	REQUIRE(sum == long(size) * (size - 1) / 2);
+
+	const long reduced = maybe_parallel_reduce<long>(
+		size, 0,
+		[](int start, int end, const long &init) {
+			long s = init;
+			for (int i = start; i < end; ++i)
+				s += i;
+			return s;
+		},
+		[](const long &a, const long &b) { return a + b; });
+	REQUIRE(reduced == long(size) * (size - 1) / 2);
+}
+
+TEST_CASE("tracer", "[utils]")
+{
+	Tracer::clear();
+	{
+		POLYFEM_TRACE_SCOPE("disabled scope");
+	}
+
+	Tracer::enable();
+	{
+		POLYFEM_TRACE_SCOPE("outer scope");
+		for (int i = 0; i < 3; ++i)
+		{
+			POLYFEM_TRACE_SCOPE("inner scope");
+		}
+	}
+	Tracer::disable();
+
+	std::stringstream summary;
+	Tracer::write_summary(summary);
+	CHECK(summary.str().find("disabled scope") == std::string::npos);
+	CHECK(summary.str().find("\n  inner scope") != std::string::npos);
+
+	std::stringstream trace;
+	Tracer::write_chrome_trace(trace);
+	const json trace_json = json::parse(trace.str());
+	int n_scopes = 0;
+	for (const json &e : trace_json["traceEvents"])
+		n_scopes += e["ph"] == "X";
+	CHECK(n_scopes == 4);
+
+	Tracer::clear();
+}
+
 #ifdef POLYFEM_WITH_REMESHING
 TEST_CASE("wmtk_instatiation", "[utils]")
 {